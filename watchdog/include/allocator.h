@@ -0,0 +1,200 @@
+#ifndef __ILRD_ALLOCATOR_H__
+#define __ILRD_ALLOCATOR_H__
+
+#include <stddef.h> /* size_t */
+
+/*
+	Where a module gets its memory from. Every create function has a
+	...WithAllocator() twin; the plain one uses AllocatorGetDefault() as
+	it was when the object was created. An object keeps its allocator
+	for all of its life, so the allocator must outlive it.
+	Blocks are freed with the size and alignment they were allocated
+	with, so an allocator needs no header to know them. An alignment of
+	0 asks for the alignment of malloc().
+*/
+
+typedef struct allocator allocator_t;
+
+struct allocator
+{
+    void *(*alloc)(void *context, size_t size, size_t alignment);
+    void (*free)(void *context, void *block, size_t size, size_t alignment);
+    /* optional, NULL for alloc, copy and free */
+    void *(*realloc)(void *context, void *block, size_t old_size, size_t new_size);
+    /* optional, NULL for alloc and memset */
+    void *(*alloc_zeroed)(void *context, size_t size);
+    void *context;
+};
+
+/* counts the blocks of its parent in use, see AllocatorInitCounting() */
+typedef struct counting_allocator
+{
+    allocator_t allocator; /* give &counting->allocator to the modules */
+    const allocator_t *parent;
+    size_t bytes;
+    size_t peak_bytes;
+    size_t blocks;
+} counting_allocator_t;
+
+/*
+ * DESCRIPTION:
+ *  The allocator over malloc(), calloc(), realloc(), posix_memalign() and
+ *  free(). The default one, until AllocatorSetDefault() is called.
+ * 
+ * TIME COMPLEXITY: 
+ *  O(1)
+ * 
+ * SPACE COMPLEXITY: 
+ *  O(1)
+ * 
+ * PARAMS:
+ *  None.
+ *
+ * RETURN:
+ *  The malloc allocator.
+ */
+const allocator_t *AllocatorMalloc(void);
+
+/*
+ * DESCRIPTION:
+ *  The allocator of the objects made by the plain create functions.
+ * 
+ * TIME COMPLEXITY: 
+ *  O(1)
+ * 
+ * SPACE COMPLEXITY: 
+ *  O(1)
+ * 
+ * PARAMS:
+ *  None.
+ *
+ * RETURN:
+ *  The default allocator.
+ */
+const allocator_t *AllocatorGetDefault(void);
+
+/*
+ * DESCRIPTION:
+ *  Sets the allocator of the objects made from now on by the plain
+ *  create functions. Objects made before keep theirs. Not thread safe,
+ *  meant to be called before the objects are made.
+ * 
+ * TIME COMPLEXITY: 
+ *  O(1)
+ * 
+ * SPACE COMPLEXITY: 
+ *  O(1)
+ * 
+ * PARAMS:
+ *  allocator:  new default, NULL for AllocatorMalloc().
+ *
+ * RETURN:
+ *  None.
+ */
+void AllocatorSetDefault(const allocator_t *allocator);
+
+/*
+ * DESCRIPTION:
+ *  Allocates size bytes from allocator.
+ * 
+ * TIME COMPLEXITY: 
+ *  that of the allocator
+ * 
+ * SPACE COMPLEXITY: 
+ *  O(size)
+ * 
+ * PARAMS:
+ *  allocator:  allocator to use.
+ *  size:       number of bytes.
+ *  alignment:  power of two the block starts on, 0 for that of malloc().
+ *
+ * RETURN:
+ *  The block, NULL on failure.
+ */
+void *AllocatorAlloc(const allocator_t *allocator, size_t size, size_t alignment);
+
+/*
+ * DESCRIPTION:
+ *  Same as AllocatorAlloc() with the alignment of malloc(), the block is
+ *  zeroed.
+ * 
+ * TIME COMPLEXITY: 
+ *  O(size)
+ * 
+ * SPACE COMPLEXITY: 
+ *  O(size)
+ * 
+ * PARAMS:
+ *  allocator:  allocator to use.
+ *  size:       number of bytes.
+ *
+ * RETURN:
+ *  The block, NULL on failure.
+ */
+void *AllocatorAllocZeroed(const allocator_t *allocator, size_t size);
+
+/*
+ * DESCRIPTION:
+ *  Resizes a block of the alignment of malloc(), keeps its first bytes.
+ * 
+ * TIME COMPLEXITY: 
+ *  O(new_size)
+ * 
+ * SPACE COMPLEXITY: 
+ *  O(new_size)
+ * 
+ * PARAMS:
+ *  allocator:  allocator the block came from.
+ *  block:      block to resize.
+ *  old_size:   size it was allocated with.
+ *  new_size:   size it should have.
+ *
+ * RETURN:
+ *  The block, maybe moved. NULL on failure, then block is left as is.
+ */
+void *AllocatorRealloc(const allocator_t *allocator, void *block, size_t old_size, 
+                                                                    size_t new_size);
+
+/*
+ * DESCRIPTION:
+ *  Gives a block back to allocator. NULL is ignored.
+ * 
+ * TIME COMPLEXITY: 
+ *  that of the allocator
+ * 
+ * SPACE COMPLEXITY: 
+ *  O(1)
+ * 
+ * PARAMS:
+ *  allocator:  allocator the block came from.
+ *  block:      block to free.
+ *  size:       size it was allocated with.
+ *  alignment:  alignment it was allocated with.
+ *
+ * RETURN:
+ *  None.
+ */
+void AllocatorFree(const allocator_t *allocator, void *block, size_t size, size_t alignment);
+
+/*
+ * DESCRIPTION:
+ *  Makes counting an allocator that takes its blocks from parent and
+ *  keeps count of the bytes and blocks in use, and of the most bytes
+ *  ever in use. Thread safe if parent is.
+ * 
+ * TIME COMPLEXITY: 
+ *  O(1)
+ * 
+ * SPACE COMPLEXITY: 
+ *  O(1)
+ * 
+ * PARAMS:
+ *  counting:   allocator to initialize, its counts start at 0.
+ *  parent:     where the blocks come from.
+ *
+ * RETURN:
+ *  None.
+ */
+void AllocatorInitCounting(counting_allocator_t *counting, const allocator_t *parent);
+
+#endif /* __ILRD_ALLOCATOR_H__ */
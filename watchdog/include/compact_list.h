@@ -0,0 +1,36 @@
+/*
+	Coder : Josh Benichou
+	Date : 02/07/2023
+	Reviewer : *****
+*/
+
+#ifndef __ILRD_COMPACT_LIST_H__
+#define __ILRD_COMPACT_LIST_H__
+
+/*
+	Index based implementation of the sorted list API.
+	Link against compact_list and list_sort instead of
+	sorted_linked_list (and d_linked_list) to use it.
+
+	The nodes live in an arena of 4 KiB segments owned by the list, and
+	link each other by 32 bit index instead of by pointer: a node is 16
+	bytes on a 64 bit machine, against 32 for a d_linked_list node, and
+	there is no allocation per element. Since the links are indexes, the
+	segments can be moved or written out as they are.
+
+	Segments never move while the list lives, so iterators stay valid
+	until their element is removed. The differences:
+	- SortedListInsertLink() ignores the link and takes a node from the
+	  arena, a node outside of it cannot be indexed.
+	- SortedListMerge() copies the elements of src into nodes of dest, so
+	  iterators of src are invalidated. If the arena of dest cannot grow,
+	  the elements not merged yet stay in src.
+	- SortedListParallelMerge() is SortedListMerge(), on the calling thread.
+	- SortedListInsertArray() merges the same way, so when the arena
+	  cannot grow it may fail with part of the batch inserted.
+	A list holds fewer than 2^32 - 2^24 elements.
+*/
+
+#include "sorted_linked_list.h" /* sorted_list_t API */
+
+#endif /* __ILRD_COMPACT_LIST_H__ */
@@ -0,0 +1,37 @@
+/*
+	Coder : Josh Benichou
+	Date : 02/07/2023
+	Reviewer : *****
+*/
+
+#ifndef __ILRD_CONCURRENT_PQUEUE_H__
+#define __ILRD_CONCURRENT_PQUEUE_H__
+
+/*
+	Priority queue API for many threads at once, a relaxed multi-queue.
+	Link against concurrent_PQ (with heap, vector and parallel) instead of
+	priority_queue to use it.
+
+	The elements are spread over twice as many heaps as there are
+	processors, each behind a lock of its own. Enqueue pushes on a random
+	heap. Dequeue looks at the tops of two random heaps and pops the
+	smaller, so threads seldom wait on each other, but the element it
+	returns is one of the smallest, not always the smallest: the order
+	is relaxed by about the number of heaps. Use a single threaded
+	backend where exact order matters, such as the scheduler.
+	Dequeue never waits on a busy heap if another one will do, and
+	returns NULL once every heap is empty.
+
+	Every call may be made from any thread. PQueueSize(), IsPQueueEmpty()
+	and PQueuePeek() are exact only while no other thread alters the
+	queue. PQueueUpdate() and PQueueErase() take the last handle reported
+	for the element, so no other thread may move that element meanwhile.
+*/
+
+#include "priority_queue.h" /* p_queue_t API */
+
+#ifndef NDEBUG
+	void PrintQueue(p_queue_t *queue);
+#endif
+
+#endif /* __ILRD_CONCURRENT_PQUEUE_H__ */
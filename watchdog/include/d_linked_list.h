@@ -3,12 +3,24 @@
 
 #include <stddef.h> /* size_t */
 
+#include "vector.h" /* vector_t */
+#include "allocator.h" /* allocator_t */
+
 typedef int (*dll_matchfunc_t)(const void *list_data, void *match_data);
 typedef int (*dll_actionfunc_t)(void *iterator_data, void *user_data);
 
 typedef struct iterator *dll_iterator_t;
 typedef struct dll dll_t;
 
+/*
+ * Room for the links of an element that carries them itself, see
+ * DLLInsertLinkBefore(). Only the list functions touch it.
+ */
+typedef struct dll_link
+{
+    void *reserved[4];
+} dll_link_t;
+
 
 /*
  * DESCRIPTION:
@@ -30,6 +42,52 @@ typedef struct dll dll_t;
  */
 dll_t *DLLCreate(void);
 
+/*
+ * DESCRIPTION:
+ * Same as DLLCreate(), but the list takes its nodes from a pool of its
+ * own instead of one malloc() per element. The pool grows by chunks of
+ * doubling size, and removed nodes are kept for the next inserts. The
+ * memory goes back to the system only when the list is destroyed.
+ * 
+ * TIME COMPLEXITY: 
+ *  O(1)
+ * 
+ * SPACE COMPLEXITY: 
+ *  O(1)
+ * 
+ * PARAMS:
+ *  none
+ *
+ * RETURN:
+ *  The function returns a pointer to the doubly linked list.
+ *  In case of failure, the function returns NULL.
+ *
+ */
+dll_t *DLLCreatePooled(void);
+
+/*
+ * DESCRIPTION:
+ * Same as DLLCreate(), or DLLCreatePooled() when is_pooled, but the list,
+ * its nodes and its pool come from allocator. Nodes can only be spliced
+ * between lists that share the same allocator.
+ * 
+ * TIME COMPLEXITY: 
+ *  O(1)
+ * 
+ * SPACE COMPLEXITY: 
+ *  O(1)
+ * 
+ * PARAMS:
+ *  allocator:  where the memory comes from.
+ *  is_pooled:  non zero for a list that keeps a pool of nodes.
+ *
+ * RETURN:
+ *  The function returns a pointer to the doubly linked list.
+ *  In case of failure, the function returns NULL.
+ *
+ */
+dll_t *DLLCreateWithAllocator(const allocator_t *allocator, int is_pooled);
+
 /*
 * DESCRIPTION:
 *   Destroys the list, unlinks all the iterators and frees their memory.
@@ -63,6 +121,27 @@ void DLLDestroy(dll_t *dll);
 */
 dll_iterator_t DLLInsertBefore(dll_t *dll, dll_iterator_t iterator, void *data);
 
+/*
+* DESCRIPTION:
+*   Same as DLLInsertBefore(), but the node is link, kept by the user
+*   (usually inside the element itself), so nothing is allocated.
+*   Removing the element only unlinks link, and destroying the list
+*   leaves it alone. link must not be in any list.
+*
+*   Time complexity: O(1)
+*   Space Complexity: O(1)
+*
+* PARAMS:
+*   list:       Pointer to list to be altered.
+*   iterator:   The iterator to insert before.
+*   link:       Storage of the new node.
+*   data:       The data to store in the new node.
+*
+* RETURN:
+*   Returns an iterator to the inserted element, never fails.
+*/
+dll_iterator_t DLLInsertLinkBefore(dll_t *dll, dll_iterator_t iterator, dll_link_t *link, void *data);
+
 /*
 * DESCRIPTION:
 *   remove element from linkedlist.
@@ -146,13 +225,16 @@ int DLLForEachElement(dll_iterator_t from, dll_iterator_t to, void *userdata, dl
  *  target iterator.
  * 
  * TIME COMPLEXITY: 
- *  O(1)
+ *  O(1) inside a list, or when moving all of src. 
+ *  O(k) otherwise, k being the number of moved elements.
  * 
  * SPACE COMPLEXITY: 
  *  O(1)
  * 
  * PARAMS:
+ *  dest : list target belongs to
  *  target : insert before target  
+ *  src : list from and to belong to, may be dest
  *  from : iterator from which we want to cut 
  *  to : iterator to which we want to cut, not included
  *
@@ -160,7 +242,7 @@ int DLLForEachElement(dll_iterator_t from, dll_iterator_t to, void *userdata, dl
  *  nothing
  *
  */
-void DLLSplice(dll_iterator_t target, dll_iterator_t from, dll_iterator_t to);
+void DLLSplice(dll_t *dest, dll_iterator_t target, dll_t *src, dll_iterator_t from, dll_iterator_t to);
 
 /*
  * DESCRIPTION:
@@ -262,13 +344,12 @@ dll_iterator_t DLLBegin(const dll_t *dll);
  */
 dll_iterator_t DLLEnd(const dll_t *dll);
 
-/*O(n)*/
 /*
  * DESCRIPTION:
- *  The function counts the number of elements in the list.
+ *  The function returns the number of elements in the list.
  * 
  * TIME COMPLEXITY: 
- *  O(n)
+ *  O(1)
  * 
  * SPACE COMPLEXITY: 
  *  O(1)
@@ -422,6 +503,86 @@ int IsDLLIterEqual(dll_iterator_t iterator1, dll_iterator_t iterator2);
 */
 dll_iterator_t DLLFind(dll_iterator_t from, dll_iterator_t to, void *matchdata, dll_matchfunc_t func);
 
+/*
+ * DESCRIPTION:
+ *  Same as DLLForEachElement(), with the range cut in threads segments
+ *  of the same length, each one walked on its own thread. func is called
+ *  concurrently and must be safe to, including on userdata. A func that
+ *  returns 1 stops its own segment only.
+ *  Finding where the segments start is a serial walk of the range, so it
+ *  pays off when func costs more than a step to the next node.
+ * 
+ * TIME COMPLEXITY: 
+ *  O(n) walk + O(n / threads) calls
+ * 
+ * SPACE COMPLEXITY: 
+ *  O(threads)
+ * 
+ * PARAMS:
+ *  dll:        list of the range, its size spares counting a whole list.
+ *  from:       start of the section.
+ *  to:         end of the section.
+ *  userdata:   passed to func.
+ *  func:       the action function.
+ *  threads:    number of threads, 0 for ParallelThreads().
+ *
+ * RETURN:
+ *  1 if a call returned 1, otherwise what the call on the last element
+ *  returned.
+ */
+int DLLParallelForEach(dll_t *dll, dll_iterator_t from, dll_iterator_t to, 
+                        void *userdata, dll_actionfunc_t func, size_t threads);
+
+/*
+ * DESCRIPTION:
+ *  Pushes the data of every element of the range that func matches to
+ *  found, in list order. Segments are searched as in DLLParallelForEach().
+ * 
+ * TIME COMPLEXITY: 
+ *  O(n) walk + O(n / threads) calls
+ * 
+ * SPACE COMPLEXITY: 
+ *  O(matches)
+ * 
+ * PARAMS:
+ *  dll:        list of the range.
+ *  from:       start of the section.
+ *  to:         end of the section.
+ *  matchdata:  passed to func.
+ *  func:       the match function.
+ *  found:      vector of void * the matches are pushed to.
+ *  threads:    number of threads, 0 for ParallelThreads().
+ *
+ * RETURN:
+ *  0 on success, non zero if found could not hold the matches.
+ */
+int DLLParallelMultiFind(dll_t *dll, dll_iterator_t from, dll_iterator_t to, void *matchdata, 
+                        dll_matchfunc_t func, vector_t *found, size_t threads);
+
+/*
+ * DESCRIPTION:
+ *  Links nodes[0] -> nodes[1] -> ... -> nodes[count - 1], in both
+ *  directions. Nothing else is touched: it is up to the caller to give a
+ *  new order of nodes of a single list, from its element before to its
+ *  element after (DLLPrev(DLLBegin()) and DLLEnd() for a whole list).
+ *  Calls on parts of nodes that overlap by one node can run on different
+ *  threads.
+ * 
+ * TIME COMPLEXITY: 
+ *  O(count)
+ * 
+ * SPACE COMPLEXITY: 
+ *  O(1)
+ * 
+ * PARAMS:
+ *  nodes:  the nodes in their new order.
+ *  count:  number of nodes.
+ *
+ * RETURN:
+ *  None.
+ */
+void DLLLinkSequence(dll_iterator_t *nodes, size_t count);
+
 void DLLPrint(dll_t *list);
 
 #endif /* __ILRD_DLL_H__ */
\ No newline at end of file
@@ -0,0 +1,310 @@
+#ifndef __ILRD_HEAP_H__
+#define __ILRD_HEAP_H__
+
+#include <stddef.h> /* size_t */
+
+#include "allocator.h" /* allocator_t */
+
+/* handle given to an element that is not (or no longer) in the heap */
+#define HEAP_NO_HANDLE (0)
+
+typedef struct heap heap_t;
+
+typedef int (*heap_comparefunc_t)(const void *heap_data, void *new_data);
+typedef int (*heap_matchfunc_t)(const void *heap_data, void *match_data);
+typedef void (*heap_cleanfunc_t)(void *heap_data);
+
+/*
+ * DESCRIPTION:
+ *  Callback invoked every time an element lands in a new slot of the heap.
+ *  The user stores handle inside the element, and gives it back to
+ *  HeapUpdate() / HeapErase(). When the element leaves the heap the
+ *  callback is invoked with HEAP_NO_HANDLE.
+ *
+ * PARAMS:
+ *  heap_data:  the element that moved.
+ *  handle:     its new slot in the heap.
+ */
+typedef void (*heap_indexfunc_t)(void *heap_data, size_t handle);
+
+/*
+ * DESCRIPTION:
+ *  Creates an empty heap. The element for which cmp_func(element, other)
+ *  is never positive sits at the top.
+ *
+ * TIME COMPLEXITY:
+ *  O(1)
+ *
+ * SPACE COMPLEXITY:
+ *  O(1)
+ *
+ * PARAMS:
+ *  cmp_func:   compare function of the heap.
+ *
+ * RETURN:
+ *  Pointer to the new heap, NULL on failure.
+ */
+heap_t *HeapCreate(heap_comparefunc_t cmp_func);
+
+/*
+ * DESCRIPTION:
+ *  Creates an empty indexed heap. Same as HeapCreate(), but index_func
+ *  reports the slot of each element so it can later be updated or erased
+ *  without searching for it.
+ *
+ * TIME COMPLEXITY:
+ *  O(1)
+ *
+ * SPACE COMPLEXITY:
+ *  O(1)
+ *
+ * PARAMS:
+ *  cmp_func:   compare function of the heap.
+ *  index_func: called with the new slot of an element every time it moves.
+ *
+ * RETURN:
+ *  Pointer to the new heap, NULL on failure.
+ */
+heap_t *HeapCreateIndexed(heap_comparefunc_t cmp_func, heap_indexfunc_t index_func);
+
+/*
+ * DESCRIPTION:
+ *  Same as HeapCreateIndexed(), the heap and its array come from
+ *  allocator.
+ *
+ * TIME COMPLEXITY:
+ *  O(1)
+ *
+ * SPACE COMPLEXITY:
+ *  O(1)
+ *
+ * PARAMS:
+ *  allocator:  where the memory comes from.
+ *  cmp_func:   compare function of the heap.
+ *  index_func: called with the new slot of an element every time it
+ *              moves, may be NULL.
+ *
+ * RETURN:
+ *  Pointer to the new heap, NULL on failure.
+ */
+heap_t *HeapCreateWithAllocator(const allocator_t *allocator, heap_comparefunc_t cmp_func, 
+                                                        heap_indexfunc_t index_func);
+
+/*
+ * DESCRIPTION:
+ *  Frees the heap. The elements themselves are not freed.
+ *
+ * TIME COMPLEXITY:
+ *  O(1)
+ *
+ * SPACE COMPLEXITY:
+ *  O(1)
+ *
+ * PARAMS:
+ *  heap:   heap to be destroyed.
+ *
+ * RETURN:
+ *  None.
+ */
+void HeapDestroy(heap_t *heap);
+
+/*
+ * DESCRIPTION:
+ *  Inserts data to the heap.
+ *
+ * TIME COMPLEXITY:
+ *  O(log n)
+ *
+ * SPACE COMPLEXITY:
+ *  O(1) amortized
+ *
+ * PARAMS:
+ *  heap:   heap to be altered.
+ *  data:   element to insert.
+ *
+ * RETURN:
+ *  0 on success, non zero on failure.
+ */
+int HeapPush(heap_t *heap, void *data);
+
+/*
+ * DESCRIPTION:
+ *  Removes the top element of the heap. Popping an empty heap does nothing.
+ *
+ * TIME COMPLEXITY:
+ *  O(log n)
+ *
+ * SPACE COMPLEXITY:
+ *  O(1)
+ *
+ * PARAMS:
+ *  heap:   heap to be altered.
+ *
+ * RETURN:
+ *  None.
+ */
+void HeapPop(heap_t *heap);
+
+/*
+ * DESCRIPTION:
+ *  Returns the top element of the heap. Peeking an empty heap is undefined.
+ *
+ * TIME COMPLEXITY:
+ *  O(1)
+ *
+ * SPACE COMPLEXITY:
+ *  O(1)
+ *
+ * PARAMS:
+ *  heap:   heap to be evaluated.
+ *
+ * RETURN:
+ *  The top element.
+ */
+void *HeapPeek(const heap_t *heap);
+
+/*
+ * DESCRIPTION:
+ *  Returns the number of elements in the heap.
+ *
+ * TIME COMPLEXITY:
+ *  O(1)
+ *
+ * SPACE COMPLEXITY:
+ *  O(1)
+ *
+ * PARAMS:
+ *  heap:   heap to be evaluated.
+ *
+ * RETURN:
+ *  Number of elements.
+ */
+size_t HeapSize(const heap_t *heap);
+
+/*
+ * DESCRIPTION:
+ *  Is the heap empty ?
+ *
+ * TIME COMPLEXITY:
+ *  O(1)
+ *
+ * SPACE COMPLEXITY:
+ *  O(1)
+ *
+ * PARAMS:
+ *  heap:   heap to be evaluated.
+ *
+ * RETURN:
+ *  1 if empty, 0 otherwise.
+ */
+int IsHeapEmpty(const heap_t *heap);
+
+/*
+ * DESCRIPTION:
+ *  Removes the first element matching search_data according to match_func.
+ *
+ * TIME COMPLEXITY:
+ *  O(n)
+ *
+ * SPACE COMPLEXITY:
+ *  O(1)
+ *
+ * PARAMS:
+ *  heap:           heap to be altered.
+ *  match_func:     returns non zero on match.
+ *  search_data:    data passed to match_func.
+ *
+ * RETURN:
+ *  The removed element, NULL if not found.
+ */
+void *HeapRemove(heap_t *heap, heap_matchfunc_t match_func, const void *search_data);
+
+/*
+ * DESCRIPTION:
+ *  Removes every element matching search_data according to match_func,
+ *  hands each of them to clean_func, and rebuilds the heap in one pass.
+ *
+ * TIME COMPLEXITY:
+ *  O(n)
+ *
+ * SPACE COMPLEXITY:
+ *  O(1)
+ *
+ * PARAMS:
+ *  heap:           heap to be altered.
+ *  match_func:     returns non zero on match.
+ *  search_data:    data passed to match_func.
+ *  clean_func:     called on each removed element, may be NULL.
+ *
+ * RETURN:
+ *  Number of removed elements.
+ */
+size_t HeapRemoveAll(heap_t *heap, heap_matchfunc_t match_func, 
+                        const void *search_data, heap_cleanfunc_t clean_func);
+
+/*
+ * DESCRIPTION:
+ *  Finds the first element matching search_data according to match_func,
+ *  without removing it.
+ *
+ * TIME COMPLEXITY:
+ *  O(n)
+ *
+ * SPACE COMPLEXITY:
+ *  O(1)
+ *
+ * PARAMS:
+ *  heap:           heap to be evaluated.
+ *  match_func:     returns non zero on match.
+ *  search_data:    data passed to match_func.
+ *
+ * RETURN:
+ *  The found element, NULL if not found.
+ */
+void *HeapFind(const heap_t *heap, heap_matchfunc_t match_func, const void *search_data);
+
+/*
+ * DESCRIPTION:
+ *  Restores the heap order after the priority of the element at handle
+ *  was changed in place. Only valid on heaps made by HeapCreateIndexed().
+ *
+ * TIME COMPLEXITY:
+ *  O(log n)
+ *
+ * SPACE COMPLEXITY:
+ *  O(1)
+ *
+ * PARAMS:
+ *  heap:   heap to be altered.
+ *  handle: last handle reported for the element.
+ *
+ * RETURN:
+ *  None.
+ */
+void HeapUpdate(heap_t *heap, size_t handle);
+
+/*
+ * DESCRIPTION:
+ *  Removes the element at handle. Only valid on heaps made by
+ *  HeapCreateIndexed().
+ *
+ * TIME COMPLEXITY:
+ *  O(log n)
+ *
+ * SPACE COMPLEXITY:
+ *  O(1)
+ *
+ * PARAMS:
+ *  heap:   heap to be altered.
+ *  handle: last handle reported for the element.
+ *
+ * RETURN:
+ *  The removed element.
+ */
+void *HeapErase(heap_t *heap, size_t handle);
+
+#ifndef NDEBUG
+    void PrintHeap(heap_t *heap);
+#endif
+
+#endif /* __ILRD_HEAP_H__ */
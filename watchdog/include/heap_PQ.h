@@ -0,0 +1,22 @@
+/*
+	Coder : Josh Benichou
+	Date : 02/07/2023
+	Reviewer : *****
+*/	
+
+#ifndef __ILRD_HEAP_PQUEUE_H__
+#define __ILRD_HEAP_PQUEUE_H__
+
+/* 
+	Heap backed implementation of the priority queue API.
+	Link against heap_PQ instead of priority_queue to use it.
+*/
+
+#include "priority_queue.h" /* p_queue_t API */
+#include "heap.h" /* heap_t */
+
+#ifndef NDEBUG
+	void PrintQueue(p_queue_t *queue);
+#endif
+
+#endif /* __ILRD_HEAP_PQUEUE_H__ */
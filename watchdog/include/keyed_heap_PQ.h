@@ -0,0 +1,30 @@
+/*
+	Coder : Josh Benichou
+	Date : 02/07/2023
+	Reviewer : *****
+*/
+
+#ifndef __ILRD_KEYED_HEAP_PQUEUE_H__
+#define __ILRD_KEYED_HEAP_PQUEUE_H__
+
+/*
+	Heap implementation of the priority queue API specialized for integer
+	keys, such as the scheduler's deadlines.
+	Link against keyed_heap_PQ instead of priority_queue to use it.
+
+	The key of an element is read once when it is enqueued or updated, and
+	kept next to it in the heap, so ordering is an inlined compare of two
+	unsigned long instead of a call to the compare function.
+
+	Only queues made with a key_func are supported: PQueueCreate() and
+	PQueueCreateIndexed() have no key to order by, and return NULL.
+	Elements with the same key come out in no particular order.
+*/
+
+#include "priority_queue.h" /* p_queue_t API */
+
+#ifndef NDEBUG
+	void PrintQueue(p_queue_t *queue);
+#endif
+
+#endif /* __ILRD_KEYED_HEAP_PQUEUE_H__ */
@@ -0,0 +1,34 @@
+#ifndef __ILRD_LIST_SORT_H__
+#define __ILRD_LIST_SORT_H__
+
+#include <stddef.h> /* size_t */
+
+#include "sorted_linked_list.h" /* sort_comparefunc_t */
+
+/*
+ * DESCRIPTION:
+ *  Stable merge sort of an array of element pointers, in the order a
+ *  sorted_list_t keeps them: an element goes before every element it is
+ *  not smaller than, and equal elements keep their order in the array.
+ *  So the array holds what inserting its elements one by one in a sorted
+ *  list would give, and can be linked front to back as is.
+ *  Input already in that order is detected and costs a single pass.
+ * 
+ * TIME COMPLEXITY: 
+ *  O(n log n), O(n) when already sorted
+ * 
+ * SPACE COMPLEXITY: 
+ *  O(n)
+ * 
+ * PARAMS:
+ *  data:   array of count element pointers, sorted in place.
+ *  count:  number of elements.
+ *  func:   compare function of the sorted list.
+ *
+ * RETURN:
+ *  0 on success, non zero when the merge buffer cannot be allocated.
+ *  data is left as is on failure.
+ */
+int ListSortArray(void **data, size_t count, sort_comparefunc_t func);
+
+#endif /* __ILRD_LIST_SORT_H__ */
@@ -0,0 +1,197 @@
+#ifndef __ILRD_MPMC_QUEUE_H__
+#define __ILRD_MPMC_QUEUE_H__
+
+#include <stddef.h> /* size_t */
+
+#include "allocator.h" /* allocator_t */
+
+/*
+	Bounded queue of pointers, for any number of producer and consumer
+	threads at once, without locks.
+	Each cell of the ring has a sequence number telling the position it
+	is ready for: a producer at position p waits for p, a consumer for
+	p + 1. A thread claims its position with one compare and swap on the
+	enqueue or dequeue index, then publishes the cell with a release
+	store of the next sequence number. The two indices sit on cache lines
+	of their own, so producers and consumers do not slow each other down.
+	A batch claims a run of ready cells with a single compare and swap.
+	Elements come out in the order their positions were claimed, so the
+	elements of one producer come out in the order it enqueued them.
+*/
+
+typedef struct mpmc_queue mpmc_queue_t;
+
+/*
+ * DESCRIPTION:
+ *  Creates an empty queue with room for capacity elements, rounded up
+ *  to a power of two.
+ *
+ * TIME COMPLEXITY:
+ *  O(capacity)
+ *
+ * SPACE COMPLEXITY:
+ *  O(capacity)
+ *
+ * PARAMS:
+ *  capacity:   number of elements the queue can hold, at least 2.
+ *
+ * RETURN:
+ *  Pointer to the new queue, NULL on failure.
+ */
+mpmc_queue_t *MPMCQueueCreate(size_t capacity);
+
+/*
+ * DESCRIPTION:
+ *  Same as MPMCQueueCreate(), but the queue comes from allocator.
+ *
+ * TIME COMPLEXITY:
+ *  O(capacity)
+ *
+ * SPACE COMPLEXITY:
+ *  O(capacity)
+ *
+ * PARAMS:
+ *  allocator:  where the memory comes from.
+ *  capacity:   number of elements the queue can hold, at least 2.
+ *
+ * RETURN:
+ *  Pointer to the new queue, NULL on failure.
+ */
+mpmc_queue_t *MPMCQueueCreateWithAllocator(const allocator_t *allocator, size_t capacity);
+
+/*
+ * DESCRIPTION:
+ *  Frees the queue. The elements are not touched. No other thread may
+ *  use the queue anymore.
+ *
+ * TIME COMPLEXITY:
+ *  O(1)
+ *
+ * SPACE COMPLEXITY:
+ *  O(1)
+ *
+ * PARAMS:
+ *  queue:  queue to be destroyed.
+ *
+ * RETURN:
+ *  None.
+ */
+void MPMCQueueDestroy(mpmc_queue_t *queue);
+
+/*
+ * DESCRIPTION:
+ *  Adds data at the back of the queue. Never waits: fails when full.
+ *
+ * TIME COMPLEXITY:
+ *  O(1), retried while other producers win the race
+ *
+ * SPACE COMPLEXITY:
+ *  O(1)
+ *
+ * PARAMS:
+ *  queue:  queue to be altered.
+ *  data:   element to add, not NULL.
+ *
+ * RETURN:
+ *  0 on success, non zero when the queue is full.
+ */
+int MPMCQueueEnqueue(mpmc_queue_t *queue, void *data);
+
+/*
+ * DESCRIPTION:
+ *  Removes the element at the front of the queue. Never waits.
+ *
+ * TIME COMPLEXITY:
+ *  O(1), retried while other consumers win the race
+ *
+ * SPACE COMPLEXITY:
+ *  O(1)
+ *
+ * PARAMS:
+ *  queue:  queue to be altered.
+ *
+ * RETURN:
+ *  The removed element, NULL when the queue is empty.
+ */
+void *MPMCQueueDequeue(mpmc_queue_t *queue);
+
+/*
+ * DESCRIPTION:
+ *  Adds the first elements of data, as many as there is room for, in
+ *  one run of consecutive positions.
+ *
+ * TIME COMPLEXITY:
+ *  O(count)
+ *
+ * SPACE COMPLEXITY:
+ *  O(1)
+ *
+ * PARAMS:
+ *  queue:  queue to be altered.
+ *  data:   elements to add, none of them NULL.
+ *  count:  number of elements of data.
+ *
+ * RETURN:
+ *  Number of elements added, from the front of data. 0 when full.
+ */
+size_t MPMCQueueEnqueueBatch(mpmc_queue_t *queue, void **data, size_t count);
+
+/*
+ * DESCRIPTION:
+ *  Removes up to count elements from the front of the queue, in one run
+ *  of consecutive positions.
+ *
+ * TIME COMPLEXITY:
+ *  O(count)
+ *
+ * SPACE COMPLEXITY:
+ *  O(1)
+ *
+ * PARAMS:
+ *  queue:  queue to be altered.
+ *  data:   receives the removed elements, room for count of them.
+ *  count:  most elements to remove.
+ *
+ * RETURN:
+ *  Number of elements removed. 0 when empty.
+ */
+size_t MPMCQueueDequeueBatch(mpmc_queue_t *queue, void **data, size_t count);
+
+/*
+ * DESCRIPTION:
+ *  Number of elements in the queue. While other threads use it, the
+ *  count may be out of date as soon as it is returned.
+ *
+ * TIME COMPLEXITY:
+ *  O(1)
+ *
+ * SPACE COMPLEXITY:
+ *  O(1)
+ *
+ * PARAMS:
+ *  queue:  queue to be evaluated.
+ *
+ * RETURN:
+ *  Number of elements.
+ */
+size_t MPMCQueueSize(const mpmc_queue_t *queue);
+
+/*
+ * DESCRIPTION:
+ *  Number of elements the queue can hold.
+ *
+ * TIME COMPLEXITY:
+ *  O(1)
+ *
+ * SPACE COMPLEXITY:
+ *  O(1)
+ *
+ * PARAMS:
+ *  queue:  queue to be evaluated.
+ *
+ * RETURN:
+ *  Capacity of the queue.
+ */
+size_t MPMCQueueCapacity(const mpmc_queue_t *queue);
+
+#endif /* __ILRD_MPMC_QUEUE_H__ */
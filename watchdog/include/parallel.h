@@ -0,0 +1,51 @@
+#ifndef __ILRD_PARALLEL_H__
+#define __ILRD_PARALLEL_H__
+
+#include <stddef.h> /* size_t */
+
+typedef void (*parallel_func_t)(void *arg);
+
+/*
+ * DESCRIPTION:
+ *  Number of processors online, the default number of threads of the
+ *  parallel list functions.
+ * 
+ * TIME COMPLEXITY: 
+ *  O(1)
+ * 
+ * SPACE COMPLEXITY: 
+ *  O(1)
+ * 
+ * PARAMS:
+ *  none
+ *
+ * RETURN:
+ *  Number of processors, at least 1.
+ */
+size_t ParallelThreads(void);
+
+/*
+ * DESCRIPTION:
+ *  Calls func once on each of the count arguments of args, each one on
+ *  its own thread, and returns when all calls returned. The first call
+ *  runs on the calling thread. A thread that cannot be created has its
+ *  call run on the calling thread too, so every call is always made.
+ * 
+ * TIME COMPLEXITY: 
+ *  O(count) plus the longest call
+ * 
+ * SPACE COMPLEXITY: 
+ *  O(count)
+ * 
+ * PARAMS:
+ *  func:       function to call.
+ *  args:       array of count arguments.
+ *  arg_size:   size in bytes of one argument.
+ *  count:      number of calls.
+ *
+ * RETURN:
+ *  None.
+ */
+void ParallelRun(parallel_func_t func, void *args, size_t arg_size, size_t count);
+
+#endif /* __ILRD_PARALLEL_H__ */
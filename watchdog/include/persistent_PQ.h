@@ -0,0 +1,193 @@
+#ifndef __ILRD_PERSISTENT_PQUEUE_H__
+#define __ILRD_PERSISTENT_PQUEUE_H__
+
+#include <stddef.h> /* size_t */
+
+/*
+    Priority queue kept in a file, mapped into memory, so that it outlives
+    the process: opening an existing queue maps it and reads its header,
+    whatever the number of queued elements.
+    Elements are records of a fixed size, copied in and out: pointers
+    would not mean anything to the next process. The records sit in the
+    layout of heap.c, a binary heap from index 1. Slot 0, unused by
+    heap.c, holds the record being moved by an update in flight.
+
+    Every update leaves the file repairable at any instruction: the moving
+    record is written to slot 0 first, then the header says which slot
+    it belongs in. If the process dies midway, the next open puts the
+    record back into that slot and sifts it, O(log n). A dequeue cut short
+    is completed as well: its record is gone even if the caller never got
+    to use it. Updates only reach the disk as the kernel writes the pages
+    back, or on PersistentPQSync(): a system crash keeps the queue as of
+    the last sync that no update followed.
+
+    A file is read by the version of this module, and the kind of machine,
+    that wrote it. A queue is used by one thread, in one process, at a
+    time.
+*/
+
+/* bumped whenever the layout of the file changes */
+#define PERSISTENT_PQ_VERSION (1)
+
+typedef struct persistent_pq persistent_pq_t;
+
+/* > 0 when record is dequeued after other, like heap_comparefunc_t */
+typedef int (*persistent_comparefunc_t)(const void *record, const void *other);
+
+/*
+ * DESCRIPTION:
+ *  Opens the queue stored in the file at path, or creates it empty when
+ *  there is no such file. An update cut short by a crash is completed.
+ *  An existing file that is not a queue is refused, never overwritten.
+ *  A new queue is made as path followed by 6 random characters, then
+ *  linked at path, a crash meanwhile can leave that file behind.
+ *
+ * TIME COMPLEXITY:
+ *  O(1), O(log n) after a crash
+ *
+ * SPACE COMPLEXITY:
+ *  O(1)
+ *
+ * PARAMS:
+ *  path:           file that holds the queue.
+ *  record_size:    size in bytes of one record, the same on every open.
+ *  cmp_func:       orders the records, the same on every open.
+ *
+ * RETURN:
+ *  Pointer to the queue, NULL on failure, or when the file is not a
+ *  queue of this version and record size.
+ */
+persistent_pq_t *PersistentPQOpen(const char *path, size_t record_size,
+                                            persistent_comparefunc_t cmp_func);
+
+/*
+ * DESCRIPTION:
+ *  Unmaps the queue and closes its file. The queue stays in the file.
+ *
+ * TIME COMPLEXITY:
+ *  O(1)
+ *
+ * SPACE COMPLEXITY:
+ *  O(1)
+ *
+ * PARAMS:
+ *  queue:  queue to be closed.
+ *
+ * RETURN:
+ *  None.
+ */
+void PersistentPQClose(persistent_pq_t *queue);
+
+/*
+ * DESCRIPTION:
+ *  Copies record into the queue. The file grows when full.
+ *  Pointers given by PersistentPQPeek() are invalidated.
+ *
+ * TIME COMPLEXITY:
+ *  O(log n) amortized
+ *
+ * SPACE COMPLEXITY:
+ *  O(1) amortized
+ *
+ * PARAMS:
+ *  queue:  queue to be altered.
+ *  record: record_size bytes to copy.
+ *
+ * RETURN:
+ *  0 on success, -1 on failure.
+ */
+int PersistentPQEnqueue(persistent_pq_t *queue, const void *record);
+
+/*
+ * DESCRIPTION:
+ *  Copies the first record of the queue to record, and removes it.
+ *
+ * TIME COMPLEXITY:
+ *  O(log n)
+ *
+ * SPACE COMPLEXITY:
+ *  O(1)
+ *
+ * PARAMS:
+ *  queue:  queue to be altered.
+ *  record: receives record_size bytes.
+ *
+ * RETURN:
+ *  0 on success, non zero when the queue is empty.
+ */
+int PersistentPQDequeue(persistent_pq_t *queue, void *record);
+
+/*
+ * DESCRIPTION:
+ *  Gives access to the first record of the queue, inside the mapping.
+ *  The pointer is invalidated by any update.
+ *
+ * TIME COMPLEXITY:
+ *  O(1)
+ *
+ * SPACE COMPLEXITY:
+ *  O(1)
+ *
+ * PARAMS:
+ *  queue:  queue to be evaluated.
+ *
+ * RETURN:
+ *  Pointer to the first record, NULL when the queue is empty.
+ */
+const void *PersistentPQPeek(const persistent_pq_t *queue);
+
+/*
+ * DESCRIPTION:
+ *  Returns the number of records in the queue.
+ *
+ * TIME COMPLEXITY:
+ *  O(1)
+ *
+ * SPACE COMPLEXITY:
+ *  O(1)
+ *
+ * PARAMS:
+ *  queue:  queue to be evaluated.
+ *
+ * RETURN:
+ *  Number of records.
+ */
+size_t PersistentPQSize(const persistent_pq_t *queue);
+
+/*
+ * DESCRIPTION:
+ *  Is the queue empty.
+ *
+ * TIME COMPLEXITY:
+ *  O(1)
+ *
+ * SPACE COMPLEXITY:
+ *  O(1)
+ *
+ * PARAMS:
+ *  queue:  queue to be evaluated.
+ *
+ * RETURN:
+ *  Non 0 if the queue is empty, 0 otherwise.
+ */
+int IsPersistentPQEmpty(const persistent_pq_t *queue);
+
+/*
+ * DESCRIPTION:
+ *  Writes the queue to the disk, and waits for it.
+ *
+ * TIME COMPLEXITY:
+ *  O(n) pages written at most
+ *
+ * SPACE COMPLEXITY:
+ *  O(1)
+ *
+ * PARAMS:
+ *  queue:  queue to be written.
+ *
+ * RETURN:
+ *  0 on success, non zero on failure.
+ */
+int PersistentPQSync(persistent_pq_t *queue);
+
+#endif /* __ILRD_PERSISTENT_PQUEUE_H__ */
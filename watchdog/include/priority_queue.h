@@ -10,10 +10,37 @@
 
 #include <stddef.h> /* size_t */
 #include "sorted_linked_list.h" /* my functions */
+#include "allocator.h" /* allocator_t */
+
+/* handle given to an element that is not (or no longer) in the queue */
+#define PQ_NO_HANDLE (0)
 
 typedef struct p_queue p_queue_t;
 typedef int (*priority_comparefunc_t)(const void *queuedata, void *comparedata);
 typedef int (*priority_matchfunc_t)(const void *listdata, void *matchdata);
+typedef void (*priority_cleanfunc_t)(void *queuedata);
+
+/*
+* DESCRIPTION:
+*   Callback invoked with the handle of an element every time the queue
+*   moves it, and with PQ_NO_HANDLE once it leaves the queue.
+*   The user keeps the handle inside the element for PQueueUpdate() and
+*   PQueueErase().
+*/
+typedef void (*priority_handlefunc_t)(void *queuedata, size_t handle);
+
+/*
+* DESCRIPTION:
+*   Returns the integer priority of an element, smaller is dequeued first.
+*   Must agree with the compare function of the queue.
+*/
+typedef unsigned long (*priority_keyfunc_t)(const void *queuedata);
+
+/*
+* DESCRIPTION:
+*   Returns the storage an element keeps for its own queue links.
+*/
+typedef dll_link_t *(*priority_linkfunc_t)(void *queuedata);
 
 
 /*
@@ -34,6 +61,97 @@ typedef int (*priority_matchfunc_t)(const void *listdata, void *matchdata);
 */
 p_queue_t *PQueueCreate(priority_comparefunc_t func);
 
+/*
+* DESCRIPTION:
+*   Creates an empty priority queue that reports element handles through
+*   handle_func, so elements can be updated or erased without a search.
+*   
+*   Time comlexity O(1)
+*   Space complexity O(1)
+* 
+* PARAMS:
+*   func:           compare function of the queue.
+*   handle_func:    receives the handle of each element when it moves.
+*
+* RETURN:
+*   Reference to priority queue type data structure.
+*   NULL if fails.
+*/
+p_queue_t *PQueueCreateIndexed(priority_comparefunc_t func, priority_handlefunc_t handle_func);
+
+/*
+* DESCRIPTION:
+*   Creates an empty indexed priority queue whose elements also carry an
+*   integer key. Backends that only compare ignore key_func, the radix
+*   backend orders by it alone.
+*   Keys are expected to be monotone: an element enqueued with a key
+*   smaller than the last dequeued key is treated as if it had that key.
+*   
+*   Time comlexity O(1)
+*   Space complexity O(1)
+* 
+* PARAMS:
+*   func:           compare function of the queue.
+*   key_func:       integer key of an element.
+*   handle_func:    receives the handle of each element when it moves,
+*                   may be NULL.
+*
+* RETURN:
+*   Reference to priority queue type data structure.
+*   NULL if fails.
+*/
+p_queue_t *PQueueCreateKeyed(priority_comparefunc_t func, 
+                priority_keyfunc_t key_func, priority_handlefunc_t handle_func);
+
+/*
+* DESCRIPTION:
+*   Same as PQueueCreateKeyed(), for elements that carry their own links.
+*   The sorted list backend links link_func(element) instead of
+*   allocating a node, so enqueue, dequeue and erase allocate nothing.
+*   The other backends have no links and ignore link_func.
+*   
+*   Time comlexity O(1)
+*   Space complexity O(1)
+* 
+* PARAMS:
+*   func:           compare function of the queue.
+*   key_func:       integer key of an element.
+*   handle_func:    receives the handle of each element when it moves,
+*                   may be NULL.
+*   link_func:      links storage of an element.
+*
+* RETURN:
+*   Reference to priority queue type data structure.
+*   NULL if fails.
+*/
+p_queue_t *PQueueCreateIntrusive(priority_comparefunc_t func, priority_keyfunc_t key_func,
+                priority_handlefunc_t handle_func, priority_linkfunc_t link_func);
+
+/*
+* DESCRIPTION:
+*   Same as the other creators, but the queue and everything it holds
+*   come from allocator. The others call it with AllocatorGetDefault().
+*   
+*   Time comlexity O(1)
+*   Space complexity O(1)
+* 
+* PARAMS:
+*   allocator:      where the memory comes from.
+*   func:           compare function of the queue.
+*   key_func:       integer key of an element, may be NULL except for
+*                   the backends that order by key.
+*   handle_func:    receives the handle of each element when it moves,
+*                   may be NULL.
+*   link_func:      links storage of an element, may be NULL.
+*
+* RETURN:
+*   Reference to priority queue type data structure.
+*   NULL if fails.
+*/
+p_queue_t *PQueueCreateWithAllocator(const allocator_t *allocator, 
+                priority_comparefunc_t func, priority_keyfunc_t key_func,
+                priority_handlefunc_t handle_func, priority_linkfunc_t link_func);
+
 /*
 * DESCRIPTION:
 *   Cleans the priority queue and frees it's memory.
@@ -120,7 +238,7 @@ int IsPQueueEmpty(const p_queue_t *queue);
 * DESCRIPTION:
 *   Returns the number of items in the priority queue.
 *
-*   Time complexity: O(n)
+*   Time complexity: O(1)
 *   Space Complexity: O(1)
 *
 * PARAMS:
@@ -165,6 +283,82 @@ void PQueueClear(p_queue_t *queue);
 */  
 void *PQueueRemove(p_queue_t *queue, void *matchdata, priority_matchfunc_t matchfunc);
 
+/*
+* DESCRIPTION:
+*   The function removes from the queue every element matching
+*   matchdata according to given matchfunc, and hands each one
+*   to clean_func.
+*
+*   Time complexity: O(n)
+*   Space Complexity: O(1)
+*
+* PARAMS:
+*   queue:      The priority queue to remove from.
+*   matchdata:  Data passed to matchfunc.
+*   matchfunc:  Matching function.
+*   clean_func: Called on each removed element, may be NULL.
+*
+* RETURN:
+*   Number of removed elements.
+*/  
+size_t PQueueRemoveAll(p_queue_t *queue, void *matchdata, 
+                    priority_matchfunc_t matchfunc, priority_cleanfunc_t clean_func);
+
+/*
+* DESCRIPTION:
+*   The function finds the element matching matchdata according to
+*   given matchfunc, without removing it.
+*
+*   Time complexity: O(n)
+*   Space Complexity: O(1)
+*
+* PARAMS:
+*   queue:      The priority queue to search.
+*   matchdata:  The data to look for.
+*   matchfunc:  Matching function.
+*
+* RETURN:
+*   The found data, NULL if not found.
+*/  
+void *PQueueFind(p_queue_t *queue, void *matchdata, priority_matchfunc_t matchfunc);
+
+/*
+* DESCRIPTION:
+*   Restores the queue order after the priority of the element at handle
+*   was changed in place. Queue must be made by PQueueCreateIndexed().
+*
+*   Time complexity: O(log n) heap, O(n) sorted list
+*   Space Complexity: O(1)
+*
+* PARAMS:
+*   queue:      The priority queue to be altered.
+*   handle:     Last handle reported for the element.
+*
+* RETURN:
+*   0	if the operation succeeded.
+*	-1	if the operation failed, then the element is out of the queue
+*		and its handle is reported as PQ_NO_HANDLE. The sorted list
+*		allocates nothing here and never fails.
+*/  
+int PQueueUpdate(p_queue_t *queue, size_t handle);
+
+/*
+* DESCRIPTION:
+*   Removes the element at handle from the queue.
+*   Queue must be made by PQueueCreateIndexed().
+*
+*   Time complexity: O(log n) heap, O(1) sorted list
+*   Space Complexity: O(1)
+*
+* PARAMS:
+*   queue:      The priority queue to be altered.
+*   handle:     Last handle reported for the element.
+*
+* RETURN:
+*   The removed data.
+*/  
+void *PQueueErase(p_queue_t *queue, size_t handle);
+
 sorted_list_t *GetListInQueue(p_queue_t *queue);
 
 #endif /* __ILRD_PQUEUE_H__ */
\ No newline at end of file
@@ -0,0 +1,28 @@
+/*
+	Coder : Josh Benichou
+	Date : 02/07/2023
+	Reviewer : *****
+*/
+
+#ifndef __ILRD_RADIX_PQUEUE_H__
+#define __ILRD_RADIX_PQUEUE_H__
+
+/*
+	Radix heap implementation of the priority queue API, for monotone
+	integer keys such as the scheduler's deadlines.
+	Link against radix_PQ instead of priority_queue to use it.
+
+	Only queues made with a key_func are supported: PQueueCreate() and
+	PQueueCreateIndexed() have no key to order by, and return NULL.
+	Enqueue, dequeue (amortized), update and erase are O(1), independent of
+	the number of queued elements. Elements with the same key come out in
+	no particular order.
+*/
+
+#include "priority_queue.h" /* p_queue_t API */
+
+#ifndef NDEBUG
+	void PrintQueue(p_queue_t *queue);
+#endif
+
+#endif /* __ILRD_RADIX_PQUEUE_H__ */
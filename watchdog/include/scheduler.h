@@ -3,11 +3,13 @@
 
 #include <sys/types.h> /* time_t */
 #include "uid.h" /* our uid functions */
+#include "allocator.h" /* allocator_t */
 
 #define STOP_SIGNAL (0)
 #define SIGNAL_FILE_NAME ("scheduler_run_flag.txt")
 #define ALLOWED_TO_RUN (1)
 #define CANNOT_RUN (0)
+#define DEFAULT_CANCELLED_RATIO (0.5)
 
 typedef struct scheduler scheduler_t;
 
@@ -51,6 +53,22 @@ typedef void (*scheduler_clean_func_t)(void*);
  */
 scheduler_t *SchedulerCreate(void);
 
+/*
+ * DESCRIPTION:
+ *   Same as SchedulerCreate(), but the scheduler, its queue, its uid map
+ *   and the tasks it creates come from allocator.
+ * 
+ *   Time complexity: O(1)
+ *   Space complexity: O(1)
+ * 
+ * PARAMS:
+ *   allocator - where the memory comes from.
+ * 
+ * RETURN:
+ *   Returns a pointer to the newly created scheduler, or NULL on failure.
+ */
+scheduler_t *SchedulerCreateWithAllocator(const allocator_t *allocator);
+
 /*
  * DESCRIPTION:
  *   Destroy a scheduler and free its resources.
@@ -86,8 +104,12 @@ ilrd_uid_t SchedulerAdd(scheduler_t *scheduler, scheduler_operation_t task_func,
 /*
  * DESCRIPTION:
  *   Remove a task from the scheduler.
+ *   The task's clean function runs right away, but the task is only
+ *   marked as cancelled: it is dropped when it reaches the front of the
+ *   queue, or when cancelled tasks pass the cancelled ratio of the queue
+ *   (see SchedulerSetCancelledRatio()).
  * 
- *   Time complexity: O(n)
+ *   Time complexity: O(1) expected lookup (by uid map), O(1) cancellation
  *   Space complexity: O(1)
  * 
  * PARAMS:
@@ -99,6 +121,39 @@ ilrd_uid_t SchedulerAdd(scheduler_t *scheduler, scheduler_operation_t task_func,
  */
 int SchedulerRemove(scheduler_t *scheduler, ilrd_uid_t uid);
 
+/*
+ * DESCRIPTION:
+ *   Move a queued task to a new time to run, without removing it
+ *   from the scheduler.
+ * 
+ *   Time complexity: O(1) expected lookup (by uid map), O(log n) move
+ *   Space complexity: O(1)
+ * 
+ * PARAMS:
+ *   scheduler - A pointer to the scheduler.
+ *   uid - The unique identifier (uid) of the task to be moved.
+ *   time_to_run - The new time at which the task should be executed.
+ * RETURN:
+ *   0 - If succeeded
+ *   Not 0 - If failes
+ */
+int SchedulerReschedule(scheduler_t *scheduler, ilrd_uid_t uid, time_t time_to_run);
+
+/*
+ * DESCRIPTION:
+ *   Set the share of cancelled tasks the queue may hold before they are
+ *   all dropped in one pass. 0 drops them on every removal.
+ *   Defaults to DEFAULT_CANCELLED_RATIO.
+ * 
+ *   Time complexity: O(1)
+ *   Space complexity: O(1)
+ * 
+ * PARAMS:
+ *   scheduler - A pointer to the scheduler.
+ *   ratio - cancelled tasks / queued tasks, between 0 and 1.
+ */
+void SchedulerSetCancelledRatio(scheduler_t *scheduler, double ratio);
+
 /*
  * DESCRIPTION:
  *   Run the scheduler, executing all pending tasks.
@@ -133,7 +188,7 @@ void SchedulerStop(scheduler_t *scheduler);
  * DESCRIPTION:
  *   Get the number of tasks in the scheduler.
  * 
- *   Time complexity: O(n)
+ *   Time complexity: O(1)
  *   Space complexity: O(1)
  * 
  * PARAMS:
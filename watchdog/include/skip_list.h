@@ -0,0 +1,32 @@
+/*
+	Coder : Josh Benichou
+	Date : 02/07/2023
+	Reviewer : *****
+*/
+
+#ifndef __ILRD_SKIP_LIST_H__
+#define __ILRD_SKIP_LIST_H__
+
+/*
+	Skip list implementation of the sorted list API.
+	Link against skip_list and list_sort instead of sorted_linked_list
+	(and d_linked_list) to use it.
+
+	The bottom level is a doubly linked list of the elements, so
+	iterators, SortedListNext() / SortedListPrev() and the pops work as
+	before, and nodes never move. On top of it, half of the nodes are also
+	linked on level 1, a quarter on level 2 and so on, so SortedListInsert()
+	and SortedListFind() are expected O(log n) instead of O(n).
+	SortedListRemove() and the pops stay O(1): every level is doubly linked.
+	SortedListMerge() re-inserts the nodes of src, O(m log(n + m)), and
+	SortedListParallelMerge() does the same on the calling thread.
+	SortedListFromArray() links each node after the last one of every
+	level, O(n) after the sort. SortedListInsertArray() merges its batch
+	like SortedListMerge().
+	SortedListInsertHint() ignores the hint, the search from the top level
+	is already expected O(log n).
+*/
+
+#include "sorted_linked_list.h" /* sorted_list_t API */
+
+#endif /* __ILRD_SKIP_LIST_H__ */
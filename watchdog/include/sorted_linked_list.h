@@ -2,6 +2,7 @@
 #define __ILRD_SORTED_LIST_H__
 #include <stddef.h> /* size_t */
 #include "d_linked_list.h"
+#include "allocator.h" /* allocator_t */
 
 typedef int (*sort_comparefunc_t)(const void *listdata, void *comparedata);
 typedef int (*sort_matchfunc_t)(const void *listdata, void *matchdata);
@@ -35,6 +36,45 @@ struct sorted_iterator
 */
 sorted_list_t *SortedListCreate(sort_comparefunc_t func);
 
+/*
+* DESCRIPTION:
+*   Same as SortedListCreate(), but the list and its nodes come from
+*   allocator. Lists can only be merged with lists that share it.
+*
+*   Time complexity: O(1)
+*   Space complexity: O(1)
+* 
+* PARAMS:
+*   allocator - where the memory comes from.
+*   func - Compare function to sort the list.
+*
+* RETURN:
+*   Reference to linkedlist type data structure. 
+*   NULL if fails.
+*/
+sorted_list_t *SortedListCreateWithAllocator(const allocator_t *allocator, sort_comparefunc_t func);
+
+/*
+* DESCRIPTION:
+*   Creates a sorted list holding the count elements of data, as if each
+*   one was inserted with SortedListInsert() in array order. The array is
+*   sorted in place, then the nodes are linked front to back in one pass,
+*   instead of the O(n^2) of n inserts.
+*
+*   Time complexity: O(n log n), O(n) when data is already sorted
+*   Space complexity: O(n)
+*
+* PARAMS:
+*   func:  Compare function to sort the list.
+*   data:  array of count elements, left sorted in list order.
+*   count: number of elements, may be 0.
+*
+* RETURN:
+*   Reference to the new list.
+*   NULL if fails.
+*/
+sorted_list_t *SortedListFromArray(sort_comparefunc_t func, void **data, size_t count);
+
 /*
 * DESCRIPTION:
 *   Destroys the list, unlinks all the nodes and frees their memory.
@@ -70,6 +110,8 @@ void *SortedListGetData(sorted_iter_t iterator);
 * DESCRIPTION:
 *   Inserts new element to the sorted list in the right place,
 *   according to the order dictated by the compare function of the list.
+*   The place is searched from both ends at once, so inserting next to the
+*   first or the last element is O(1).
 *
 *   Time complexity: O(n)
 *   Space Complexity: O(1)
@@ -83,6 +125,62 @@ void *SortedListGetData(sorted_iter_t iterator);
 */
 sorted_iter_t SortedListInsert(sorted_list_t *list, void *data);
 
+/*
+* DESCRIPTION:
+*   Same as SortedListInsert(), but the place is searched from hint, in
+*   whichever direction data lies. A hint next to the place, such as the
+*   iterator of the previous insert of a close value, makes it O(1).
+*
+*   Time complexity: O(distance from hint to the place)
+*   Space Complexity: O(1)
+*
+* PARAMS:
+*	list: pointer to the list to be altered.
+*	hint: iterator of list where to start, may be SortedListEnd().
+* 	data: new value to be inserted to list.
+*
+* RETURN:
+*	Returns iterator to the added iterator.
+*/
+sorted_iter_t SortedListInsertHint(sorted_list_t *list, sorted_iter_t hint, void *data);
+
+/*
+* DESCRIPTION:
+*   Same as SortedListInsert(), but the node is link, kept by the user
+*   inside the element, so nothing is allocated (see DLLInsertLinkBefore).
+*
+*   Time complexity: O(n)
+*   Space Complexity: O(1)
+*
+* PARAMS:
+*	list: pointer to the list to be altered.
+*	link: storage of the new node, not in any list.
+* 	data: new value to be inserted to list.
+*
+* RETURN:
+*	Returns iterator to the added iterator.
+*/
+sorted_iter_t SortedListInsertLink(sorted_list_t *list, dll_link_t *link, void *data);
+
+/*
+* DESCRIPTION:
+*   Inserts the count elements of data, same result as a SortedListInsert()
+*   of each one in array order. The batch is built as a list with
+*   SortedListFromArray(), then merged in with SortedListMerge().
+*
+*   Time complexity: O(m log m + n), m the count
+*   Space Complexity: O(m)
+*
+* PARAMS:
+*	list:  pointer to the list to be altered.
+*	data:  array of count elements, left sorted in list order.
+*	count: number of elements, may be 0.
+*
+* RETURN:
+*	0 on success, non zero on failure, then list is left as is.
+*/
+int SortedListInsertArray(sorted_list_t *list, void **data, size_t count);
+
 /*
 * DESCRIPTION:
 *   Remove element from linkedlist.
@@ -91,18 +189,37 @@ sorted_iter_t SortedListInsert(sorted_list_t *list, void *data);
 *   Space Complexity: O(1)
 *
 * PARAMS:
+*   list:       list the element belongs to.
 *   iterator:   Iterator of the element to remove.
 *
 * RETURN:
 *   Returns an iterator to the position after the removed node.
 */
-sorted_iter_t SortedListRemove(sorted_iter_t iterator);
+sorted_iter_t SortedListRemove(sorted_list_t *list, sorted_iter_t iterator);
+
+/*
+* DESCRIPTION:
+*   Moves the element of iterator to its place, after it was changed in a
+*   way that alters its order. The node itself is relinked, so nothing is
+*   allocated and iterator stays valid.
+*
+*   Time complexity: O(n), the distance moved
+*   Space Complexity: O(1)
+*
+* PARAMS:
+*   list:       list the element belongs to.
+*   iterator:   Iterator of the element to move.
+*
+* RETURN:
+*   Returns iterator.
+*/
+sorted_iter_t SortedListResort(sorted_list_t *list, sorted_iter_t iterator);
 
 /*
 * DESCRIPTION:
 *   Returns number of items in list.
 *
-*   Time complexity: O(n)
+*   Time complexity: O(1)
 *   Space Complexity: O(1)
 *
 * PARAMS:
@@ -283,6 +400,25 @@ int IsSortedListIterEqual(sorted_iter_t iterator1, sorted_iter_t iterator2);
 *   None.
 */
 void SortedListMerge(sorted_list_t *dest, sorted_list_t *src);
+
+/*
+* DESCRIPTION:
+*   Same result as SortedListMerge(). Both lists are walked once into
+*   arrays of their nodes, then each thread merges its part of the two
+*   arrays (split by binary search, so the parts are the same size) and
+*   relinks its part of the result.
+*   Falls back to SortedListMerge() when the arrays cannot be allocated.
+*   Time complexity: O(n) walk + O((n + m) / threads) merge
+*   Space complexity: O(n + m)
+* PARAMS:
+*   dest: Pointer to the destination sorted list.
+*   src: Pointer to the source sorted list.
+*   threads: number of threads, 0 for ParallelThreads().
+*
+* RETURN:
+*   None.
+*/
+void SortedListParallelMerge(sorted_list_t *dest, sorted_list_t *src, size_t threads);
 /*
 
 * DESCRIPTION:
@@ -10,6 +10,8 @@
 #include <time.h>   /* time_t       */
 
 #include "uid.h"    /* ilrd_uid_t   */
+#include "d_linked_list.h" /* dll_link_t */
+#include "allocator.h" /* allocator_t */
 
 typedef struct task task_t;
 
@@ -24,6 +26,10 @@ struct task
     time_t start_run_time;        /* the time in time_t the task shall be executed*/
     size_t frequency;             /* time between iterations*/
     ilrd_uid_t uid;
+    size_t queue_handle;          /* slot in the scheduler queue, 0 if out */
+    dll_link_t queue_link;        /* node of the task in a linked queue */
+    int is_cancelled;             /* tombstone, waiting to be dropped */
+    const allocator_t *allocator; /* the task was allocated from */
 };
 
 
@@ -48,6 +54,29 @@ struct task
 task_t *TaskCreate(task_func_t taskfunc, clean_func_t clean_func
                         , void *task_params, time_t start_run_time, time_t frequency);
 
+/*
+ * DESCRIPTION:
+ *   Same as TaskCreate(), but the task comes from allocator.
+ *   
+ *   Time complexity:   O(1)
+ *   Space complexity:  O(1)
+ * 
+ * PARAMS:
+ *   allocator         - where the memory comes from.
+ *   task_function     - reference to task.
+ *   clean_func        - reference to clean function   
+ *   task_params       - params for the action func
+ *   start_run_time    - the time until the task needs to be executed
+ *   frequency         - time between iterations
+ *
+ * RETURN:
+ *   A reference to the task, NULL if failed.
+ *
+ */
+task_t *TaskCreateWithAllocator(const allocator_t *allocator, task_func_t taskfunc, 
+                        clean_func_t clean_func, void *task_params, 
+                        time_t start_run_time, time_t frequency);
+
 /*
  * DESCRIPTION:
  *   The function cleans the memory
@@ -65,6 +94,40 @@ task_t *TaskCreate(task_func_t taskfunc, clean_func_t clean_func
  */
 void TaskDestroy(task_t *task);
 
+/*
+ * DESCRIPTION:
+ *   Cancels the task without unlinking it from its queue: runs its
+ *   clean function and marks it dead. TaskDestroy() on a cancelled
+ *   task only frees it.
+ *   
+ *   Time complexity:   O(1)
+ *   Space complexity:  O(1)
+ * 
+ * PARAMS:
+ *   task - A reference to the task to be cancelled.
+ *
+ * RETURN:
+ *   None.
+ *
+ */
+void TaskCancel(task_t *task);
+
+/*
+ * DESCRIPTION:
+ *   Was the task cancelled ?
+ *   
+ *   Time complexity:   O(1)
+ *   Space complexity:  O(1)
+ * 
+ * PARAMS:
+ *   task - reference to task.
+ *
+ * RETURN:
+ *   1 if cancelled, 0 otherwise.
+ *
+ */
+int IsTaskCancelled(const task_t *task);
+
 /*
  * DESCRIPTION:
  *   The function returns the uid of the task.
@@ -189,6 +252,52 @@ void TaskSetFrequency(task_t *task, int new_frequency);
  */
 void TaskSetStartTime(task_t *task, time_t new_time_to_set);
 
+/* 
+ * DESCRIPTION:
+ *   The function returns the handle of the task in its queue.
+ *   
+ *   Time complexity  O(1)
+ *   Space complexity O(1)
+ * 
+ * PARAMS:
+ *   task - reference to task.
+ *  
+ * RETURN:
+ *   The handle, 0 if the task is not queued.
+ */
+size_t TaskGetQueueHandle(task_t *task);
+
+/* 
+ * DESCRIPTION:
+ *   The function sets the handle of the task in its queue.
+ *   
+ *   Time complexity  O(1)
+ *   Space complexity O(1)
+ * 
+ * PARAMS:
+ *   task - reference to task.
+ *   handle - new handle to set   
+ * RETURN:
+ *   void
+ */
+void TaskSetQueueHandle(task_t *task, size_t handle);
+
+/* 
+ * DESCRIPTION:
+ *   The function returns the storage for the links of the task in a
+ *   queue that links its elements (see PQueueCreateIntrusive).
+ *   
+ *   Time complexity  O(1)
+ *   Space complexity O(1)
+ * 
+ * PARAMS:
+ *   task - reference to task.
+ *  
+ * RETURN:
+ *   The links storage of the task.
+ */
+dll_link_t *TaskGetQueueLink(task_t *task);
+
 
 #endif /* __ILRD_TASK_H__ */
 
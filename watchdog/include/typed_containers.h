@@ -0,0 +1,539 @@
+/*
+	Coder : Josh Benichou
+	Date : 02/07/2023
+	Reviewer : *****
+*/
+
+#ifndef __ILRD_TYPED_CONTAINERS_H__
+#define __ILRD_TYPED_CONTAINERS_H__
+
+/*
+	Type specialized vector, heap and priority queue generators.
+
+	vector_t and heap_t store untyped elements and compare them through a
+	function pointer. The containers below are generated for one element
+	type instead: elements are stored by value, sizeof(T) is a compile
+	time constant and the comparison is a macro, so it inlines down to a
+	plain compare of the keys.
+
+	Every function is static, each translation unit gets its own copy.
+	Use at file scope, followed by a semicolon:
+
+		#define TIMER_LESS(lhs, rhs) ((lhs).deadline < (rhs).deadline)
+		DEFINE_PQ(TimerQueue, bench_timer_t, TIMER_LESS);
+
+		TimerQueue_t *queue = TimerQueueCreate();
+		TimerQueueEnqueue(queue, timer);
+
+	LESS(lhs, rhs) is true when lhs must come out before rhs.
+*/
+
+#include <stddef.h> /* size_t */
+#include <assert.h> /* assert */
+
+#include "allocator.h" /* AllocatorAlloc AllocatorRealloc AllocatorFree */
+
+/* handle given to an element that is not (or no longer) in a typed heap */
+#define TYPED_NO_HANDLE (0)
+
+/* move hook of heaps whose elements do not track their handle */
+#define TYPED_NO_MOVE_HOOK(context, element, handle)
+
+#ifdef __GNUC__
+	#define TYPED_FUNC static __inline__ __attribute__((unused))
+#else
+	#define TYPED_FUNC static
+#endif
+
+/*
+ * DESCRIPTION:
+ *  Generates name_t, a vector of T, with the default policies of vector_t:
+ *  doubles when full, halves when a pop leaves it a quarter full, never
+ *  below its initial capacity.
+ *
+ *  name_t *nameCreate(size_t init_capacity);     NULL on failure
+ *  name_t *nameCreateWithAllocator(const allocator_t *allocator,
+ *                                  size_t init_capacity);
+ *  void nameDestroy(name_t *vector);
+ *  int nameReserve(name_t *vector, size_t new_capacity);  0 on success
+ *  int namePushBack(name_t *vector, T value);    0 on success
+ *  void namePopBack(name_t *vector);
+ *  T *nameAt(const name_t *vector, size_t index);
+ *  size_t nameSize(const name_t *vector);
+ *  size_t nameCapacity(const name_t *vector);
+ *
+ * PARAMS:
+ *  name:   prefix of the generated type and functions.
+ *  T:      element type, copied by assignment.
+ */
+#define DEFINE_VECTOR(name, T)                                                  \
+typedef struct name##_struct                                                    \
+{                                                                               \
+    T *base;                                                                    \
+    size_t size;                                                                \
+    size_t capacity;                                                            \
+    size_t min_capacity;                                                        \
+    const allocator_t *allocator;                                               \
+} name##_t;                                                                     \
+                                                                                \
+TYPED_FUNC name##_t *name##CreateWithAllocator(const allocator_t *allocator,    \
+                                                    size_t init_capacity)       \
+{                                                                               \
+    name##_t *vector = NULL;                                                    \
+                                                                                \
+    assert(NULL != allocator);                                                  \
+                                                                                \
+    vector = (name##_t *)AllocatorAlloc(allocator, sizeof(name##_t), 0);        \
+    if (NULL == vector)                                                         \
+    {                                                                           \
+        return NULL;                                                            \
+    }                                                                           \
+                                                                                \
+    init_capacity = 0 == init_capacity ? 1 : init_capacity;                     \
+                                                                                \
+    vector->base = (T *)AllocatorAlloc(allocator,                               \
+                                        init_capacity * sizeof(T), 0);          \
+    if (NULL == vector->base)                                                   \
+    {                                                                           \
+        AllocatorFree(allocator, vector, sizeof(name##_t), 0);                  \
+        return NULL;                                                            \
+    }                                                                           \
+                                                                                \
+    vector->size = 0;                                                           \
+    vector->capacity = init_capacity;                                           \
+    vector->min_capacity = init_capacity;                                       \
+    vector->allocator = allocator;                                              \
+                                                                                \
+    return vector;                                                              \
+}                                                                               \
+                                                                                \
+TYPED_FUNC name##_t *name##Create(size_t init_capacity)                         \
+{                                                                               \
+    return name##CreateWithAllocator(AllocatorGetDefault(), init_capacity);     \
+}                                                                               \
+                                                                                \
+TYPED_FUNC void name##Destroy(name##_t *vector)                                 \
+{                                                                               \
+    assert(NULL != vector);                                                     \
+                                                                                \
+    AllocatorFree(vector->allocator, vector->base,                              \
+                                    vector->capacity * sizeof(T), 0);           \
+    vector->base = NULL;                                                        \
+                                                                                \
+    AllocatorFree(vector->allocator, vector, sizeof(name##_t), 0);              \
+}                                                                               \
+                                                                                \
+TYPED_FUNC int name##Reserve(name##_t *vector, size_t new_capacity)             \
+{                                                                               \
+    T *new_base = NULL;                                                         \
+                                                                                \
+    assert(NULL != vector);                                                     \
+                                                                                \
+    if (new_capacity < vector->size || 0 == new_capacity)                       \
+    {                                                                           \
+        return 1;                                                               \
+    }                                                                           \
+                                                                                \
+    new_base = (T *)AllocatorRealloc(vector->allocator, vector->base,           \
+                    vector->capacity * sizeof(T), new_capacity * sizeof(T));    \
+    if (NULL == new_base)                                                       \
+    {                                                                           \
+        return 1;                                                               \
+    }                                                                           \
+                                                                                \
+    vector->base = new_base;                                                    \
+    vector->capacity = new_capacity;                                            \
+                                                                                \
+    return 0;                                                                   \
+}                                                                               \
+                                                                                \
+TYPED_FUNC int name##PushBack(name##_t *vector, T value)                        \
+{                                                                               \
+    assert(NULL != vector);                                                     \
+                                                                                \
+    if (vector->size == vector->capacity &&                                     \
+                0 != name##Reserve(vector, vector->capacity * 2))               \
+    {                                                                           \
+        return 1;                                                               \
+    }                                                                           \
+                                                                                \
+    vector->base[vector->size++] = value;                                       \
+                                                                                \
+    return 0;                                                                   \
+}                                                                               \
+                                                                                \
+TYPED_FUNC void name##PopBack(name##_t *vector)                                 \
+{                                                                               \
+    assert(NULL != vector);                                                     \
+                                                                                \
+    if (0 == vector->size)                                                      \
+    {                                                                           \
+        return;                                                                 \
+    }                                                                           \
+                                                                                \
+    --vector->size;                                                             \
+                                                                                \
+    if (vector->capacity / 2 >= vector->min_capacity &&                         \
+                vector->size <= vector->capacity / 4)                           \
+    {                                                                           \
+        /* a failed shrink only keeps the spare room */                         \
+        name##Reserve(vector, vector->capacity / 2);                            \
+    }                                                                           \
+}                                                                               \
+                                                                                \
+TYPED_FUNC T *name##At(const name##_t *vector, size_t index)                    \
+{                                                                               \
+    assert(NULL != vector);                                                     \
+    assert(index < vector->size);                                               \
+                                                                                \
+    return vector->base + index;                                                \
+}                                                                               \
+                                                                                \
+TYPED_FUNC size_t name##Size(const name##_t *vector)                            \
+{                                                                               \
+    assert(NULL != vector);                                                     \
+                                                                                \
+    return vector->size;                                                        \
+}                                                                               \
+                                                                                \
+TYPED_FUNC size_t name##Capacity(const name##_t *vector)                        \
+{                                                                               \
+    assert(NULL != vector);                                                     \
+                                                                                \
+    return vector->capacity;                                                    \
+}                                                                               \
+                                                                                \
+extern int name##_typed_vector_
+
+/*
+ * DESCRIPTION:
+ *  Generates name_t, a binary heap of T stored by value. The element for
+ *  which LESS(other, element) is never true sits at the top.
+ *
+ *  Every time an element lands in a new slot, ON_MOVE(context, element,
+ *  handle) is expanded, and with TYPED_NO_HANDLE once it leaves the heap.
+ *  The user keeps handle to give it back to nameUpdate() / nameErase().
+ *  Heaps that do not need it pass TYPED_NO_MOVE_HOOK.
+ *
+ *  name_t *nameCreate(void *context);            NULL on failure
+ *  name_t *nameCreateWithAllocator(const allocator_t *allocator,
+ *                                  void *context);
+ *  void nameDestroy(name_t *heap);
+ *  int namePush(name_t *heap, T data);           0 on success
+ *  T namePop(name_t *heap);                      heap must not be empty
+ *  T namePeek(const name_t *heap);               heap must not be empty
+ *  size_t nameSize(const name_t *heap);
+ *  int nameIsEmpty(const name_t *heap);
+ *  void nameUpdate(name_t *heap, size_t handle); after changing its key
+ *  T nameErase(name_t *heap, size_t handle);
+ *  T *nameArray(const name_t *heap);             element of handle h at h - 1
+ *  void nameRebuild(name_t *heap, size_t new_size);
+ *      restores the heap after the user rewrote the first new_size
+ *      elements of nameArray(), drops the rest.
+ *
+ * PARAMS:
+ *  name:       prefix of the generated type and functions.
+ *  T:          element type, copied by assignment.
+ *  LESS:       LESS(lhs, rhs) macro or function taking two T.
+ *  ON_MOVE:    ON_MOVE(context, element, handle) macro or function.
+ */
+#define DEFINE_HEAP(name, T, LESS, ON_MOVE)                                     \
+DEFINE_VECTOR(name##Storage, T);                                                \
+                                                                                \
+typedef struct name##_struct                                                    \
+{                                                                               \
+    name##Storage_t *storage;                                                   \
+    void *context;                                                              \
+} name##_t;                                                                     \
+                                                                                \
+TYPED_FUNC name##_t *name##CreateWithAllocator(const allocator_t *allocator,    \
+                                                            void *context)      \
+{                                                                               \
+    name##_t *heap = NULL;                                                      \
+                                                                                \
+    assert(NULL != allocator);                                                  \
+                                                                                \
+    heap = (name##_t *)AllocatorAlloc(allocator, sizeof(name##_t), 0);          \
+    if (NULL == heap)                                                           \
+    {                                                                           \
+        return NULL;                                                            \
+    }                                                                           \
+                                                                                \
+    heap->storage = name##StorageCreateWithAllocator(allocator, 1);             \
+    if (NULL == heap->storage)                                                  \
+    {                                                                           \
+        AllocatorFree(allocator, heap, sizeof(name##_t), 0);                    \
+        return NULL;                                                            \
+    }                                                                           \
+                                                                                \
+    heap->context = context;                                                    \
+                                                                                \
+    return heap;                                                                \
+}                                                                               \
+                                                                                \
+TYPED_FUNC name##_t *name##Create(void *context)                                \
+{                                                                               \
+    return name##CreateWithAllocator(AllocatorGetDefault(), context);           \
+}                                                                               \
+                                                                                \
+TYPED_FUNC void name##Destroy(name##_t *heap)                                   \
+{                                                                               \
+    const allocator_t *allocator = NULL;                                        \
+                                                                                \
+    assert(NULL != heap);                                                       \
+                                                                                \
+    allocator = heap->storage->allocator;                                       \
+    name##StorageDestroy(heap->storage);                                        \
+    heap->storage = NULL;                                                       \
+                                                                                \
+    AllocatorFree(allocator, heap, sizeof(name##_t), 0);                        \
+}                                                                               \
+                                                                                \
+TYPED_FUNC size_t name##Size(const name##_t *heap)                              \
+{                                                                               \
+    assert(NULL != heap);                                                       \
+                                                                                \
+    return heap->storage->size;                                                 \
+}                                                                               \
+                                                                                \
+TYPED_FUNC int name##IsEmpty(const name##_t *heap)                              \
+{                                                                               \
+    assert(NULL != heap);                                                       \
+                                                                                \
+    return 0 == heap->storage->size;                                            \
+}                                                                               \
+                                                                                \
+TYPED_FUNC T *name##Array(const name##_t *heap)                                 \
+{                                                                               \
+    assert(NULL != heap);                                                       \
+                                                                                \
+    return heap->storage->base;                                                 \
+}                                                                               \
+                                                                                \
+TYPED_FUNC T name##Peek(const name##_t *heap)                                   \
+{                                                                               \
+    assert(NULL != heap);                                                       \
+    assert(0 < heap->storage->size);                                            \
+                                                                                \
+    return heap->storage->base[0];                                              \
+}                                                                               \
+                                                                                \
+TYPED_FUNC void name##SiftUp(name##_t *heap, size_t hole, T data)               \
+{                                                                               \
+    T *array = heap->storage->base;                                             \
+    size_t parent = 0;                                                          \
+                                                                                \
+    for (; 0 < hole; hole = parent)                                             \
+    {                                                                           \
+        parent = (hole - 1) / 2;                                                \
+        if (!(LESS(data, array[parent])))                                       \
+        {                                                                       \
+            break;                                                              \
+        }                                                                       \
+                                                                                \
+        array[hole] = array[parent];                                            \
+        ON_MOVE(heap->context, array[hole], hole + 1);                          \
+    }                                                                           \
+                                                                                \
+    array[hole] = data;                                                         \
+    ON_MOVE(heap->context, array[hole], hole + 1);                              \
+}                                                                               \
+                                                                                \
+TYPED_FUNC void name##SiftDown(name##_t *heap, size_t hole, T data)             \
+{                                                                               \
+    T *array = heap->storage->base;                                             \
+    size_t size = heap->storage->size;                                          \
+    size_t child = 0;                                                           \
+                                                                                \
+    for (child = 2 * hole + 1; child < size; child = 2 * hole + 1)              \
+    {                                                                           \
+        if (child + 1 < size && LESS(array[child + 1], array[child]))           \
+        {                                                                       \
+            ++child;                                                            \
+        }                                                                       \
+        if (!(LESS(array[child], data)))                                        \
+        {                                                                       \
+            break;                                                              \
+        }                                                                       \
+                                                                                \
+        array[hole] = array[child];                                             \
+        ON_MOVE(heap->context, array[hole], hole + 1);                          \
+        hole = child;                                                           \
+    }                                                                           \
+                                                                                \
+    array[hole] = data;                                                         \
+    ON_MOVE(heap->context, array[hole], hole + 1);                              \
+}                                                                               \
+                                                                                \
+/* Floyd : the hole goes down to a leaf, data then climbs back from it */       \
+TYPED_FUNC void name##SiftDownBottomUp(name##_t *heap, size_t hole, T data)     \
+{                                                                               \
+    T *array = heap->storage->base;                                             \
+    size_t size = heap->storage->size;                                          \
+    size_t child = 0;                                                           \
+                                                                                \
+    for (child = 2 * hole + 1; child < size; child = 2 * hole + 1)              \
+    {                                                                           \
+        if (child + 1 < size && LESS(array[child + 1], array[child]))           \
+        {                                                                       \
+            ++child;                                                            \
+        }                                                                       \
+                                                                                \
+        array[hole] = array[child];                                             \
+        ON_MOVE(heap->context, array[hole], hole + 1);                          \
+        hole = child;                                                           \
+    }                                                                           \
+                                                                                \
+    name##SiftUp(heap, hole, data);                                             \
+}                                                                               \
+                                                                                \
+TYPED_FUNC int name##Push(name##_t *heap, T data)                               \
+{                                                                               \
+    assert(NULL != heap);                                                       \
+                                                                                \
+    if (0 != name##StoragePushBack(heap->storage, data))                        \
+    {                                                                           \
+        return 1;                                                               \
+    }                                                                           \
+                                                                                \
+    name##SiftUp(heap, heap->storage->size - 1, data);                          \
+                                                                                \
+    return 0;                                                                   \
+}                                                                               \
+                                                                                \
+TYPED_FUNC T name##Erase(name##_t *heap, size_t handle)                         \
+{                                                                               \
+    T erased;                                                                   \
+    T last;                                                                     \
+                                                                                \
+    assert(NULL != heap);                                                       \
+    assert(TYPED_NO_HANDLE != handle);                                          \
+    assert(handle <= heap->storage->size);                                      \
+                                                                                \
+    erased = heap->storage->base[handle - 1];                                   \
+    last = heap->storage->base[heap->storage->size - 1];                        \
+    name##StoragePopBack(heap->storage);                                        \
+                                                                                \
+    if (handle - 1 < heap->storage->size)                                       \
+    {                                                                           \
+        name##SiftDownBottomUp(heap, handle - 1, last);                         \
+    }                                                                           \
+    ON_MOVE(heap->context, erased, TYPED_NO_HANDLE);                            \
+                                                                                \
+    return erased;                                                              \
+}                                                                               \
+                                                                                \
+TYPED_FUNC T name##Pop(name##_t *heap)                                          \
+{                                                                               \
+    assert(NULL != heap);                                                       \
+    assert(0 < heap->storage->size);                                            \
+                                                                                \
+    return name##Erase(heap, 1);                                                \
+}                                                                               \
+                                                                                \
+TYPED_FUNC void name##Update(name##_t *heap, size_t handle)                     \
+{                                                                               \
+    T *array = NULL;                                                            \
+    size_t index = handle - 1;                                                  \
+                                                                                \
+    assert(NULL != heap);                                                       \
+    assert(TYPED_NO_HANDLE != handle);                                          \
+    assert(handle <= heap->storage->size);                                      \
+                                                                                \
+    array = heap->storage->base;                                                \
+    if (0 < index && LESS(array[index], array[(index - 1) / 2]))                \
+    {                                                                           \
+        name##SiftUp(heap, index, array[index]);                                \
+    }                                                                           \
+    else                                                                        \
+    {                                                                           \
+        name##SiftDown(heap, index, array[index]);                              \
+    }                                                                           \
+}                                                                               \
+                                                                                \
+TYPED_FUNC void name##Rebuild(name##_t *heap, size_t new_size)                  \
+{                                                                               \
+    size_t index = 0;                                                           \
+                                                                                \
+    assert(NULL != heap);                                                       \
+    assert(new_size <= heap->storage->size);                                    \
+                                                                                \
+    while (new_size < heap->storage->size)                                      \
+    {                                                                           \
+        name##StoragePopBack(heap->storage);                                    \
+    }                                                                           \
+                                                                                \
+    for (index = new_size / 2; 0 < index; --index)                              \
+    {                                                                           \
+        name##SiftDown(heap, index - 1, heap->storage->base[index - 1]);        \
+    }                                                                           \
+                                                                                \
+    for (index = 0; index < new_size; ++index)                                  \
+    {                                                                           \
+        ON_MOVE(heap->context, heap->storage->base[index], index + 1);          \
+    }                                                                           \
+}                                                                               \
+                                                                                \
+extern int name##_typed_heap_
+
+/*
+ * DESCRIPTION:
+ *  Generates name_t, a priority queue of T backed by DEFINE_HEAP. The
+ *  element for which LESS(other, element) is never true comes out first.
+ *
+ *  name_t *nameCreate(void);                     NULL on failure
+ *  void nameDestroy(name_t *queue);
+ *  int nameEnqueue(name_t *queue, T data);       0 on success
+ *  T nameDequeue(name_t *queue);                 queue must not be empty
+ *  T namePeek(const name_t *queue);              queue must not be empty
+ *  size_t nameSize(const name_t *queue);
+ *  int nameIsEmpty(const name_t *queue);
+ *
+ * PARAMS:
+ *  name:   prefix of the generated type and functions.
+ *  T:      element type, copied by assignment.
+ *  LESS:   LESS(lhs, rhs) macro or function taking two T.
+ */
+#define DEFINE_PQ(name, T, LESS)                                                \
+DEFINE_HEAP(name##Heap, T, LESS, TYPED_NO_MOVE_HOOK);                           \
+                                                                                \
+typedef name##Heap_t name##_t;                                                  \
+                                                                                \
+TYPED_FUNC name##_t *name##Create(void)                                         \
+{                                                                               \
+    return name##HeapCreate(NULL);                                              \
+}                                                                               \
+                                                                                \
+TYPED_FUNC void name##Destroy(name##_t *queue)                                  \
+{                                                                               \
+    name##HeapDestroy(queue);                                                   \
+}                                                                               \
+                                                                                \
+TYPED_FUNC int name##Enqueue(name##_t *queue, T data)                           \
+{                                                                               \
+    return name##HeapPush(queue, data);                                         \
+}                                                                               \
+                                                                                \
+TYPED_FUNC T name##Dequeue(name##_t *queue)                                     \
+{                                                                               \
+    return name##HeapPop(queue);                                                \
+}                                                                               \
+                                                                                \
+TYPED_FUNC T name##Peek(const name##_t *queue)                                  \
+{                                                                               \
+    return name##HeapPeek(queue);                                               \
+}                                                                               \
+                                                                                \
+TYPED_FUNC size_t name##Size(const name##_t *queue)                             \
+{                                                                               \
+    return name##HeapSize(queue);                                               \
+}                                                                               \
+                                                                                \
+TYPED_FUNC int name##IsEmpty(const name##_t *queue)                             \
+{                                                                               \
+    return name##HeapIsEmpty(queue);                                            \
+}                                                                               \
+                                                                                \
+extern int name##_typed_pq_
+
+#endif /* __ILRD_TYPED_CONTAINERS_H__ */
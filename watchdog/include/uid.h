@@ -6,6 +6,12 @@
 
 typedef struct uid ilrd_uid_t;
 
+/* a UID in one word, see UIDPack() */
+typedef unsigned long uid_packed_t;
+
+/* bits of the packed form that hold the counter, the pid is above them */
+#define UID_COUNTER_BITS (42)
+
 struct uid
 {
     size_t counter;
@@ -15,7 +21,12 @@ struct uid
 
 /*
  * DESCRIPTION:
- *  Generates a UID.
+ *  Generates a UID. Thread safe: each thread takes counters from a
+ *  shared atomic counter a block at a time, so UIDs are unique, but the
+ *  UIDs of different threads are not in the order they were made.
+ *  No system call is made, the pid and the time are read once per
+ *  process, and read again in the child after a fork() (not after a raw
+ *  clone or vfork).
  * 
  * TIME COMPLEXITY: 
  *  O(1)
@@ -72,4 +83,46 @@ int IsSameUID(ilrd_uid_t uid1, ilrd_uid_t uid2);
  */
 ilrd_uid_t GetBadUID(void);
 
+/*
+ * DESCRIPTION:
+ *  Packs a UID in one word: the pid above the low UID_COUNTER_BITS bits
+ *  of the counter. The time is left out, so two packed UIDs are the same
+ *  only if made by the same pid; unique among the UIDs of processes
+ *  alive at the same time, as long as one process does not make
+ *  2^UID_COUNTER_BITS of them. The bad UID packs to 0.
+ * 
+ * TIME COMPLEXITY: 
+ *  O(1)
+ * 
+ * SPACE COMPLEXITY: 
+ *  O(1)
+ * 
+ * PARAMS:
+ *  uid-    UID to pack.
+ *
+ * RETURN:
+ *  The packed UID.
+ */
+uid_packed_t UIDPack(ilrd_uid_t uid);
+
+/*
+ * DESCRIPTION:
+ *  Hash of a UID, for hash tables. Mixes all of the bits of its packed
+ *  form, so the low bits can index a table of a power of two size.
+ *  Same UIDs have the same hash.
+ * 
+ * TIME COMPLEXITY: 
+ *  O(1)
+ * 
+ * SPACE COMPLEXITY: 
+ *  O(1)
+ * 
+ * PARAMS:
+ *  uid-    UID to hash.
+ *
+ * RETURN:
+ *  The hash.
+ */
+size_t UIDHash(ilrd_uid_t uid);
+
 #endif /* __UID_H__ */
\ No newline at end of file
@@ -0,0 +1,172 @@
+#ifndef __ILRD_UID_MAP_H__
+#define __ILRD_UID_MAP_H__
+
+#include <stddef.h> /* size_t */
+
+#include "uid.h" /* ilrd_uid_t */
+#include "allocator.h" /* allocator_t */
+
+/*
+	Open addressing hash map from ilrd_uid_t to void *.
+	Each slot has a control byte: empty, deleted, or 7 bits of the hash
+	of its key. The bytes of a group of 8 slots are read as one word and
+	matched all at once, so a probe compares keys only in slots whose 7
+	bits match, and stops at the first group with an empty slot.
+	Growing moves the old table a few groups per insert / remove instead
+	of all at once, while both tables are searched. No call rehashes more
+	than a handful of groups.
+*/
+
+typedef struct uid_map uid_map_t;
+
+/*
+ * DESCRIPTION:
+ *  Creates an empty map with room for capacity keys before it grows.
+ * 
+ * TIME COMPLEXITY: 
+ *  O(capacity)
+ * 
+ * SPACE COMPLEXITY: 
+ *  O(capacity)
+ * 
+ * PARAMS:
+ *  capacity:   number of keys expected, may be 0.
+ *
+ * RETURN:
+ *  Pointer to the new map, NULL on failure.
+ */
+uid_map_t *UIDMapCreate(size_t capacity);
+
+/*
+ * DESCRIPTION:
+ *  Same as UIDMapCreate(), but the map and its tables come from allocator.
+ * 
+ * TIME COMPLEXITY: 
+ *  O(capacity)
+ * 
+ * SPACE COMPLEXITY: 
+ *  O(capacity)
+ * 
+ * PARAMS:
+ *  allocator:  where the memory comes from.
+ *  capacity:   number of keys expected, may be 0.
+ *
+ * RETURN:
+ *  Pointer to the new map, NULL on failure.
+ */
+uid_map_t *UIDMapCreateWithAllocator(const allocator_t *allocator, size_t capacity);
+
+/*
+ * DESCRIPTION:
+ *  Frees the map. The values are not touched.
+ * 
+ * TIME COMPLEXITY: 
+ *  O(1)
+ * 
+ * SPACE COMPLEXITY: 
+ *  O(1)
+ * 
+ * PARAMS:
+ *  map:    map to be destroyed.
+ *
+ * RETURN:
+ *  None.
+ */
+void UIDMapDestroy(uid_map_t *map);
+
+/*
+ * DESCRIPTION:
+ *  Maps key to value. If key is already in the map, its value is
+ *  replaced.
+ * 
+ * TIME COMPLEXITY: 
+ *  O(1) expected
+ * 
+ * SPACE COMPLEXITY: 
+ *  O(1) amortized
+ * 
+ * PARAMS:
+ *  map:    map to be altered.
+ *  key:    UID to map.
+ *  value:  value of key.
+ *
+ * RETURN:
+ *  0 on success, non zero when the map is full and cannot grow.
+ */
+int UIDMapInsert(uid_map_t *map, ilrd_uid_t key, void *value);
+
+/*
+ * DESCRIPTION:
+ *  Looks key up.
+ * 
+ * TIME COMPLEXITY: 
+ *  O(1) expected
+ * 
+ * SPACE COMPLEXITY: 
+ *  O(1)
+ * 
+ * PARAMS:
+ *  map:    map to be searched.
+ *  key:    UID to look up.
+ *
+ * RETURN:
+ *  The value of key, NULL if key is not in the map.
+ */
+void *UIDMapFind(const uid_map_t *map, ilrd_uid_t key);
+
+/*
+ * DESCRIPTION:
+ *  Removes key from the map.
+ * 
+ * TIME COMPLEXITY: 
+ *  O(1) expected
+ * 
+ * SPACE COMPLEXITY: 
+ *  O(1)
+ * 
+ * PARAMS:
+ *  map:    map to be altered.
+ *  key:    UID to remove.
+ *
+ * RETURN:
+ *  The value key had, NULL if key was not in the map.
+ */
+void *UIDMapRemove(uid_map_t *map, ilrd_uid_t key);
+
+/*
+ * DESCRIPTION:
+ *  Removes all the keys, keeps the room for them.
+ * 
+ * TIME COMPLEXITY: 
+ *  O(capacity)
+ * 
+ * SPACE COMPLEXITY: 
+ *  O(1)
+ * 
+ * PARAMS:
+ *  map:    map to be altered.
+ *
+ * RETURN:
+ *  None.
+ */
+void UIDMapClear(uid_map_t *map);
+
+/*
+ * DESCRIPTION:
+ *  Returns the number of keys in the map.
+ * 
+ * TIME COMPLEXITY: 
+ *  O(1)
+ * 
+ * SPACE COMPLEXITY: 
+ *  O(1)
+ * 
+ * PARAMS:
+ *  map:    map to be evaluated.
+ *
+ * RETURN:
+ *  Number of keys.
+ */
+size_t UIDMapSize(const uid_map_t *map);
+
+#endif /* __ILRD_UID_MAP_H__ */
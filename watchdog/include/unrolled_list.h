@@ -0,0 +1,292 @@
+#ifndef __ILRD_UNROLLED_LIST_H__
+#define __ILRD_UNROLLED_LIST_H__
+
+#include <stddef.h> /* size_t */
+
+#include "allocator.h" /* allocator_t */
+
+/*
+ * Doubly linked list that keeps up to ULIST_NODE_SLOTS element pointers
+ * per node, so a walk touches one node per ULIST_NODE_SLOTS elements
+ * instead of one per element. Same operations as d_linked_list.h.
+ *
+ * Unlike a dll_iterator_t, an iterator is a position: any insert or
+ * remove in the list may move the elements of its node, and invalidates
+ * every iterator but the one it returns.
+ */
+
+/* element pointers per node, 8 to 32 is the useful range */
+#ifndef ULIST_NODE_SLOTS
+    #define ULIST_NODE_SLOTS (29)
+#endif
+
+typedef int (*ulist_matchfunc_t)(const void *list_data, void *match_data);
+typedef int (*ulist_actionfunc_t)(void *iterator_data, void *user_data);
+
+typedef struct ulist_node ulist_node_t;
+typedef struct unrolled_list ulist_t;
+
+typedef struct ulist_iterator
+{
+    ulist_node_t *node;
+    size_t index;
+} ulist_iter_t;
+
+/*
+ * DESCRIPTION:
+ *  Creates an empty unrolled list.
+ * 
+ * TIME COMPLEXITY: 
+ *  O(1)
+ * 
+ * SPACE COMPLEXITY: 
+ *  O(1)
+ * 
+ * PARAMS:
+ *  none
+ *
+ * RETURN:
+ *  Pointer to the new list, NULL on failure.
+ */
+ulist_t *UListCreate(void);
+
+/*
+ * DESCRIPTION:
+ *  Same as UListCreate(), but the list and its nodes come from allocator.
+ * 
+ * TIME COMPLEXITY: 
+ *  O(1)
+ * 
+ * SPACE COMPLEXITY: 
+ *  O(1)
+ * 
+ * PARAMS:
+ *  allocator:  where the memory comes from.
+ *
+ * RETURN:
+ *  Pointer to the new list, NULL on failure.
+ */
+ulist_t *UListCreateWithAllocator(const allocator_t *allocator);
+
+/*
+ * DESCRIPTION:
+ *  Frees the list and its nodes, not the elements.
+ * 
+ * TIME COMPLEXITY: 
+ *  O(n / ULIST_NODE_SLOTS)
+ * 
+ * SPACE COMPLEXITY: 
+ *  O(1)
+ * 
+ * PARAMS:
+ *  list:   list to be destroyed.
+ *
+ * RETURN:
+ *  None.
+ */
+void UListDestroy(ulist_t *list);
+
+/*
+ * DESCRIPTION:
+ *  Inserts data before iterator. A full node is split in two, unless
+ *  data goes at one of its ends and a new node can take it alone.
+ * 
+ * TIME COMPLEXITY: 
+ *  O(ULIST_NODE_SLOTS)
+ * 
+ * SPACE COMPLEXITY: 
+ *  O(1) amortized
+ * 
+ * PARAMS:
+ *  list:       list to be altered.
+ *  iterator:   position to insert at, may be UListEnd().
+ *  data:       element to insert.
+ *
+ * RETURN:
+ *  Iterator to the new element, UListEnd() on failure.
+ */
+ulist_iter_t UListInsertBefore(ulist_t *list, ulist_iter_t iterator, void *data);
+
+/*
+ * DESCRIPTION:
+ *  Removes the element of iterator. A node left less than half full
+ *  takes in the next one when they fit together.
+ * 
+ * TIME COMPLEXITY: 
+ *  O(ULIST_NODE_SLOTS)
+ * 
+ * SPACE COMPLEXITY: 
+ *  O(1)
+ * 
+ * PARAMS:
+ *  list:       list to be altered.
+ *  iterator:   element to remove, not UListEnd().
+ *
+ * RETURN:
+ *  Iterator to the element that followed the removed one.
+ */
+ulist_iter_t UListRemove(ulist_t *list, ulist_iter_t iterator);
+
+/*
+ * DESCRIPTION:
+ *  Same as UListInsertBefore(UListBegin()) / UListInsertBefore(UListEnd()).
+ * 
+ * TIME COMPLEXITY: 
+ *  O(ULIST_NODE_SLOTS) / O(1)
+ * 
+ * SPACE COMPLEXITY: 
+ *  O(1) amortized
+ * 
+ * PARAMS:
+ *  list:   list to be altered.
+ *  data:   element to insert.
+ *
+ * RETURN:
+ *  Iterator to the new element, UListEnd() on failure.
+ */
+ulist_iter_t UListPushFront(ulist_t *list, void *data);
+ulist_iter_t UListPushBack(ulist_t *list, void *data);
+
+/*
+ * DESCRIPTION:
+ *  Removes the first / last element.
+ * 
+ * TIME COMPLEXITY: 
+ *  O(ULIST_NODE_SLOTS) / O(1)
+ * 
+ * SPACE COMPLEXITY: 
+ *  O(1)
+ * 
+ * PARAMS:
+ *  list:   list to be altered.
+ *
+ * RETURN:
+ *  The removed element, NULL when the list is empty.
+ */
+void *UListPopFront(ulist_t *list);
+void *UListPopBack(ulist_t *list);
+
+/*
+ * DESCRIPTION:
+ *  Gives / replaces the element of iterator.
+ * 
+ * TIME COMPLEXITY: 
+ *  O(1)
+ * 
+ * SPACE COMPLEXITY: 
+ *  O(1)
+ * 
+ * PARAMS:
+ *  iterator:   element to access, not UListEnd().
+ *  data:       new element.
+ *
+ * RETURN:
+ *  The element / None.
+ */
+void *UListGetData(ulist_iter_t iterator);
+void UListSetData(ulist_iter_t iterator, void *data);
+
+/*
+ * DESCRIPTION:
+ *  Iterators to the first element and past the last one. Next of the last
+ *  element is UListEnd(), prev of the first one is before UListBegin().
+ * 
+ * TIME COMPLEXITY: 
+ *  O(1)
+ * 
+ * SPACE COMPLEXITY: 
+ *  O(1)
+ * 
+ * PARAMS:
+ *  list / iterator:    where to start from.
+ *
+ * RETURN:
+ *  The iterator.
+ */
+ulist_iter_t UListBegin(const ulist_t *list);
+ulist_iter_t UListEnd(const ulist_t *list);
+ulist_iter_t UListNext(ulist_iter_t iterator);
+ulist_iter_t UListPrev(ulist_iter_t iterator);
+
+/*
+ * DESCRIPTION:
+ *  Returns the number of elements, kept up to date by every operation.
+ * 
+ * TIME COMPLEXITY: 
+ *  O(1)
+ * 
+ * SPACE COMPLEXITY: 
+ *  O(1)
+ * 
+ * PARAMS:
+ *  list:   list to be evaluated.
+ *
+ * RETURN:
+ *  Number of elements / 1 if there are none, 0 otherwise.
+ */
+size_t UListSize(const ulist_t *list);
+int IsUListEmpty(const ulist_t *list);
+
+/*
+ * DESCRIPTION:
+ *  1 when both iterators are the same position.
+ * 
+ * TIME COMPLEXITY: 
+ *  O(1)
+ * 
+ * SPACE COMPLEXITY: 
+ *  O(1)
+ * 
+ * PARAMS:
+ *  iterator1, iterator2:   iterators to compare.
+ *
+ * RETURN:
+ *  1 if equal, 0 otherwise.
+ */
+int IsUListIterEqual(ulist_iter_t iterator1, ulist_iter_t iterator2);
+
+/*
+ * DESCRIPTION:
+ *  Calls func on every element from from until, not including, to.
+ *  Stops when func returns 1.
+ * 
+ * TIME COMPLEXITY: 
+ *  O(n)
+ * 
+ * SPACE COMPLEXITY: 
+ *  O(1)
+ * 
+ * PARAMS:
+ *  from:       first element.
+ *  to:         end of the range.
+ *  userdata:   passed to func.
+ *  func:       action function.
+ *
+ * RETURN:
+ *  The last status func returned, 0 for an empty range.
+ */
+int UListForEachElement(ulist_iter_t from, ulist_iter_t to, void *userdata, ulist_actionfunc_t func);
+
+/*
+ * DESCRIPTION:
+ *  Finds the first element from from until, not including, to for
+ *  which func returns 1.
+ * 
+ * TIME COMPLEXITY: 
+ *  O(n)
+ * 
+ * SPACE COMPLEXITY: 
+ *  O(1)
+ * 
+ * PARAMS:
+ *  from:       first element.
+ *  to:         end of the range.
+ *  matchdata:  passed to func.
+ *  func:       match function.
+ *
+ * RETURN:
+ *  Iterator to the element, to if none matches.
+ */
+ulist_iter_t UListFind(ulist_iter_t from, ulist_iter_t to, void *matchdata, ulist_matchfunc_t func);
+
+#endif /* __ILRD_UNROLLED_LIST_H__ */
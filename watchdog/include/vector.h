@@ -0,0 +1,354 @@
+#ifndef __ILRD_VECTOR_H__
+#define __ILRD_VECTOR_H__
+
+#include <stddef.h> /* size_t */
+
+#include "allocator.h" /* allocator_t */
+
+typedef struct vector vector_t;
+
+/* alignment of the buffer of vectors made by VectorCreateAligned() */
+#define VECTOR_ALIGNMENT (64)
+
+/* aligned buffers of at least this many bytes are backed by huge pages */
+#define VECTOR_HUGE_PAGE_THRESHOLD ((size_t)2 << 20)
+
+typedef enum vector_grow
+{
+    VECTOR_GROW_DOUBLE,         /* default */
+    VECTOR_GROW_ONE_AND_HALF
+} vector_grow_t;
+
+/*
+ * When a pop leaves the vector this empty, its capacity is halved.
+ * It never shrinks below its initial capacity.
+ */
+typedef enum vector_shrink
+{
+    VECTOR_SHRINK_AT_QUARTER,   /* default, halved capacity is half full */
+    VECTOR_SHRINK_AT_HALF,      /* halved capacity is full, push/pop at the 
+                                   boundary reallocs every time */
+    VECTOR_SHRINK_NEVER
+} vector_shrink_t;
+
+/*
+ * DESCRIPTION:
+ *  Creates a dynamic vector of elements of a fixed size.
+ *
+ * TIME COMPLEXITY:
+ *  O(1)
+ *
+ * SPACE COMPLEXITY:
+ *  O(n)
+ *
+ * PARAMS:
+ *  init_capacity:          number of elements to allocate room for.
+ *  size_of_one_element:    size in bytes of a single element.
+ *
+ * RETURN:
+ *  Pointer to the new vector, NULL on failure.
+ */
+vector_t *VectorCreate(size_t init_capacity, size_t size_of_one_element);
+
+/*
+ * DESCRIPTION:
+ *  Same as VectorCreate(), but the buffer starts on a cache line
+ *  (VECTOR_ALIGNMENT). From VECTOR_HUGE_PAGE_THRESHOLD bytes on, it is
+ *  mapped in whole huge pages, so growing inside the mapping costs
+ *  nothing and growing past it remaps the pages instead of copying them.
+ *
+ * TIME COMPLEXITY:
+ *  O(1)
+ *
+ * SPACE COMPLEXITY:
+ *  O(n)
+ *
+ * PARAMS:
+ *  init_capacity:          number of elements to allocate room for.
+ *  size_of_one_element:    size in bytes of a single element.
+ *
+ * RETURN:
+ *  Pointer to the new vector, NULL on failure.
+ */
+vector_t *VectorCreateAligned(size_t init_capacity, size_t size_of_one_element);
+
+/*
+ * DESCRIPTION:
+ *  Same as VectorCreate(), or VectorCreateAligned() when is_aligned, but
+ *  the vector and its buffer come from allocator. Huge page mappings are
+ *  only made for the malloc allocator (see AllocatorMalloc()).
+ *
+ * TIME COMPLEXITY:
+ *  O(1)
+ *
+ * SPACE COMPLEXITY:
+ *  O(n)
+ *
+ * PARAMS:
+ *  allocator:              where the memory comes from.
+ *  init_capacity:          number of elements to allocate room for.
+ *  size_of_one_element:    size in bytes of a single element.
+ *  is_aligned:             non zero for a buffer aligned on a cache line.
+ *
+ * RETURN:
+ *  Pointer to the new vector, NULL on failure.
+ */
+vector_t *VectorCreateWithAllocator(const allocator_t *allocator, size_t init_capacity, 
+										size_t size_of_one_element, int is_aligned);
+
+/*
+ * DESCRIPTION:
+ *  Frees the vector and all of its elements.
+ *
+ * TIME COMPLEXITY:
+ *  O(1)
+ *
+ * SPACE COMPLEXITY:
+ *  O(1)
+ *
+ * PARAMS:
+ *  vector:     vector to be destroyed.
+ *
+ * RETURN:
+ *  None.
+ */
+void VectorDestroy(vector_t *vector);
+
+/*
+ * DESCRIPTION:
+ *  Sets how the vector grows when full, and when it gives memory back.
+ *
+ * TIME COMPLEXITY:
+ *  O(1)
+ *
+ * SPACE COMPLEXITY:
+ *  O(1)
+ *
+ * PARAMS:
+ *  vector:         vector to be altered.
+ *  grow_policy:    growth factor when full.
+ *  shrink_policy:  occupancy under which capacity is halved.
+ *
+ * RETURN:
+ *  None.
+ */
+void VectorSetPolicy(vector_t *vector, vector_grow_t grow_policy, vector_shrink_t shrink_policy);
+
+/*
+ * DESCRIPTION:
+ *  Gives access to the element stored at index.
+ *  The pointer is invalidated by any push / pop / reserve.
+ *
+ * TIME COMPLEXITY:
+ *  O(1)
+ *
+ * SPACE COMPLEXITY:
+ *  O(1)
+ *
+ * PARAMS:
+ *  vector:     vector to be evaluated.
+ *  index:      index of the element.
+ *
+ * RETURN:
+ *  Pointer to the element, NULL if index is out of range.
+ */
+void *VectorGetAccessToElement(const vector_t *vector, size_t index);
+
+/*
+ * DESCRIPTION:
+ *  Gives the elements as one contiguous range, for loops that walk them
+ *  without a bounds check per element:
+ *
+ *      for (curr = (T *)VectorBegin(vector); curr != (T *)VectorEnd(vector); ++curr)
+ *
+ *  The range is invalidated by any push / pop / reserve.
+ *
+ * TIME COMPLEXITY:
+ *  O(1)
+ *
+ * SPACE COMPLEXITY:
+ *  O(1)
+ *
+ * PARAMS:
+ *  vector:     vector to be evaluated.
+ *
+ * RETURN:
+ *  Pointer to the first element.
+ */
+void *VectorBegin(const vector_t *vector);
+
+/*
+ * DESCRIPTION:
+ *  Same as VectorBegin(), gives the end of the range.
+ *
+ * TIME COMPLEXITY:
+ *  O(1)
+ *
+ * SPACE COMPLEXITY:
+ *  O(1)
+ *
+ * PARAMS:
+ *  vector:     vector to be evaluated.
+ *
+ * RETURN:
+ *  Pointer one past the last element.
+ */
+void *VectorEnd(const vector_t *vector);
+
+/*
+ * DESCRIPTION:
+ *  Returns the number of elements in the vector.
+ *
+ * TIME COMPLEXITY:
+ *  O(1)
+ *
+ * SPACE COMPLEXITY:
+ *  O(1)
+ *
+ * PARAMS:
+ *  vector:     vector to be evaluated.
+ *
+ * RETURN:
+ *  Number of elements.
+ */
+size_t VectorSize(const vector_t *vector);
+
+/*
+ * DESCRIPTION:
+ *  Reallocates the vector to hold exactly new_capacity elements.
+ *  Fails, and leaves the vector as is, when new_capacity is smaller
+ *  than the current size.
+ *
+ * TIME COMPLEXITY:
+ *  O(n)
+ *
+ * SPACE COMPLEXITY:
+ *  O(n)
+ *
+ * PARAMS:
+ *  vector:         vector to be altered.
+ *  new_capacity:   number of elements to hold.
+ *
+ * RETURN:
+ *  0 on success, non zero on failure.
+ */
+int VectorReserve(vector_t *vector, size_t new_capacity);
+
+/*
+ * DESCRIPTION:
+ *  Copies value to the end of the vector, grows it when full.
+ *
+ * TIME COMPLEXITY:
+ *  O(1) amortized
+ *
+ * SPACE COMPLEXITY:
+ *  O(1) amortized
+ *
+ * PARAMS:
+ *  vector:     vector to be altered.
+ *  value:      pointer to the element_size bytes to copy.
+ *
+ * RETURN:
+ *  0 on success, non zero on failure.
+ */
+int VectorPushBack(vector_t *vector, const void *value);
+
+/*
+ * DESCRIPTION:
+ *  Copies count elements to the end of the vector in a single copy,
+ *  growing it at most once.
+ *
+ * TIME COMPLEXITY:
+ *  O(count) amortized
+ *
+ * SPACE COMPLEXITY:
+ *  O(count) amortized
+ *
+ * PARAMS:
+ *  vector:     vector to be altered.
+ *  values:     pointer to count contiguous elements, outside the vector.
+ *  count:      number of elements to copy.
+ *
+ * RETURN:
+ *  0 on success, non zero on failure.
+ */
+int VectorPushBackN(vector_t *vector, const void *values, size_t count);
+
+/*
+ * DESCRIPTION:
+ *  Copies count elements into the vector, the first one lands at index.
+ *  The elements from index on move count slots up.
+ *
+ * TIME COMPLEXITY:
+ *  O(n + count)
+ *
+ * SPACE COMPLEXITY:
+ *  O(count) amortized
+ *
+ * PARAMS:
+ *  vector:     vector to be altered.
+ *  index:      where to insert, at most the size of the vector.
+ *  values:     pointer to count contiguous elements, outside the vector.
+ *  count:      number of elements to copy.
+ *
+ * RETURN:
+ *  0 on success, non zero on failure.
+ */
+int VectorInsertRange(vector_t *vector, size_t index, const void *values, size_t count);
+
+/*
+ * DESCRIPTION:
+ *  Gives back the spare capacity, the capacity becomes the size.
+ *
+ * TIME COMPLEXITY:
+ *  O(n)
+ *
+ * SPACE COMPLEXITY:
+ *  O(1)
+ *
+ * PARAMS:
+ *  vector:     vector to be altered.
+ *
+ * RETURN:
+ *  0 on success, non zero on failure.
+ */
+int VectorShrink(vector_t *vector);
+
+/*
+ * DESCRIPTION:
+ *  Removes the last element of the vector, shrinks it when too empty.
+ *  Popping an empty vector does nothing.
+ *
+ * TIME COMPLEXITY:
+ *  O(1) amortized
+ *
+ * SPACE COMPLEXITY:
+ *  O(1)
+ *
+ * PARAMS:
+ *  vector:     vector to be altered.
+ *
+ * RETURN:
+ *  None.
+ */
+void VectorPopBack(vector_t *vector);
+
+/*
+ * DESCRIPTION:
+ *  Returns the number of elements the vector can hold without growing.
+ *
+ * TIME COMPLEXITY:
+ *  O(1)
+ *
+ * SPACE COMPLEXITY:
+ *  O(1)
+ *
+ * PARAMS:
+ *  vector:     vector to be evaluated.
+ *
+ * RETURN:
+ *  Capacity of the vector.
+ */
+size_t VectorCapacity(const vector_t *vector);
+
+#endif /* __ILRD_VECTOR_H__ */
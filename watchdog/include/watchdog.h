@@ -30,7 +30,8 @@ typedef enum
 /*
  * DESCRIPTION:
  *  The function will start a watchdog process.
- *  The signals SIGUSR1 and SIGUSR2 must not be modified.
+ *  The signal SIGUSR2 must not be modified, nor the shared memory
+ *  object /WD_HEARTBEAT used.
  *
  * PARAMS:
  *  argc                        -   number of arguments in argument vector.
@@ -27,6 +27,9 @@
 #include <semaphore.h> /* semopen semwait sempost */
 #include <fcntl.h>  /* O_CREAT*/
 #include <sys/wait.h> /* wait */
+#include <sys/mman.h> /* shm_open mmap munmap shm_unlink */
+#include <sys/syscall.h> /* SYS_futex */
+#include <linux/futex.h> /* FUTEX_WAIT FUTEX_WAKE */
 
 #include "scheduler.h" /* our scheduler functions */
 
@@ -44,20 +47,37 @@
 #define INTERVALS ("INTERVALS")
 #define THRESHOLD ("THRESHOLD")
 #define WATCHDOG_ON ("WATCHDOG_ON")
+#define HEARTBEAT_SHM ("/WD_HEARTBEAT")
+
+/*
+    Shared by the app and the watchdog, in place of SIGUSR1: each side
+    bumps its own counter every interval, indexed by APP_THREAD and
+    WATCH_DOG, and the peer only reads it. The counters are futex words:
+    the peer sleeps on one until it moves, and each beat wakes it. An
+    interval that passes with no beat is a missed beat.
+*/
+typedef struct heartbeat
+{
+    atomic_uint beats[2];
+}heartbeat_t;
 
 typedef struct info_data
 {
     scheduler_t *scheduler;
     sem_t *sem_1;
     sem_t *sem_2;
-    int target_pid;
+    int target_pid; /* under peer_lock once the monitor runs */
+    pthread_mutex_t peer_lock;
+    heartbeat_t *heartbeat;
+    unsigned int last_peer_beat; /* the monitor's alone */
+    pthread_t monitor;
 }info_t; 
 
 
 /*
  * DESCRIPTION:
  *  this func takes two named semaphores, create an info struct
- *  fills it with env variables and returns it.
+ *  fills it with env variables, maps the heartbeat page and returns it.
  *
  * PARAMS:
  *  sem_1           - first semaphore
@@ -90,8 +110,8 @@ void SetEnvVar(char *argv[], size_t timeout_interval, size_t missed_signal_thres
 /*
  * DESCRIPTION:
  *  The function will init all tools, add task to scheduler and run it.
- *  
- *
+ *  The peer is watched from a thread of its own, asleep on the peer's
+ *  heartbeat until it beats or an interval passes.
  *
  * PARAMS:
  *  data                        -   void ptr to info struct
@@ -0,0 +1,232 @@
+#define _POSIX_C_SOURCE 200112L /* posix_memalign */
+
+#include <stdlib.h> /* malloc calloc realloc posix_memalign free */
+#include <string.h> /* memcpy memset */
+#include <assert.h> /* assert */
+
+#include "allocator.h" /* my functions */
+
+static void *MallocAlloc(void *context, size_t size, size_t alignment);
+static void MallocFree(void *context, void *block, size_t size, size_t alignment);
+static void *MallocRealloc(void *context, void *block, size_t old_size, size_t new_size);
+static void *MallocAllocZeroed(void *context, size_t size);
+static void *CountingAlloc(void *context, size_t size, size_t alignment);
+static void CountingFree(void *context, void *block, size_t size, size_t alignment);
+static void *CountingRealloc(void *context, void *block, size_t old_size, size_t new_size);
+static void *CountingAllocZeroed(void *context, size_t size);
+static void CountIn(counting_allocator_t *counting, size_t size);
+static void CountOut(counting_allocator_t *counting, size_t size);
+
+static const allocator_t g_malloc_allocator = 
+{
+    MallocAlloc, MallocFree, MallocRealloc, MallocAllocZeroed, NULL
+};
+
+static const allocator_t *g_default_allocator = &g_malloc_allocator;
+
+const allocator_t *AllocatorMalloc(void)
+{
+    return &g_malloc_allocator;
+}
+
+const allocator_t *AllocatorGetDefault(void)
+{
+    return g_default_allocator;
+}
+
+void AllocatorSetDefault(const allocator_t *allocator)
+{
+    g_default_allocator = NULL != allocator ? allocator : &g_malloc_allocator;
+}
+
+void *AllocatorAlloc(const allocator_t *allocator, size_t size, size_t alignment)
+{
+    assert(NULL != allocator);
+    assert(0 == (alignment & (alignment - 1)));
+
+    return allocator->alloc(allocator->context, size, alignment);
+}
+
+void *AllocatorAllocZeroed(const allocator_t *allocator, size_t size)
+{
+    void *block = NULL;
+
+    assert(NULL != allocator);
+
+    if (NULL != allocator->alloc_zeroed)
+    {
+        return allocator->alloc_zeroed(allocator->context, size);
+    }
+
+    block = allocator->alloc(allocator->context, size, 0);
+    if (NULL != block)
+    {
+        memset(block, 0, size);
+    }
+
+    return block;
+}
+
+void *AllocatorRealloc(const allocator_t *allocator, void *block, size_t old_size, 
+                                                                    size_t new_size)
+{
+    void *moved = NULL;
+
+    assert(NULL != allocator);
+
+    if (NULL != allocator->realloc)
+    {
+        return allocator->realloc(allocator->context, block, old_size, new_size);
+    }
+
+    moved = allocator->alloc(allocator->context, new_size, 0);
+    if (NULL == moved)
+    {
+        return NULL;
+    }
+
+    if (NULL != block)
+    {
+        memcpy(moved, block, old_size < new_size ? old_size : new_size);
+        allocator->free(allocator->context, block, old_size, 0);
+    }
+
+    return moved;
+}
+
+void AllocatorFree(const allocator_t *allocator, void *block, size_t size, size_t alignment)
+{
+    assert(NULL != allocator);
+
+    if (NULL != block)
+    {
+        allocator->free(allocator->context, block, size, alignment);
+    }
+}
+
+void AllocatorInitCounting(counting_allocator_t *counting, const allocator_t *parent)
+{
+    assert(NULL != counting);
+    assert(NULL != parent);
+
+    counting->allocator.alloc = CountingAlloc;
+    counting->allocator.free = CountingFree;
+    counting->allocator.realloc = CountingRealloc;
+    counting->allocator.alloc_zeroed = CountingAllocZeroed;
+    counting->allocator.context = counting;
+    counting->parent = parent;
+    counting->bytes = 0;
+    counting->peak_bytes = 0;
+    counting->blocks = 0;
+}
+
+static void *MallocAlloc(void *context, size_t size, size_t alignment)
+{
+    void *block = NULL;
+
+    (void)context;
+
+    if (0 == alignment)
+    {
+        return malloc(size);
+    }
+
+    /* posix_memalign() takes nothing under the size of a pointer */
+    alignment = alignment < sizeof(void *) ? sizeof(void *) : alignment;
+
+    return 0 == posix_memalign(&block, alignment, size) ? block : NULL;
+}
+
+static void MallocFree(void *context, void *block, size_t size, size_t alignment)
+{
+    (void)context;
+    (void)size;
+    (void)alignment;
+
+    free(block);
+}
+
+static void *MallocRealloc(void *context, void *block, size_t old_size, size_t new_size)
+{
+    (void)context;
+    (void)old_size;
+
+    return realloc(block, new_size);
+}
+
+static void *MallocAllocZeroed(void *context, size_t size)
+{
+    (void)context;
+
+    return calloc(size, 1);
+}
+
+static void *CountingAlloc(void *context, size_t size, size_t alignment)
+{
+    counting_allocator_t *counting = (counting_allocator_t *)context;
+    void *block = AllocatorAlloc(counting->parent, size, alignment);
+
+    if (NULL != block)
+    {
+        CountIn(counting, size);
+    }
+
+    return block;
+}
+
+static void CountingFree(void *context, void *block, size_t size, size_t alignment)
+{
+    counting_allocator_t *counting = (counting_allocator_t *)context;
+
+    AllocatorFree(counting->parent, block, size, alignment);
+    CountOut(counting, size);
+}
+
+static void *CountingRealloc(void *context, void *block, size_t old_size, size_t new_size)
+{
+    counting_allocator_t *counting = (counting_allocator_t *)context;
+    void *moved = AllocatorRealloc(counting->parent, block, old_size, new_size);
+
+    if (NULL != moved)
+    {
+        if (NULL != block)
+        {
+            CountOut(counting, old_size);
+        }
+        CountIn(counting, new_size);
+    }
+
+    return moved;
+}
+
+static void *CountingAllocZeroed(void *context, size_t size)
+{
+    counting_allocator_t *counting = (counting_allocator_t *)context;
+    void *block = AllocatorAllocZeroed(counting->parent, size);
+
+    if (NULL != block)
+    {
+        CountIn(counting, size);
+    }
+
+    return block;
+}
+
+static void CountIn(counting_allocator_t *counting, size_t size)
+{
+    size_t bytes = __atomic_add_fetch(&counting->bytes, size, __ATOMIC_RELAXED);
+    size_t peak = __atomic_load_n(&counting->peak_bytes, __ATOMIC_RELAXED);
+
+    __atomic_add_fetch(&counting->blocks, 1, __ATOMIC_RELAXED);
+
+    while (bytes > peak && !__atomic_compare_exchange_n(&counting->peak_bytes, &peak, 
+                                    bytes, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    {
+    }
+}
+
+static void CountOut(counting_allocator_t *counting, size_t size)
+{
+    __atomic_sub_fetch(&counting->bytes, size, __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&counting->blocks, 1, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,635 @@
+/*
+	Coder : Josh Benichou
+	Date : 02/07/2023
+	Reviewer : *****
+*/
+
+
+/*************************** LIBRARY INCLUDES ******************************/
+#include <assert.h> /*asserts*/
+#include <stdio.h> /*printf */
+#include <stddef.h> /* size_t */
+
+/*************************** HEADER INCLUDES ******************************/
+
+#include "compact_list.h" /* our sorted list API */
+#include "list_sort.h" /* ListSortArray */
+#include "allocator.h" /* AllocatorAlloc AllocatorRealloc AllocatorFree */
+
+/************************** TYPEDEFS & STRUCTS ****************************/
+
+#define SEGMENT_SHIFT (8)
+#define SEGMENT_NODES (1UL << SEGMENT_SHIFT)
+#define SEGMENT_ALIGNMENT (4096)
+#define MAX_SEGMENTS ((size_t)1 << (32 - SEGMENT_SHIFT))
+
+/* slot 0 of every segment is its header, so index 0 is never a node */
+#define NO_NODE (0)
+#define SENTINEL (1)
+
+typedef unsigned int link_t;
+
+struct iterator
+{
+	link_t next;
+	link_t prev;
+	void *data;
+};
+
+/* finds the list and the index of a node from its address alone */
+typedef struct segment_header
+{
+	sorted_list_t *list;
+	link_t first_index;
+} segment_header_t;
+
+/* the free nodes are linked through next */
+struct sorted_list
+{
+	struct iterator **segments;
+	size_t segment_count;
+	size_t segment_capacity;
+	link_t free_nodes;
+	size_t size;
+	sort_comparefunc_t cmp_func;
+	const allocator_t *allocator;
+};
+
+/* compile only if the links are 32 bits and a segment fits its alignment */
+typedef char link_is_32_bits[4 == sizeof(link_t) ? 1 : -1];
+typedef char header_fits_slot[sizeof(segment_header_t) <= sizeof(struct iterator) ? 1 : -1];
+typedef char segment_fits[SEGMENT_NODES * sizeof(struct iterator) <= SEGMENT_ALIGNMENT ? 1 : -1];
+
+/************************ STATIC FUNCTIONS DECLARATIONS **********************/
+
+static sorted_list_t *FromArray(const allocator_t *allocator, sort_comparefunc_t func, 
+														void **data, size_t count);
+static dll_iterator_t Node(const sorted_list_t *list, link_t index);
+static segment_header_t *HeaderOf(dll_iterator_t node);
+static link_t IndexOf(dll_iterator_t node);
+static sorted_iter_t ToIter(const sorted_list_t *list, link_t index);
+static int GrowArena(sorted_list_t *list);
+static link_t AllocNode(sorted_list_t *list);
+static link_t InsertBefore(sorted_list_t *list, link_t place, void *data);
+static void *RemoveNode(sorted_list_t *list, link_t index);
+static void LinkBefore(sorted_list_t *list, link_t place, link_t index);
+static void UnlinkNode(sorted_list_t *list, link_t index);
+static link_t FindMyPlace(sorted_list_t *list, void *data);
+static link_t FindFromHint(sorted_list_t *list, link_t hint, void *data);
+static int IsBefore(sorted_list_t *list, link_t index, void *data);
+
+/************************* API FUNCTIONS DEFINITIONS *************************/
+
+sorted_list_t *SortedListCreate(sort_comparefunc_t func)
+{
+	return SortedListCreateWithAllocator(AllocatorGetDefault(), func);
+}
+
+sorted_list_t *SortedListCreateWithAllocator(const allocator_t *allocator, sort_comparefunc_t func)
+{
+	sorted_list_t *new_list = NULL;
+	dll_iterator_t sentinel = NULL;
+
+	assert(NULL != allocator);
+	assert(NULL != func);
+
+	new_list = (sorted_list_t *)AllocatorAlloc(allocator, sizeof(sorted_list_t), 0);
+	if (NULL == new_list)
+	{
+		return NULL;
+	}
+
+	new_list->segments = NULL;
+	new_list->segment_count = 0;
+	new_list->segment_capacity = 0;
+	new_list->free_nodes = NO_NODE;
+	new_list->size = 0;
+	new_list->cmp_func = func;
+	new_list->allocator = allocator;
+
+	/* nodes are handed out in index order, the first one is the sentinel */
+	if (0 != GrowArena(new_list))
+	{
+		AllocatorFree(allocator, new_list, sizeof(sorted_list_t), 0);
+		return NULL;
+	}
+	AllocNode(new_list);
+
+	sentinel = Node(new_list, SENTINEL);
+	sentinel->next = SENTINEL;
+	sentinel->prev = SENTINEL;
+	sentinel->data = NULL;
+
+	return new_list;
+}
+
+sorted_list_t *SortedListFromArray(sort_comparefunc_t func, void **data, size_t count)
+{
+	return FromArray(AllocatorGetDefault(), func, data, count);
+}
+
+void SortedListDestroy(sorted_list_t *list)
+{
+	size_t segment = 0;
+
+	assert(NULL != list);
+
+	for (segment = 0; segment < list->segment_count; ++segment)
+	{
+		AllocatorFree(list->allocator, list->segments[segment], 
+						SEGMENT_NODES * sizeof(struct iterator), SEGMENT_ALIGNMENT);
+	}
+	AllocatorFree(list->allocator, list->segments, 
+						list->segment_capacity * sizeof(struct iterator *), 0);
+
+	AllocatorFree(list->allocator, list, sizeof(sorted_list_t), 0);
+}
+
+void *SortedListGetData(sorted_iter_t iterator)
+{
+	assert(NULL != iterator.iter);
+
+	return iterator.iter->data;
+}
+
+sorted_iter_t SortedListInsert(sorted_list_t *list, void *data)
+{
+	assert(NULL != list);
+	assert(NULL != data);
+
+	return ToIter(list, InsertBefore(list, FindMyPlace(list, data), data));
+}
+
+sorted_iter_t SortedListInsertHint(sorted_list_t *list, sorted_iter_t hint, void *data)
+{
+	assert(NULL != list);
+	assert(NULL != data);
+	assert(hint.list == list);
+
+	return ToIter(list, InsertBefore(list, 
+								FindFromHint(list, IndexOf(hint.iter), data), data));
+}
+
+int SortedListInsertArray(sorted_list_t *list, void **data, size_t count)
+{
+	sorted_list_t *batch = NULL;
+	int status = 0;
+
+	assert(NULL != list);
+	assert(NULL != data || 0 == count);
+
+	batch = FromArray(list->allocator, list->cmp_func, data, count);
+	if (NULL == batch)
+	{
+		return 1;
+	}
+
+	/* what the merge could not take is still in batch */
+	SortedListMerge(list, batch);
+	status = 0 != batch->size;
+	SortedListDestroy(batch);
+
+	return status;
+}
+
+/* a node outside of the arena has no index */
+sorted_iter_t SortedListInsertLink(sorted_list_t *list, dll_link_t *link, void *data)
+{
+	assert(NULL != link);
+
+	(void)link;
+
+	return SortedListInsert(list, data);
+}
+
+sorted_iter_t SortedListRemove(sorted_list_t *list, sorted_iter_t iterator)
+{
+	link_t next = NO_NODE;
+
+	assert(NULL != list);
+	assert(iterator.list == list);
+
+	next = iterator.iter->next;
+	RemoveNode(list, IndexOf(iterator.iter));
+
+	return ToIter(list, next);
+}
+
+/* the node stays out of the free list: the search from its old place skips it */
+sorted_iter_t SortedListResort(sorted_list_t *list, sorted_iter_t iterator)
+{
+	link_t index = NO_NODE;
+
+	assert(NULL != list);
+	assert(iterator.list == list);
+
+	index = IndexOf(iterator.iter);
+	UnlinkNode(list, index);
+	LinkBefore(list, FindFromHint(list, iterator.iter->next, iterator.iter->data), index);
+
+	return iterator;
+}
+
+size_t SortedListCount(const sorted_list_t *list)
+{
+	assert(NULL != list);
+
+	return list->size;
+}
+
+sorted_iter_t SortedListFind(sorted_list_t *list, sorted_iter_t from, sorted_iter_t to, void *matchdata)
+{
+	assert(NULL != list);
+	assert(from.list == to.list);
+
+	(void)from;
+	(void)to;
+
+	return ToIter(list, FindMyPlace(list, matchdata));
+}
+
+sorted_iter_t SortedListFindIf(sorted_iter_t from, sorted_iter_t to, void *matchdata, sort_matchfunc_t func)
+{
+	assert(NULL != func);
+	assert(NULL != matchdata);
+	assert(from.list == to.list);
+
+	while (from.iter != to.iter && 1 != func(from.iter->data, matchdata))
+	{
+		from = SortedListNext(from);
+	}
+
+	return from;
+}
+
+int SortedListForEachElement(sorted_iter_t from, sorted_iter_t to, void *userdata, sort_actionfunc_t func)
+{
+	int status = 0;
+
+	assert(NULL != func);
+	assert(NULL != userdata);
+	assert(from.list == to.list);
+
+	for (; from.iter != to.iter; from = SortedListNext(from))
+	{
+		status = func(from.iter->data, userdata);
+		if (1 == status)
+		{
+			break;
+		}
+	}
+
+	return status;
+}
+
+sorted_iter_t SortedListBegin(const sorted_list_t *list)
+{
+	assert(NULL != list);
+
+	return ToIter(list, Node(list, SENTINEL)->next);
+}
+
+sorted_iter_t SortedListEnd(const sorted_list_t *list)
+{
+	assert(NULL != list);
+
+	return ToIter(list, SENTINEL);
+}
+
+sorted_iter_t SortedListNext(sorted_iter_t iterator)
+{
+	iterator.iter = Node(HeaderOf(iterator.iter)->list, iterator.iter->next);
+
+	return iterator;
+}
+
+sorted_iter_t SortedListPrev(sorted_iter_t iterator)
+{
+	iterator.iter = Node(HeaderOf(iterator.iter)->list, iterator.iter->prev);
+
+	return iterator;
+}
+
+int IsSortedListEmpty(const sorted_list_t *list)
+{
+	assert(NULL != list);
+
+	return 0 == list->size;
+}
+
+int IsSortedListIterEqual(sorted_iter_t iterator1, sorted_iter_t iterator2)
+{
+	return iterator1.iter == iterator2.iter;
+}
+
+/* nodes cannot move to another arena, the elements are copied over */
+void SortedListMerge(sorted_list_t *dest, sorted_list_t *src)
+{
+	link_t dest_runner = NO_NODE;
+	void *data = NULL;
+
+	assert(NULL != dest);
+	assert(NULL != src);
+
+	dest_runner = Node(dest, SENTINEL)->next;
+
+	while (0 < src->size)
+	{
+		data = Node(src, Node(src, SENTINEL)->next)->data;
+
+		while (SENTINEL != dest_runner && IsBefore(dest, dest_runner, data))
+		{
+			dest_runner = Node(dest, dest_runner)->next;
+		}
+
+		if (NO_NODE == InsertBefore(dest, dest_runner, data))
+		{
+			return;
+		}
+		RemoveNode(src, Node(src, SENTINEL)->next);
+	}
+}
+
+/* relinking nodes needs the d_linked_list layout, merges on one thread */
+void SortedListParallelMerge(sorted_list_t *dest, sorted_list_t *src, size_t threads)
+{
+	(void)threads;
+
+	SortedListMerge(dest, src);
+}
+
+void *SortedListPopFront(sorted_list_t *list)
+{
+	assert(NULL != list);
+
+	if (0 == list->size)
+	{
+		return NULL;
+	}
+
+	return RemoveNode(list, Node(list, SENTINEL)->next);
+}
+
+void *SortedListPopBack(sorted_list_t *list)
+{
+	assert(NULL != list);
+
+	if (0 == list->size)
+	{
+		return NULL;
+	}
+
+	return RemoveNode(list, Node(list, SENTINEL)->prev);
+}
+
+void SortedListPrint(sorted_list_t *list)
+{
+	link_t runner = NO_NODE;
+
+	assert(NULL != list);
+
+	for (runner = Node(list, SENTINEL)->next; SENTINEL != runner; 
+										runner = Node(list, runner)->next)
+	{
+		printf("%d -> ", *(int *)Node(list, runner)->data);
+	}
+	printf("\n");
+}
+
+/*********************** STATIC FUNCTIONS DEFINITIONS ************************/
+
+/* in list order already, each node goes last */
+static sorted_list_t *FromArray(const allocator_t *allocator, sort_comparefunc_t func, 
+														void **data, size_t count)
+{
+	sorted_list_t *new_list = NULL;
+	size_t index = 0;
+
+	assert(NULL != func);
+	assert(NULL != data || 0 == count);
+
+	new_list = SortedListCreateWithAllocator(allocator, func);
+	if (NULL == new_list)
+	{
+		return NULL;
+	}
+
+	if (0 != ListSortArray(data, count, func))
+	{
+		SortedListDestroy(new_list);
+		return NULL;
+	}
+
+	for (index = 0; index < count; ++index)
+	{
+		if (NO_NODE == InsertBefore(new_list, SENTINEL, data[index]))
+		{
+			SortedListDestroy(new_list);
+			return NULL;
+		}
+	}
+
+	return new_list;
+}
+
+static dll_iterator_t Node(const sorted_list_t *list, link_t index)
+{
+	return &list->segments[index >> SEGMENT_SHIFT][index & (SEGMENT_NODES - 1)];
+}
+
+static segment_header_t *HeaderOf(dll_iterator_t node)
+{
+	return (segment_header_t *)((size_t)node & ~(size_t)(SEGMENT_ALIGNMENT - 1));
+}
+
+static link_t IndexOf(dll_iterator_t node)
+{
+	segment_header_t *header = HeaderOf(node);
+
+	return header->first_index + (link_t)(node - (dll_iterator_t)header);
+}
+
+static sorted_iter_t ToIter(const sorted_list_t *list, link_t index)
+{
+	sorted_iter_t iterator;
+
+	/* a failed insert gives the end */
+	iterator.iter = Node(list, NO_NODE == index ? SENTINEL : index);
+	#ifndef NDEBUG
+		iterator.list = (sorted_list_t *)list;
+	#endif
+
+	return iterator;
+}
+
+/* adds a segment and puts its nodes, all but the header, on the free list */
+static int GrowArena(sorted_list_t *list)
+{
+	struct iterator **segments = NULL;
+	dll_iterator_t nodes = NULL;
+	segment_header_t *header = NULL;
+	link_t first_index = 0;
+	size_t slot = 0;
+
+	if (MAX_SEGMENTS == list->segment_count)
+	{
+		return 1;
+	}
+
+	if (list->segment_count == list->segment_capacity)
+	{
+		segments = (struct iterator **)AllocatorRealloc(list->allocator, list->segments, 
+					list->segment_capacity * sizeof(struct iterator *),
+					(2 * list->segment_capacity + 1) * sizeof(struct iterator *));
+		if (NULL == segments)
+		{
+			return 1;
+		}
+		list->segments = segments;
+		list->segment_capacity = 2 * list->segment_capacity + 1;
+	}
+
+	nodes = (dll_iterator_t)AllocatorAlloc(list->allocator, 
+						SEGMENT_NODES * sizeof(struct iterator), SEGMENT_ALIGNMENT);
+	if (NULL == nodes)
+	{
+		return 1;
+	}
+
+	first_index = (link_t)(list->segment_count << SEGMENT_SHIFT);
+	header = (segment_header_t *)nodes;
+	header->list = list;
+	header->first_index = first_index;
+
+	/* backwards, so the nodes are handed out in index order */
+	for (slot = SEGMENT_NODES - 1; 0 < slot; --slot)
+	{
+		nodes[slot].next = list->free_nodes;
+		list->free_nodes = first_index + (link_t)slot;
+	}
+
+	list->segments[list->segment_count] = nodes;
+	++list->segment_count;
+
+	return 0;
+}
+
+static link_t AllocNode(sorted_list_t *list)
+{
+	link_t index = list->free_nodes;
+
+	if (NO_NODE == index)
+	{
+		if (0 != GrowArena(list))
+		{
+			return NO_NODE;
+		}
+		index = list->free_nodes;
+	}
+
+	list->free_nodes = Node(list, index)->next;
+
+	return index;
+}
+
+/* NO_NODE on failure */
+static link_t InsertBefore(sorted_list_t *list, link_t place, void *data)
+{
+	link_t index = AllocNode(list);
+
+	if (NO_NODE == index)
+	{
+		return NO_NODE;
+	}
+
+	Node(list, index)->data = data;
+	LinkBefore(list, place, index);
+	++list->size;
+
+	return index;
+}
+
+static void *RemoveNode(sorted_list_t *list, link_t index)
+{
+	dll_iterator_t node = Node(list, index);
+
+	UnlinkNode(list, index);
+	--list->size;
+
+	node->next = list->free_nodes;
+	list->free_nodes = index;
+
+	return node->data;
+}
+
+static void LinkBefore(sorted_list_t *list, link_t place, link_t index)
+{
+	dll_iterator_t node = Node(list, index);
+	dll_iterator_t next = Node(list, place);
+
+	node->next = place;
+	node->prev = next->prev;
+	Node(list, next->prev)->next = index;
+	next->prev = index;
+}
+
+static void UnlinkNode(sorted_list_t *list, link_t index)
+{
+	dll_iterator_t node = Node(list, index);
+
+	Node(list, node->prev)->next = node->next;
+	Node(list, node->next)->prev = node->prev;
+}
+
+/* same search as the linked list: from both ends at once */
+static link_t FindMyPlace(sorted_list_t *list, void *data)
+{
+	link_t front = Node(list, SENTINEL)->next;
+	link_t back = SENTINEL;
+
+	while (front != back)
+	{
+		if (!IsBefore(list, front, data))
+		{
+			return front;
+		}
+		front = Node(list, front)->next;
+
+		if (front == back || IsBefore(list, Node(list, back)->prev, data))
+		{
+			return back;
+		}
+		back = Node(list, back)->prev;
+	}
+
+	return front;
+}
+
+static link_t FindFromHint(sorted_list_t *list, link_t hint, void *data)
+{
+	link_t begin = Node(list, SENTINEL)->next;
+
+	if (SENTINEL != hint && IsBefore(list, hint, data))
+	{
+		do
+		{
+			hint = Node(list, hint)->next;
+		}
+		while (SENTINEL != hint && IsBefore(list, hint, data));
+
+		return hint;
+	}
+
+	while (begin != hint && !IsBefore(list, Node(list, hint)->prev, data))
+	{
+		hint = Node(list, hint)->prev;
+	}
+
+	return hint;
+}
+
+/* data goes after the element of index */
+static int IsBefore(sorted_list_t *list, link_t index, void *data)
+{
+	return 0 <= list->cmp_func(Node(list, index)->data, data);
+}
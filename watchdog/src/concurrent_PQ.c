@@ -0,0 +1,578 @@
+/*
+	Coder : Josh Benichou
+	Date : 02/07/2023
+	Reviewer : *****
+*/
+
+/*************************** LIBRARY INCLUDES ******************************/
+#include <assert.h> /*asserts*/
+#include <stdio.h> /*printf */
+#include <stddef.h> /* NULL */
+#include <pthread.h> /* pthread_mutex_t */
+
+/*************************** HEADER INCLUDES ******************************/
+
+#include "heap.h" /* our heap API */
+#include "concurrent_PQ.h"
+#include "parallel.h" /* ParallelThreads */
+#include "allocator.h" /* AllocatorAlloc AllocatorFree */
+
+/************************** TYPEDEFS & STRUCTS ****************************/
+
+#define CACHE_LINE (64)
+#define SHARDS_PER_THREAD (2)
+#define MIN_SHARDS (4)
+#define MAX_SHARDS (64)
+#define LOCK_TRIES (4) /* busy heaps skipped before waiting on one */
+
+typedef struct shard
+{
+	pthread_mutex_t lock;
+	heap_t *heap;
+	size_t size; /* of the heap, readable without the lock */
+} shard_t;
+
+/* a heap alone on its cache lines, the line next to it is prefetched too */
+typedef union padded_shard
+{
+	shard_t shard;
+	char pad[2 * CACHE_LINE];
+} padded_shard_t;
+
+struct p_queue
+{
+	padded_shard_t *shards;
+	size_t shard_mask; /* shard count - 1, a power of two - 1 */
+	priority_comparefunc_t func;
+	priority_handlefunc_t handle_func;
+	const allocator_t *allocator;
+};
+
+/* compiles only if a shard fits in its padding */
+typedef char shard_fits[sizeof(shard_t) <= 2 * CACHE_LINE ? 1 : -1];
+
+/* the queue and heap the calling thread works on, for ShardHandle() */
+static __thread const p_queue_t *t_queue = NULL;
+static __thread size_t t_shard = 0;
+static __thread size_t t_random = 0;
+
+/************************ STATIC FUNCTIONS DECLARATIONS **********************/
+
+static shard_t *GetShard(const p_queue_t *queue, size_t index);
+static heap_t *Use(const p_queue_t *queue, size_t index);
+static void Publish(shard_t *shard);
+static size_t PickShard(const p_queue_t *queue);
+static size_t LockAny(p_queue_t *queue);
+static void *PopBetter(p_queue_t *queue, size_t first, size_t second);
+static void *PopFirstFound(p_queue_t *queue);
+static void ShardHandle(void *queuedata, size_t heap_handle);
+static void DestroyShards(p_queue_t *queue, size_t count);
+
+/************************* API FUNCTIONS DEFINITIONS *************************/
+
+p_queue_t *PQueueCreate(priority_comparefunc_t func)
+{
+	return PQueueCreateIndexed(func, NULL);
+}
+
+p_queue_t *PQueueCreateKeyed(priority_comparefunc_t func,
+				priority_keyfunc_t key_func, priority_handlefunc_t handle_func)
+{
+	return PQueueCreateWithAllocator(AllocatorGetDefault(), func, key_func,
+															handle_func, NULL);
+}
+
+p_queue_t *PQueueCreateIntrusive(priority_comparefunc_t func, priority_keyfunc_t key_func,
+				priority_handlefunc_t handle_func, priority_linkfunc_t link_func)
+{
+	return PQueueCreateWithAllocator(AllocatorGetDefault(), func, key_func,
+														handle_func, link_func);
+}
+
+p_queue_t *PQueueCreateIndexed(priority_comparefunc_t func, priority_handlefunc_t handle_func)
+{
+	return PQueueCreateWithAllocator(AllocatorGetDefault(), func, NULL,
+															handle_func, NULL);
+}
+
+p_queue_t *PQueueCreateWithAllocator(const allocator_t *allocator,
+				priority_comparefunc_t func, priority_keyfunc_t key_func,
+				priority_handlefunc_t handle_func, priority_linkfunc_t link_func)
+{
+	p_queue_t *new_queue = NULL;
+	size_t shard_count = MIN_SHARDS;
+	size_t index = 0;
+	shard_t *shard = NULL;
+
+	(void)key_func;
+	(void)link_func;
+	assert(NULL != allocator);
+	assert(NULL != func);
+
+	while (shard_count < SHARDS_PER_THREAD * ParallelThreads()
+											&& shard_count < MAX_SHARDS)
+	{
+		shard_count *= 2;
+	}
+
+	new_queue = (p_queue_t *)AllocatorAlloc(allocator, sizeof(p_queue_t), 0);
+	if (NULL == new_queue)
+	{
+		return NULL;
+	}
+
+	new_queue->shards = (padded_shard_t *)AllocatorAlloc(allocator,
+							shard_count * sizeof(padded_shard_t), CACHE_LINE);
+	if (NULL == new_queue->shards)
+	{
+		AllocatorFree(allocator, new_queue, sizeof(p_queue_t), 0);
+		return NULL;
+	}
+	new_queue->shard_mask = shard_count - 1;
+	new_queue->func = func;
+	new_queue->handle_func = handle_func;
+	new_queue->allocator = allocator;
+
+	for (index = 0; index < shard_count; ++index)
+	{
+		shard = GetShard(new_queue, index);
+		shard->size = 0;
+		shard->heap = HeapCreateWithAllocator(allocator, func,
+								NULL == handle_func ? NULL : &ShardHandle);
+		if (NULL == shard->heap)
+		{
+			break;
+		}
+		if (0 != pthread_mutex_init(&shard->lock, NULL))
+		{
+			HeapDestroy(shard->heap);
+			break;
+		}
+	}
+
+	if (index < shard_count)
+	{
+		DestroyShards(new_queue, index);
+		return NULL;
+	}
+
+	return new_queue;
+}
+
+void PQueueDestroy(p_queue_t *queue)
+{
+	assert(NULL != queue);
+
+	DestroyShards(queue, queue->shard_mask + 1);
+}
+
+int PQueueEnqueue(p_queue_t *queue, void *data)
+{
+	size_t index = 0;
+	int status = 0;
+
+	assert(NULL != queue);
+	assert(NULL != data);
+
+	index = LockAny(queue);
+	status = HeapPush(Use(queue, index), data);
+	Publish(GetShard(queue, index));
+	pthread_mutex_unlock(&GetShard(queue, index)->lock);
+
+	return 0 == status ? 0 : -1 ;
+}
+
+/*
+	Two random heaps, the smaller top wins. A busy heap is not waited on:
+	with one of the two busy the other one is taken, with both busy or
+	both empty two others are drawn. After a few draws, every heap is
+	tried in turn, so that NULL means the queue was really empty.
+*/
+void *PQueueDequeue(p_queue_t *queue)
+{
+	shard_t *first = NULL;
+	void *dequeued_data = NULL;
+	size_t first_index = 0;
+	size_t second_index = 0;
+	size_t tries = 0;
+
+	assert(NULL != queue);
+
+	for (tries = 0; tries < LOCK_TRIES; ++tries)
+	{
+		first_index = PickShard(queue);
+		second_index = (first_index + 1 + PickShard(queue) % queue->shard_mask)
+														& queue->shard_mask;
+		first = GetShard(queue, first_index);
+
+		if (0 == __atomic_load_n(&first->size, __ATOMIC_RELAXED)
+					&& 0 == __atomic_load_n(&GetShard(queue, second_index)->size,
+															__ATOMIC_RELAXED))
+		{
+			continue;
+		}
+
+		if (0 == pthread_mutex_trylock(&first->lock))
+		{
+			dequeued_data = PopBetter(queue, first_index, second_index);
+		}
+		else if (0 == pthread_mutex_trylock(&GetShard(queue, second_index)->lock))
+		{
+			dequeued_data = PopBetter(queue, second_index, first_index);
+		}
+
+		/* NULL if both were emptied by others meanwhile */
+		if (NULL != dequeued_data)
+		{
+			return dequeued_data;
+		}
+	}
+
+	return PopFirstFound(queue);
+}
+
+size_t PQueueSize(const p_queue_t *queue)
+{
+	size_t size = 0;
+	size_t index = 0;
+
+	assert(NULL != queue);
+
+	for (index = 0; index <= queue->shard_mask; ++index)
+	{
+		size += __atomic_load_n(&GetShard(queue, index)->size, __ATOMIC_RELAXED);
+	}
+
+	return size;
+}
+
+/* all the heaps are held at once, taken in order so threads cannot deadlock */
+void *PQueuePeek(p_queue_t *queue)
+{
+	heap_t *heap = NULL;
+	void *peeked_data = NULL;
+	void *top = NULL;
+	size_t index = 0;
+
+	assert(NULL != queue);
+
+	for (index = 0; index <= queue->shard_mask; ++index)
+	{
+		pthread_mutex_lock(&GetShard(queue, index)->lock);
+	}
+
+	for (index = 0; index <= queue->shard_mask; ++index)
+	{
+		heap = GetShard(queue, index)->heap;
+		top = IsHeapEmpty(heap) ? NULL : HeapPeek(heap);
+		if (NULL != top && (NULL == peeked_data || 0 < queue->func(peeked_data, top)))
+		{
+			peeked_data = top;
+		}
+	}
+
+	for (index = 0; index <= queue->shard_mask; ++index)
+	{
+		pthread_mutex_unlock(&GetShard(queue, index)->lock);
+	}
+
+	return peeked_data;
+}
+
+int IsPQueueEmpty(const p_queue_t *queue)
+{
+	assert(NULL != queue);
+
+	return 0 == PQueueSize(queue);
+}
+
+void PQueueClear(p_queue_t *queue)
+{
+	shard_t *shard = NULL;
+	size_t index = 0;
+
+	assert(NULL != queue);
+
+	for (index = 0; index <= queue->shard_mask; ++index)
+	{
+		shard = GetShard(queue, index);
+		pthread_mutex_lock(&shard->lock);
+		while (1 != IsHeapEmpty(shard->heap))
+		{
+			HeapPop(Use(queue, index));
+		}
+		Publish(shard);
+		pthread_mutex_unlock(&shard->lock);
+	}
+}
+
+void *PQueueRemove(p_queue_t *queue, void *matchdata, priority_matchfunc_t matchfunc)
+{
+	shard_t *shard = NULL;
+	void *removed_data = NULL;
+	size_t index = 0;
+
+	assert(NULL != queue);
+	assert(NULL != matchfunc);
+	assert(NULL != matchdata);
+
+	for (index = 0; index <= queue->shard_mask && NULL == removed_data; ++index)
+	{
+		shard = GetShard(queue, index);
+		pthread_mutex_lock(&shard->lock);
+		removed_data = HeapRemove(Use(queue, index), matchfunc, matchdata);
+		Publish(shard);
+		pthread_mutex_unlock(&shard->lock);
+	}
+
+	return removed_data;
+}
+
+size_t PQueueRemoveAll(p_queue_t *queue, void *matchdata,
+                    priority_matchfunc_t matchfunc, priority_cleanfunc_t clean_func)
+{
+	shard_t *shard = NULL;
+	size_t removed = 0;
+	size_t index = 0;
+
+	assert(NULL != queue);
+	assert(NULL != matchfunc);
+
+	for (index = 0; index <= queue->shard_mask; ++index)
+	{
+		shard = GetShard(queue, index);
+		pthread_mutex_lock(&shard->lock);
+		removed += HeapRemoveAll(Use(queue, index), matchfunc, matchdata, clean_func);
+		Publish(shard);
+		pthread_mutex_unlock(&shard->lock);
+	}
+
+	return removed;
+}
+
+void *PQueueFind(p_queue_t *queue, void *matchdata, priority_matchfunc_t matchfunc)
+{
+	shard_t *shard = NULL;
+	void *found_data = NULL;
+	size_t index = 0;
+
+	assert(NULL != queue);
+	assert(NULL != matchfunc);
+	assert(NULL != matchdata);
+
+	for (index = 0; index <= queue->shard_mask && NULL == found_data; ++index)
+	{
+		shard = GetShard(queue, index);
+		pthread_mutex_lock(&shard->lock);
+		found_data = HeapFind(shard->heap, matchfunc, matchdata);
+		pthread_mutex_unlock(&shard->lock);
+	}
+
+	return found_data;
+}
+
+/* the shard and the heap handle are packed in the handle, see ShardHandle() */
+int PQueueUpdate(p_queue_t *queue, size_t handle)
+{
+	shard_t *shard = NULL;
+	size_t index = 0;
+
+	assert(NULL != queue);
+	assert(PQ_NO_HANDLE != handle);
+
+	index = (handle - 1) & queue->shard_mask;
+	shard = GetShard(queue, index);
+
+	pthread_mutex_lock(&shard->lock);
+	HeapUpdate(Use(queue, index), (handle - 1) / (queue->shard_mask + 1) + 1);
+	pthread_mutex_unlock(&shard->lock);
+
+	return 0;
+}
+
+void *PQueueErase(p_queue_t *queue, size_t handle)
+{
+	shard_t *shard = NULL;
+	void *erased_data = NULL;
+	size_t index = 0;
+
+	assert(NULL != queue);
+	assert(PQ_NO_HANDLE != handle);
+
+	index = (handle - 1) & queue->shard_mask;
+	shard = GetShard(queue, index);
+
+	pthread_mutex_lock(&shard->lock);
+	erased_data = HeapErase(Use(queue, index),
+							(handle - 1) / (queue->shard_mask + 1) + 1);
+	Publish(shard);
+	pthread_mutex_unlock(&shard->lock);
+
+	return erased_data;
+}
+
+/*********************** STATIC FUNCTIONS DEFINITIONS ************************/
+
+static shard_t *GetShard(const p_queue_t *queue, size_t index)
+{
+	return &queue->shards[index].shard;
+}
+
+/* every heap call goes through here, for the handles it reports */
+static heap_t *Use(const p_queue_t *queue, size_t index)
+{
+	t_queue = queue;
+	t_shard = index;
+
+	return GetShard(queue, index)->heap;
+}
+
+/* called with the lock held, after each change to the heap */
+static void Publish(shard_t *shard)
+{
+	__atomic_store_n(&shard->size, HeapSize(shard->heap), __ATOMIC_RELAXED);
+}
+
+/* xorshift, seeded from the address of the state, which is per thread */
+static size_t PickShard(const p_queue_t *queue)
+{
+	if (0 == t_random)
+	{
+		t_random = ((size_t)&t_random >> 4) * 2654435761u | 1;
+	}
+
+	t_random ^= t_random << 13;
+	t_random ^= t_random >> 7;
+	t_random ^= t_random << 17;
+
+	return t_random & queue->shard_mask;
+}
+
+/* returns the index of the heap it locked */
+static size_t LockAny(p_queue_t *queue)
+{
+	size_t index = 0;
+	size_t tries = 0;
+
+	for (tries = 0; tries < LOCK_TRIES; ++tries)
+	{
+		index = PickShard(queue);
+		if (0 == pthread_mutex_trylock(&GetShard(queue, index)->lock))
+		{
+			return index;
+		}
+	}
+
+	pthread_mutex_lock(&GetShard(queue, index)->lock);
+
+	return index;
+}
+
+/* first is locked, second is only used if it can be locked without waiting */
+static void *PopBetter(p_queue_t *queue, size_t first, size_t second)
+{
+	shard_t *pop_shard = GetShard(queue, first);
+	shard_t *other = GetShard(queue, second);
+	size_t pop_index = first;
+	void *dequeued_data = NULL;
+	int has_other = 0;
+
+	if (0 != __atomic_load_n(&other->size, __ATOMIC_RELAXED)
+									&& 0 == pthread_mutex_trylock(&other->lock))
+	{
+		has_other = 1;
+		if (1 != IsHeapEmpty(other->heap) && (IsHeapEmpty(pop_shard->heap)
+				|| 0 < queue->func(HeapPeek(pop_shard->heap), HeapPeek(other->heap))))
+		{
+			pop_shard = other;
+			pop_index = second;
+		}
+	}
+
+	if (1 != IsHeapEmpty(pop_shard->heap))
+	{
+		dequeued_data = HeapPeek(pop_shard->heap);
+		HeapPop(Use(queue, pop_index));
+		Publish(pop_shard);
+	}
+
+	if (has_other)
+	{
+		pthread_mutex_unlock(&other->lock);
+	}
+	pthread_mutex_unlock(&GetShard(queue, first)->lock);
+
+	return dequeued_data;
+}
+
+/* waits on each heap in turn, from a random one */
+static void *PopFirstFound(p_queue_t *queue)
+{
+	shard_t *shard = NULL;
+	void *dequeued_data = NULL;
+	size_t start = PickShard(queue);
+	size_t index = 0;
+	size_t count = 0;
+
+	for (count = 0; count <= queue->shard_mask && NULL == dequeued_data; ++count)
+	{
+		index = (start + count) & queue->shard_mask;
+		shard = GetShard(queue, index);
+		if (0 == __atomic_load_n(&shard->size, __ATOMIC_RELAXED))
+		{
+			continue;
+		}
+
+		pthread_mutex_lock(&shard->lock);
+		if (1 != IsHeapEmpty(shard->heap))
+		{
+			dequeued_data = HeapPeek(shard->heap);
+			HeapPop(Use(queue, index));
+			Publish(shard);
+		}
+		pthread_mutex_unlock(&shard->lock);
+	}
+
+	return dequeued_data;
+}
+
+/* heap handle h of shard s is queue handle (h - 1) * shards + s + 1 */
+static void ShardHandle(void *queuedata, size_t heap_handle)
+{
+	t_queue->handle_func(queuedata, HEAP_NO_HANDLE == heap_handle ? PQ_NO_HANDLE
+					: (heap_handle - 1) * (t_queue->shard_mask + 1) + t_shard + 1);
+}
+
+/* the first count shards were fully made */
+static void DestroyShards(p_queue_t *queue, size_t count)
+{
+	shard_t *shard = NULL;
+	size_t index = 0;
+
+	for (index = 0; index < count; ++index)
+	{
+		shard = GetShard(queue, index);
+		HeapDestroy(shard->heap);
+		shard->heap = NULL;
+		pthread_mutex_destroy(&shard->lock);
+	}
+
+	AllocatorFree(queue->allocator, queue->shards,
+					(queue->shard_mask + 1) * sizeof(padded_shard_t), CACHE_LINE);
+	queue->shards = NULL;
+
+	AllocatorFree(queue->allocator, queue, sizeof(p_queue_t), 0);
+}
+
+#ifndef NDEBUG
+	void PrintQueue(p_queue_t *queue)
+	{
+		size_t index = 0;
+
+		for (index = 0; index <= queue->shard_mask; ++index)
+		{
+			printf("%lu: ", (unsigned long)index);
+			PrintHeap(GetShard(queue, index)->heap);
+		}
+	}
+#endif
@@ -4,12 +4,46 @@
 #include <stdio.h> /* printf */
 
 #include "d_linked_list.h" /* my funtions */
+#include "parallel.h" /* ParallelRun */
+#include "allocator.h" /* AllocatorAlloc AllocatorFree */
+
+#define FIRST_CHUNK_NODES (16)
+#define MAX_CHUNK_NODES (4096)
 
 typedef struct dll_node dll_node_t;
+
+/* a part of a range walked by one thread */
+typedef struct segment
+{
+	dll_iterator_t from;
+	dll_iterator_t to;
+	void *data;
+	dll_actionfunc_t action;
+	dll_matchfunc_t match;
+	vector_t *found;
+	int status;
+} segment_t;
+
+/*
+	The nodes of a chunk follow its header. Splices move nodes between
+	lists, so a chunk is not owned by a list: it is freed once no list
+	holds any of its nodes, linked or free.
+*/
+typedef struct node_chunk
+{
+	size_t held_nodes;
+	size_t node_count; /* for the size of the free */
+} node_chunk_t;
+
 struct dll 
 {
 	dll_iterator_t first;
 	dll_iterator_t last;
+	size_t size;
+	int is_pooled;
+	dll_iterator_t free_nodes; /* linked through their next field */
+	size_t next_chunk_nodes;
+	const allocator_t *allocator;
 };
 
 struct iterator
@@ -17,54 +51,97 @@ struct iterator
 	void *data;
 	dll_iterator_t next;
 	dll_iterator_t prev;	
+	node_chunk_t *chunk; /* NULL when allocated on its own */
 };
 
-static dll_iterator_t DLLNewNode();
-static int PlusOne(void *iteratordata, void *userdata);
+/* the chunk of nodes that live in a user's dll_link_t */
+static node_chunk_t g_linked_in_place = {0, 0};
+#define IN_PLACE (&g_linked_in_place)
+
+/* compiles only if a dll_link_t can hold a node */
+typedef char link_holds_node[sizeof(dll_link_t) >= sizeof(struct iterator) ? 1 : -1];
+
+static dll_iterator_t DLLNewNode(const allocator_t *allocator);
+static size_t CountRange(dll_iterator_t from, dll_iterator_t to);
+static dll_iterator_t AllocNode(dll_t *dll);
+static void FreeNode(dll_t *dll, dll_iterator_t node);
+static int GrowPool(dll_t *dll);
+static void ReleaseNode(const allocator_t *allocator, dll_iterator_t node);
+static size_t SplitRange(dll_t *dll, dll_iterator_t from, dll_iterator_t to, 
+											segment_t *segments, size_t count);
+static void ForEachInSegment(void *segment);
+static void FindInSegment(void *segment);
 
 dll_t *DLLCreate(void)
 {
-	dll_t *dll = (dll_t *)malloc(sizeof(dll_t));
+	return DLLCreateWithAllocator(AllocatorGetDefault(), 0);
+}
+
+dll_t *DLLCreatePooled(void)
+{
+	return DLLCreateWithAllocator(AllocatorGetDefault(), 1);
+}
+
+dll_t *DLLCreateWithAllocator(const allocator_t *allocator, int is_pooled)
+{
+	dll_t *dll = NULL;
+
+	assert(NULL != allocator);
+
+	dll = (dll_t *)AllocatorAlloc(allocator, sizeof(dll_t), 0);
 	if (NULL == dll)
 	{
 		return NULL;
 	}
 
-	dll->first = DLLNewNode();
+	dll->first = DLLNewNode(allocator);
 	if (NULL == dll->first)
 	{
-		free(dll);
+		AllocatorFree(allocator, dll, sizeof(dll_t), 0);
 		return NULL;
 	}
 
-	dll->last = DLLNewNode();
+	dll->last = DLLNewNode(allocator);
 	if (NULL == dll->last)
 	{
-		free(dll->first);
-		free(dll);
+		ReleaseNode(allocator, dll->first);
+		AllocatorFree(allocator, dll, sizeof(dll_t), 0);
 		return NULL;
 	}
 
 	dll->first->next = dll->last;
 	dll->last->prev = dll->first;
+	dll->size = 0;
+	dll->is_pooled = is_pooled;
+	dll->free_nodes = NULL;
+	dll->next_chunk_nodes = FIRST_CHUNK_NODES;
+	dll->allocator = allocator;
 
 	return dll;
 }
 
 void DLLDestroy(dll_t *dll)
 {
-    dll_iterator_t temp_to_free = dll->first;
+    dll_iterator_t temp_to_free = NULL;
 
     assert(NULL != dll);
 
+    temp_to_free = dll->first;
     while (NULL != dll->first)
     {
         dll->first = dll->first->next;
-        free(temp_to_free);
+        ReleaseNode(dll->allocator, temp_to_free);
         temp_to_free = dll->first;
     }
 
-    free(dll); 
+    while (NULL != dll->free_nodes)
+    {
+        temp_to_free = dll->free_nodes;
+        dll->free_nodes = dll->free_nodes->next;
+        ReleaseNode(dll->allocator, temp_to_free);
+    }
+
+    AllocatorFree(dll->allocator, dll, sizeof(dll_t), 0);
 }
 
 void *DLLGetData(dll_iterator_t iterator)
@@ -126,11 +203,12 @@ int IsDLLIterEqual(dll_iterator_t iterator1, dll_iterator_t iterator2)
 
 dll_iterator_t DLLInsertBefore(dll_t *dll, dll_iterator_t iterator, void *data)
 {
-	dll_iterator_t new_node = DLLNewNode();
+	dll_iterator_t new_node = NULL;
 
 	assert(NULL != dll);
 	assert(NULL != iterator);
 
+	new_node = AllocNode(dll);
 	if (NULL == new_node)
 	{
 		return DLLEnd(dll);
@@ -141,13 +219,34 @@ dll_iterator_t DLLInsertBefore(dll_t *dll, dll_iterator_t iterator, void *data)
 	new_node->prev = iterator->prev;
 	iterator->prev->next = new_node;
 	iterator->prev = new_node;
+	++dll->size;
 
 	return new_node;
 }
 
-static dll_iterator_t DLLNewNode()
+dll_iterator_t DLLInsertLinkBefore(dll_t *dll, dll_iterator_t iterator, dll_link_t *link, void *data)
 {
-    dll_iterator_t new_node = malloc(sizeof(struct iterator));
+	dll_iterator_t new_node = (dll_iterator_t)link;
+
+	assert(NULL != dll);
+	assert(NULL != iterator);
+	assert(NULL != link);
+
+	new_node->data = data;
+	new_node->chunk = IN_PLACE;
+	new_node->next = iterator;
+	new_node->prev = iterator->prev;
+	iterator->prev->next = new_node;
+	iterator->prev = new_node;
+	++dll->size;
+
+	return new_node;
+}
+
+static dll_iterator_t DLLNewNode(const allocator_t *allocator)
+{
+    dll_iterator_t new_node = (dll_iterator_t)AllocatorAlloc(allocator, 
+                                                    sizeof(struct iterator), 0);
     if (NULL == new_node)
     {
         return NULL;
@@ -156,6 +255,7 @@ static dll_iterator_t DLLNewNode()
     new_node->next = NULL;
     new_node->prev = NULL;
     new_node->data = NULL;
+    new_node->chunk = NULL;
 
     return new_node;
 }
@@ -163,13 +263,14 @@ static dll_iterator_t DLLNewNode()
 dll_iterator_t DLLRemove(dll_t *dll, dll_iterator_t iterator)
 {
 	dll_iterator_t to_return = iterator->next;
-	(void)dll;
+	assert(NULL != dll);
 	assert(NULL != iterator);
 
 	iterator->prev->next = iterator->next;
 	iterator->next->prev = iterator->prev;
+	--dll->size;
 
-	free(iterator);
+	FreeNode(dll, iterator);
 	iterator = NULL;
 
 	return to_return;
@@ -246,31 +347,48 @@ int DLLForEachElement(dll_iterator_t from, dll_iterator_t to, void *userdata, dl
 
 size_t DLLSize(dll_t *dll)
 {
-    size_t num_of_nodes = 0;
- 
     assert(NULL != dll);
-    DLLForEachElement(DLLBegin(dll), DLLEnd(dll), &num_of_nodes, &PlusOne);
 
-    return num_of_nodes;	
+    return dll->size;
 }
 
-static int PlusOne(void *iteratordata, void *userdata)
+/* only the range moving to another list has to be counted */
+static size_t CountRange(dll_iterator_t from, dll_iterator_t to)
 {
-    (void)iteratordata;
-    assert(NULL != userdata);
+    size_t count = 0;
 
-    *(size_t*)userdata += 1;;
+    for (; from != to; from = from->next)
+    {
+        ++count;
+    }
 
-    return 0;
+    return count;
 }
 
-void DLLSplice(dll_iterator_t target, dll_iterator_t from, dll_iterator_t to)
+void DLLSplice(dll_t *dest, dll_iterator_t target, dll_t *src, dll_iterator_t from, dll_iterator_t to)
 {
 	dll_iterator_t last_included = to->prev;
+	size_t moved = 0;
 
+    assert(NULL != dest);
+    assert(NULL != src);
     assert(NULL != from);
     assert(NULL != to);    
     assert(NULL != target);
+    assert(dest->allocator == src->allocator);
+
+    if (from == to)
+    {
+        return;
+    }
+
+    if (dest != src)
+    {
+        moved = (from == DLLBegin(src) && to == DLLEnd(src)) ? 
+                                            src->size : CountRange(from, to);
+        src->size -= moved;
+        dest->size += moved;
+    }
     
     from->prev->next = to;
     to->prev = DLLPrev(from);
@@ -327,6 +445,258 @@ int DLLMultiFind(dll_t *dll, dll_iterator_t from, dll_iterator_t to, void *match
     return 1;
 }
 
+int DLLParallelForEach(dll_t *dll, dll_iterator_t from, dll_iterator_t to, 
+						void *userdata, dll_actionfunc_t func, size_t threads)
+{
+	segment_t *segments = NULL;
+	size_t count = 0;
+	size_t index = 0;
+	int status = 0;
+
+	assert(NULL != dll);
+	assert(NULL != func);
+
+	threads = 0 == threads ? ParallelThreads() : threads;
+	segments = (segment_t *)malloc(threads * sizeof(segment_t));
+	if (NULL == segments)
+	{
+		return DLLForEachElement(from, to, userdata, func);
+	}
+
+	count = SplitRange(dll, from, to, segments, threads);
+	for (index = 0; index < count; ++index)
+	{
+		segments[index].data = userdata;
+		segments[index].action = func;
+	}
+
+	ParallelRun(ForEachInSegment, segments, sizeof(segment_t), count);
+
+	for (index = 0; index < count; ++index)
+	{
+		status = 1 == status ? status : segments[index].status;
+	}
+
+	free(segments);
+
+	return status;
+}
+
+int DLLParallelMultiFind(dll_t *dll, dll_iterator_t from, dll_iterator_t to, void *matchdata, 
+						dll_matchfunc_t func, vector_t *found, size_t threads)
+{
+	segment_t *segments = NULL;
+	size_t count = 0;
+	size_t index = 0;
+	int status = 0;
+
+	assert(NULL != dll);
+	assert(NULL != func);
+	assert(NULL != found);
+
+	threads = 0 == threads ? ParallelThreads() : threads;
+	segments = (segment_t *)malloc(threads * sizeof(segment_t));
+	if (NULL == segments)
+	{
+		return 1;
+	}
+
+	count = SplitRange(dll, from, to, segments, threads);
+	for (index = 0; index < count; ++index)
+	{
+		segments[index].data = matchdata;
+		segments[index].match = func;
+		segments[index].found = VectorCreate(1, sizeof(void *));
+		status |= NULL == segments[index].found;
+	}
+
+	if (0 == status)
+	{
+		ParallelRun(FindInSegment, segments, sizeof(segment_t), count);
+	}
+
+	for (index = 0; index < count; ++index)
+	{
+		if (NULL == segments[index].found)
+		{
+			continue;
+		}
+
+		status |= segments[index].status;
+		if (0 == status)
+		{
+			status = VectorPushBackN(found, VectorBegin(segments[index].found), 
+										VectorSize(segments[index].found));
+		}
+		VectorDestroy(segments[index].found);
+	}
+
+	free(segments);
+
+	return status;
+}
+
+void DLLLinkSequence(dll_iterator_t *nodes, size_t count)
+{
+	size_t index = 0;
+
+	assert(NULL != nodes || 0 == count);
+
+	for (index = 1; index < count; ++index)
+	{
+		nodes[index - 1]->next = nodes[index];
+		nodes[index]->prev = nodes[index - 1];
+	}
+}
+
+/*
+	Cuts [from, to) in at most count segments of the same length, so the
+	segments can be walked in parallel. Gives the number of segments.
+*/
+static size_t SplitRange(dll_t *dll, dll_iterator_t from, dll_iterator_t to, 
+											segment_t *segments, size_t count)
+{
+	size_t length = (from == DLLBegin(dll) && to == DLLEnd(dll)) ? 
+											dll->size : CountRange(from, to);
+	size_t per_segment = 0;
+	size_t index = 0;
+	size_t step = 0;
+
+	if (0 == length)
+	{
+		return 0;
+	}
+
+	count = count < length ? count : length;
+	per_segment = (length + count - 1) / count;
+	count = (length + per_segment - 1) / per_segment;
+
+	for (index = 0; index < count; ++index)
+	{
+		segments[index].from = from;
+		for (step = 0; step < per_segment && from != to; ++step)
+		{
+			from = from->next;
+		}
+		segments[index].to = from;
+		segments[index].status = 0;
+	}
+
+	return count;
+}
+
+static void ForEachInSegment(void *segment)
+{
+	segment_t *part = (segment_t *)segment;
+
+	part->status = DLLForEachElement(part->from, part->to, part->data, part->action);
+}
+
+static void FindInSegment(void *segment)
+{
+	segment_t *part = (segment_t *)segment;
+	dll_iterator_t runner = part->from;
+
+	for (; runner != part->to; runner = runner->next)
+	{
+		if (1 == part->match(runner->data, part->data) && 
+						0 != VectorPushBack(part->found, &runner->data))
+		{
+			part->status = 1;
+			return;
+		}
+	}
+}
+
+static dll_iterator_t AllocNode(dll_t *dll)
+{
+	dll_iterator_t node = NULL;
+
+	if (!dll->is_pooled)
+	{
+		return DLLNewNode(dll->allocator);
+	}
+
+	if (NULL == dll->free_nodes && 0 != GrowPool(dll))
+	{
+		return NULL;
+	}
+
+	node = dll->free_nodes;
+	dll->free_nodes = node->next;
+
+	return node;
+}
+
+static void FreeNode(dll_t *dll, dll_iterator_t node)
+{
+	if (IN_PLACE == node->chunk)
+	{
+		return;
+	}
+
+	if (!dll->is_pooled)
+	{
+		ReleaseNode(dll->allocator, node);
+		return;
+	}
+
+	node->next = dll->free_nodes;
+	dll->free_nodes = node;
+}
+
+static void ReleaseNode(const allocator_t *allocator, dll_iterator_t node)
+{
+	if (IN_PLACE == node->chunk)
+	{
+		return;
+	}
+
+	if (NULL == node->chunk)
+	{
+		AllocatorFree(allocator, node, sizeof(struct iterator), 0);
+	}
+	else if (0 == --node->chunk->held_nodes)
+	{
+		AllocatorFree(allocator, node->chunk, sizeof(node_chunk_t) + 
+							node->chunk->node_count * sizeof(struct iterator), 0);
+	}
+}
+
+/* adds a chunk twice as big as the previous one, up to MAX_CHUNK_NODES */
+static int GrowPool(dll_t *dll)
+{
+	node_chunk_t *chunk = NULL;
+	dll_iterator_t nodes = NULL;
+	size_t index = 0;
+
+	chunk = (node_chunk_t *)AllocatorAlloc(dll->allocator, sizeof(node_chunk_t) + 
+							dll->next_chunk_nodes * sizeof(struct iterator), 0);
+	if (NULL == chunk)
+	{
+		return 1;
+	}
+
+	chunk->held_nodes = dll->next_chunk_nodes;
+	chunk->node_count = dll->next_chunk_nodes;
+
+	/* backwards, so the nodes are handed out in address order */
+	nodes = (dll_iterator_t)(chunk + 1);
+	for (index = dll->next_chunk_nodes; 0 < index; --index)
+	{
+		nodes[index - 1].chunk = chunk;
+		nodes[index - 1].next = dll->free_nodes;
+		dll->free_nodes = &nodes[index - 1];
+	}
+
+	if (MAX_CHUNK_NODES > dll->next_chunk_nodes)
+	{
+		dll->next_chunk_nodes *= 2;
+	}
+
+	return 0;
+}
+
 #ifndef NDEBUG
 	void DLLPrint(dll_t *list)
 	{
@@ -1,7 +1,7 @@
 /*************************** LIBRARY INCLUDES ******************************/
 #include <assert.h> /*asserts*/
 #include <stdio.h> /*printf */
-#include <stdlib.h> /* malloc free */
+#include <stdlib.h> /* size_t */
 #include <string.h> /* memmove */
 
 /*************************** HEADER INCLUDES ******************************/
@@ -31,40 +31,60 @@ struct heap
 {
     vector_t *vector;
     heap_comparefunc_t cmp_func;
+    heap_indexfunc_t index_func;
+    const allocator_t *allocator;
 };
 
 /************************ STATIC FUNCTIONS DECLARATIONS **********************/
 
-static void HeapifyUp(vector_t *vector, size_t curr_index, heap_comparefunc_t cmp_func);
-static void HeapifyDown(vector_t *vector, size_t curr_index, heap_comparefunc_t cmp_func);
-static size_t FindBigger(vector_t *vector, size_t curr_index, heap_comparefunc_t cmp_func);
+static void SiftUp(heap_t *heap, void **heap_arr, size_t hole, void *data);
+static void SiftDown(heap_t *heap, void **heap_arr, size_t hole, void *data);
+static void SiftDownBottomUp(heap_t *heap, void **heap_arr, size_t hole, void *data);
+static void Resift(heap_t *heap, size_t curr_index);
+static void *EraseAt(heap_t *heap, size_t index);
 static size_t FindElement(vector_t *vector, heap_matchfunc_t match_func, const void *search_data);
-static void GetDataNSwap(vector_t *vector, size_t data1_index, size_t data2_index);
-static int GetDataNCmp(vector_t *vector, size_t data1_index, size_t data2_index, heap_comparefunc_t cmp_func);
-static void SwapVoid(void **element1, void **element2);
+static void PlaceAt(heap_t *heap, void **heap_arr, size_t index, void *data);
+static void **GetHeapArray(const heap_t *heap);
 
 /************************* API FUNCTIONS DEFINITIONS *************************/
 
 heap_t *HeapCreate(heap_comparefunc_t cmp_func)
 {
-    heap_t *new_heap = (heap_t *)malloc(sizeof(heap_t));
+    return HeapCreateIndexed(cmp_func, NULL);
+}
+
+heap_t *HeapCreateIndexed(heap_comparefunc_t cmp_func, heap_indexfunc_t index_func)
+{
+    return HeapCreateWithAllocator(AllocatorGetDefault(), cmp_func, index_func);
+}
+
+heap_t *HeapCreateWithAllocator(const allocator_t *allocator, heap_comparefunc_t cmp_func, 
+                                                        heap_indexfunc_t index_func)
+{
+    heap_t *new_heap = NULL;
     char *dummy = "DUMMY";
 
+    assert(allocator);
+    assert(cmp_func);
+
+    new_heap = (heap_t *)AllocatorAlloc(allocator, sizeof(heap_t), 0);
     if(NULL == new_heap)
     {
         return NULL;
     }
 
-    assert(cmp_func);
-
-    new_heap->vector = VectorCreate(4, sizeof(void *));
+    /* with the dummy at slot 0, siblings always share a cache line */
+    new_heap->vector = VectorCreateWithAllocator(allocator, 4, sizeof(void *), 1);
     if(NULL == new_heap->vector)
     {
+        AllocatorFree(allocator, new_heap, sizeof(heap_t), 0);
         return NULL;
     }
-    VectorPushBack(new_heap->vector, dummy); /* SET DUMMY VALUE */
+    VectorPushBack(new_heap->vector, &dummy); /* SET DUMMY VALUE */
 
     new_heap->cmp_func = cmp_func;
+    new_heap->index_func = index_func;
+    new_heap->allocator = allocator;
 
     return new_heap;
 }
@@ -76,7 +96,7 @@ void HeapDestroy(heap_t *heap)
     VectorDestroy(heap->vector);
     heap->vector = NULL;
 
-    free(heap);
+    AllocatorFree(heap->allocator, heap, sizeof(heap_t), 0);
 }
 
 int HeapPush(heap_t *heap, void *data)
@@ -90,8 +110,12 @@ int HeapPush(heap_t *heap, void *data)
     pushed_item_index = VectorSize(heap->vector);
 
     status = VectorPushBack(heap->vector, &data);
+    if (SUCCESS != status)
+    {
+        return status;
+    }
 
-    HeapifyUp(heap->vector, pushed_item_index, heap->cmp_func);
+    SiftUp(heap, GetHeapArray(heap), pushed_item_index, data);
 
     return status;
 }
@@ -105,24 +129,14 @@ void HeapPop(heap_t *heap)
         return;
     }
 
-    GetDataNSwap(heap->vector, HeapSize(heap), HEAP_ROOT);
-
-    VectorPopBack(heap->vector);
-
-    HeapifyDown(heap->vector, HEAP_ROOT, heap->cmp_func); 
+    EraseAt(heap, HEAP_ROOT);
 }
 
 void *HeapPeek(const heap_t *heap)
 {
-    void **data = NULL;
-    void *to_return = NULL;
-    
     assert(heap);
 
-    data = VectorGetAccessToElement(heap->vector, HEAP_ROOT);
-    to_return = *data;
-
-    return to_return;
+    return GetHeapArray(heap)[HEAP_ROOT];
 }
 
 size_t HeapSize(const heap_t *heap)
@@ -142,142 +156,266 @@ int IsHeapEmpty(const heap_t *heap)
 void *HeapRemove(heap_t *heap, heap_matchfunc_t match_func, const void *search_data)
 {
     size_t found_index = 0;
-    void **data_to_return = NULL;
-    void *temp = NULL;
 
     assert(heap);
     assert(match_func);
 
     found_index = FindElement(heap->vector, match_func, search_data);
 
-    if (0 != found_index)
+    return 0 != found_index ? EraseAt(heap, found_index) : NULL;
+}
+
+size_t HeapRemoveAll(heap_t *heap, heap_matchfunc_t match_func, 
+                        const void *search_data, heap_cleanfunc_t clean_func)
+{
+    size_t heap_size = 0;
+    size_t kept = 0;
+    size_t index = 0;
+    void **heap_arr = NULL;
+
+    assert(heap);
+    assert(match_func);
+
+    heap_size = HeapSize(heap);
+    heap_arr = GetHeapArray(heap);
+
+    for (index = HEAP_ROOT; index <= heap_size; ++index)
     {
-        data_to_return = VectorGetAccessToElement(heap->vector, found_index);
-        temp = *data_to_return;
-        GetDataNSwap(heap->vector, found_index, HeapSize(heap));
+        if (match_func(heap_arr[index], (void *)search_data))
+        {
+            if (NULL != heap->index_func)
+            {
+                heap->index_func(heap_arr[index], HEAP_NO_HANDLE);
+            }
+            if (NULL != clean_func)
+            {
+                clean_func(heap_arr[index]);
+            }
+        }
+        else
+        {
+            ++kept;
+            PlaceAt(heap, heap_arr, kept, heap_arr[index]);
+        }
+    }
 
+    for (index = kept; index < heap_size; ++index)
+    {
         VectorPopBack(heap->vector);
+    }
 
-        HeapifyDown(heap->vector, found_index, heap->cmp_func); 
+    /* Floyd's build: sift every parent down, deepest first */
+    heap_arr = GetHeapArray(heap);
+    for (index = PARENT_INDEX(kept); HEAP_ROOT <= index; --index)
+    {
+        SiftDown(heap, heap_arr, index, heap_arr[index]);
     }
 
-    return temp;
+    return heap_size - kept;
+}
+
+void *HeapFind(const heap_t *heap, heap_matchfunc_t match_func, const void *search_data)
+{
+    size_t found_index = 0;
+
+    assert(heap);
+    assert(match_func);
+
+    found_index = FindElement(heap->vector, match_func, search_data);
+
+    return 0 != found_index ? GetHeapArray(heap)[found_index] : NULL;
+}
+
+void HeapUpdate(heap_t *heap, size_t handle)
+{
+    assert(heap);
+    assert(heap->index_func);
+    assert(HEAP_ROOT <= handle && handle <= HeapSize(heap));
+
+    Resift(heap, handle);
+}
+
+void *HeapErase(heap_t *heap, size_t handle)
+{
+    assert(heap);
+    assert(heap->index_func);
+    assert(HEAP_ROOT <= handle && handle <= HeapSize(heap));
+
+    return EraseAt(heap, handle);
 }
 
 /**************************** ADVANCED FUNCTIONS *****************************/
 
 /*********************** STATIC FUNCTIONS DEFINITIONS ************************/
 
-static void HeapifyUp(vector_t *vector, size_t curr_index, heap_comparefunc_t cmp_func)
+/* 
+    All sifts move a hole instead of swapping: the elements on the way are
+    shifted once, and data is written once, in its final slot.
+*/
+static void SiftUp(heap_t *heap, void **heap_arr, size_t hole, void *data)
 {
-    int child = 0;
-
-    assert(vector);
-    assert(cmp_func);
+    assert(heap);
+    assert(heap_arr);
 
-    if (HEAP_ROOT >= curr_index)
+    while (HEAP_ROOT < hole 
+                && PARENT < heap->cmp_func(heap_arr[PARENT_INDEX(hole)], data))
     {
-        return;
+        PlaceAt(heap, heap_arr, hole, heap_arr[PARENT_INDEX(hole)]);
+        hole = PARENT_INDEX(hole);
     }
 
-    child = GetDataNCmp(vector, PARENT_INDEX(curr_index), curr_index, cmp_func);
-    if (PARENT < child)
+    PlaceAt(heap, heap_arr, hole, data);
+}
+
+static void SiftDown(heap_t *heap, void **heap_arr, size_t hole, void *data)
+{
+    size_t heap_size = HeapSize(heap);
+    size_t child = 0;
+
+    assert(heap);
+    assert(heap_arr);
+
+    while (LEFT_CHILD_INDEX(hole) <= heap_size)
     {
-        GetDataNSwap(vector, curr_index, PARENT_INDEX(curr_index));
-        HeapifyUp(vector, PARENT_INDEX(curr_index), cmp_func);
+        child = LEFT_CHILD_INDEX(hole);
+        if (child < heap_size 
+                && PARENT < heap->cmp_func(heap_arr[child], heap_arr[child + 1]))
+        {
+            ++child;
+        }
+
+        if (PARENT >= heap->cmp_func(data, heap_arr[child]))
+        {
+            break;
+        }
+
+        PlaceAt(heap, heap_arr, hole, heap_arr[child]);
+        hole = child;
     }
 
-    return;
+    PlaceAt(heap, heap_arr, hole, data);
 }
 
-static void HeapifyDown(vector_t *vector, size_t curr_index, heap_comparefunc_t cmp_func)
+/* 
+    Floyd's variant: data comes from the bottom of the heap, so it almost 
+    always belongs near the leaves. Walk the hole down to a leaf with one 
+    compare per level, then sift data up the few levels it needs.
+*/
+static void SiftDownBottomUp(heap_t *heap, void **heap_arr, size_t hole, void *data)
 {
-    size_t biggest_index = 0;
-
-    assert(vector);
-    assert(cmp_func);
+    size_t heap_size = HeapSize(heap);
+    size_t child = 0;
 
-    biggest_index = FindBigger(vector, curr_index, cmp_func);
+    assert(heap);
+    assert(heap_arr);
 
-    if(biggest_index > curr_index)
+    while (LEFT_CHILD_INDEX(hole) <= heap_size)
     {
-        GetDataNSwap(vector, curr_index, biggest_index);
-        HeapifyDown(vector, biggest_index, cmp_func);
+        child = LEFT_CHILD_INDEX(hole);
+        if (child < heap_size 
+                && PARENT < heap->cmp_func(heap_arr[child], heap_arr[child + 1]))
+        {
+            ++child;
+        }
+
+        PlaceAt(heap, heap_arr, hole, heap_arr[child]);
+        hole = child;
     }
+
+    SiftUp(heap, heap_arr, hole, data);
 }
 
-static size_t FindBigger(vector_t *vector, size_t curr_index, heap_comparefunc_t cmp_func)
+/* the element at curr_index may now belong above or below its slot */
+static void Resift(heap_t *heap, size_t curr_index)
 {
-    size_t biggest_index = curr_index;
-    size_t heap_size = VectorSize(vector) - DUMMY;
+    void **heap_arr = GetHeapArray(heap);
+    void *data = heap_arr[curr_index];
 
-    assert(vector);
-    assert(cmp_func);
+    assert(heap);
 
-    if (LEFT_CHILD_INDEX(curr_index) < heap_size 
-                && 0 < GetDataNCmp(vector, curr_index, LEFT_CHILD_INDEX(curr_index), cmp_func))
+    if (HEAP_ROOT < curr_index 
+                && PARENT < heap->cmp_func(heap_arr[PARENT_INDEX(curr_index)], data))
     {
-        biggest_index = LEFT_CHILD_INDEX(curr_index);
+        SiftUp(heap, heap_arr, curr_index, data);
     }
-
-    if (RIGHT_CHILD_INDEX(curr_index) < heap_size 
-                && 0 < GetDataNCmp(vector, biggest_index, RIGHT_CHILD_INDEX(curr_index), cmp_func))
+    else
     {
-        biggest_index = RIGHT_CHILD_INDEX(curr_index);
+        SiftDown(heap, heap_arr, curr_index, data);
     }
-
-    return biggest_index;
 }
 
-static int GetDataNCmp(vector_t *vector, size_t data1_index, size_t data2_index, heap_comparefunc_t cmp_func)
+/* fills the hole at index with the last element */
+static void *EraseAt(heap_t *heap, size_t index)
 {
-    void **data1 = VectorGetAccessToElement(vector, data1_index);
-    void **data2 = VectorGetAccessToElement(vector, data2_index);
+    size_t last_index = HeapSize(heap);
+    void **heap_arr = GetHeapArray(heap);
+    void *erased = heap_arr[index];
+    void *last = heap_arr[last_index];
 
-    assert(vector);
-    assert(cmp_func);
+    assert(heap);
+
+    VectorPopBack(heap->vector);
+    heap_arr = GetHeapArray(heap);
+
+    if (NULL != heap->index_func)
+    {
+        heap->index_func(erased, HEAP_NO_HANDLE);
+    }
+
+    if (index == last_index)
+    {
+        return erased;
+    }
+
+    if (HEAP_ROOT < index 
+                && PARENT < heap->cmp_func(heap_arr[PARENT_INDEX(index)], last))
+    {
+        SiftUp(heap, heap_arr, index, last);
+    }
+    else
+    {
+        SiftDownBottomUp(heap, heap_arr, index, last);
+    }
 
-    return cmp_func(*data1, *data2);
+    return erased;
 }
 
-static void GetDataNSwap(vector_t *vector, size_t data1_index, size_t data2_index)
+static void PlaceAt(heap_t *heap, void **heap_arr, size_t index, void *data)
 {
-    assert(vector);
+    heap_arr[index] = data;
 
-    SwapVoid(VectorGetAccessToElement(vector, data1_index), 
-                        VectorGetAccessToElement(vector, data2_index));
+    if (NULL != heap->index_func)
+    {
+        heap->index_func(data, index);
+    }
 }
 
-static void SwapVoid(void **element1, void **element2) 
+/* the vector is contiguous, work on it as a plain array of pointers */
+static void **GetHeapArray(const heap_t *heap)
 {
-	void *temp = NULL;
-
-	assert(NULL != element1);
-	assert(NULL != element2);
+    assert(heap);
 
-    temp = *element1;
-    *element1 = *element2;
-    *element2 = temp;
+    return (void **)VectorBegin(heap->vector);
 }
 
 static size_t FindElement(vector_t *vector, heap_matchfunc_t match_func, const void *search_data)
 {
-    size_t heap_size = VectorSize(vector);
-    size_t index = 1;
-    void **vector_data = NULL;
+    void **begin = NULL;
+    void **end = NULL;
+    void **curr = NULL;
 
     assert(vector);
     assert(match_func);
-    
-    while (index < heap_size)
-    {
-        vector_data = VectorGetAccessToElement(vector, index);
 
-        if (match_func(*vector_data, (void *)search_data))
-        {     
-            return index;
+    begin = (void **)VectorBegin(vector);
+    end = (void **)VectorEnd(vector);
+
+    for (curr = begin + HEAP_ROOT; curr != end; ++curr)
+    {
+        if (match_func(*curr, (void *)search_data))
+        {
+            return curr - begin;
         }
-        ++index;
     }
 
     return 0;
@@ -289,17 +427,12 @@ static size_t FindElement(vector_t *vector, heap_matchfunc_t match_func, const v
 #ifndef NDEBUG
     void PrintHeap(heap_t *heap)
     {
-        void **data = NULL;
-        int *temp = NULL;
-        size_t heap_size = HeapSize(heap);
-        size_t index = 1;
+        void **curr = (void **)VectorBegin(heap->vector) + HEAP_ROOT;
+        void **end = (void **)VectorEnd(heap->vector);
 
-        while (index <= heap_size)
+        for (; curr != end; ++curr)
         {
-            data = VectorGetAccessToElement(heap->vector, index);
-            temp = (int *)(*data);
-            printf("%d -> ", *temp);
-            ++index;
+            printf("%d -> ", *(int *)*curr);
         }
         printf("\n");
     }
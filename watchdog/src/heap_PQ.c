@@ -7,7 +7,7 @@
 /*************************** LIBRARY INCLUDES ******************************/
 #include <assert.h> /*asserts*/
 #include <stdio.h> /*printf */
-#include <stdlib.h> /* malloc free */
+#include <stddef.h> /* NULL */
 #include <string.h> /* memmove */
 
 /*************************** HEADER INCLUDES ******************************/
@@ -15,12 +15,14 @@
 #include <heap.h> /* our heap API */
 #include "heap_PQ.h"
 #include "vector.h"
+#include "allocator.h" /* AllocatorAlloc AllocatorFree */
 
 /************************** TYPEDEFS & STRUCTS ****************************/
 
 struct p_queue
 {
 	heap_t *heap;
+	const allocator_t *allocator;
 };
 
 /************************ STATIC FUNCTIONS DECLARATIONS **********************/
@@ -30,20 +32,53 @@ struct p_queue
 
 p_queue_t *PQueueCreate(priority_comparefunc_t func)
 {
-	p_queue_t *new_queue = (p_queue_t *)malloc(sizeof(p_queue_t));
+	return PQueueCreateIndexed(func, NULL);
+}
+
+p_queue_t *PQueueCreateKeyed(priority_comparefunc_t func, 
+				priority_keyfunc_t key_func, priority_handlefunc_t handle_func)
+{
+	return PQueueCreateWithAllocator(AllocatorGetDefault(), func, key_func, 
+															handle_func, NULL);
+}
+
+p_queue_t *PQueueCreateIntrusive(priority_comparefunc_t func, priority_keyfunc_t key_func,
+				priority_handlefunc_t handle_func, priority_linkfunc_t link_func)
+{
+	return PQueueCreateWithAllocator(AllocatorGetDefault(), func, key_func, 
+														handle_func, link_func);
+}
+
+p_queue_t *PQueueCreateIndexed(priority_comparefunc_t func, priority_handlefunc_t handle_func)
+{
+	return PQueueCreateWithAllocator(AllocatorGetDefault(), func, NULL, 
+															handle_func, NULL);
+}
+
+p_queue_t *PQueueCreateWithAllocator(const allocator_t *allocator, 
+				priority_comparefunc_t func, priority_keyfunc_t key_func,
+				priority_handlefunc_t handle_func, priority_linkfunc_t link_func)
+{
+	p_queue_t *new_queue = NULL;
+
+	(void)key_func;
+	(void)link_func;
+	assert(NULL != allocator);
+	assert(NULL != func);
+
+	new_queue = (p_queue_t *)AllocatorAlloc(allocator, sizeof(p_queue_t), 0);
 	if (NULL == new_queue)
 	{
 		return NULL;
 	}
 
-	assert(NULL != func);
-
-	new_queue->heap = HeapCreate(func);
+	new_queue->heap = HeapCreateWithAllocator(allocator, func, handle_func);
 	if (NULL == new_queue->heap)
 	{
-		free(new_queue);
+		AllocatorFree(allocator, new_queue, sizeof(p_queue_t), 0);
 		return NULL;
 	}
+	new_queue->allocator = allocator;
 
 	return new_queue;
 }
@@ -55,7 +90,7 @@ void PQueueDestroy(p_queue_t *queue)
 	HeapDestroy(queue->heap);
 	queue->heap = NULL;
 	
-	free(queue);
+	AllocatorFree(queue->allocator, queue, sizeof(p_queue_t), 0);
 }
 
 int PQueueEnqueue(p_queue_t *queue, void *data)
@@ -125,6 +160,40 @@ void *PQueueRemove(p_queue_t *queue, void *matchdata, priority_matchfunc_t match
 
 }
 
+size_t PQueueRemoveAll(p_queue_t *queue, void *matchdata, 
+                    priority_matchfunc_t matchfunc, priority_cleanfunc_t clean_func)
+{
+	assert(NULL != queue);
+	assert(NULL != matchfunc);
+
+	return HeapRemoveAll(queue->heap, matchfunc, matchdata, clean_func);
+}
+
+void *PQueueFind(p_queue_t *queue, void *matchdata, priority_matchfunc_t matchfunc)
+{
+	assert(NULL != queue);
+	assert(NULL != matchfunc);
+	assert(NULL != matchdata);
+
+	return HeapFind(queue->heap, matchfunc, matchdata);
+}
+
+int PQueueUpdate(p_queue_t *queue, size_t handle)
+{
+	assert(NULL != queue);
+
+	HeapUpdate(queue->heap, handle);
+
+	return 0;
+}
+
+void *PQueueErase(p_queue_t *queue, size_t handle)
+{
+	assert(NULL != queue);
+
+	return HeapErase(queue->heap, handle);
+}
+
 #ifndef NDEBUG
 	void PrintQueue(p_queue_t *queue)
 	{
@@ -0,0 +1,289 @@
+/*
+	Coder : Josh Benichou
+	Date : 02/07/2023
+	Reviewer : *****
+*/
+
+/*************************** LIBRARY INCLUDES ******************************/
+#include <assert.h> /*asserts*/
+#include <stdio.h> /*printf */
+#include <stddef.h> /* NULL */
+
+/*************************** HEADER INCLUDES ******************************/
+
+#include "keyed_heap_PQ.h" /* our priority queue API */
+#include "typed_containers.h" /* DEFINE_HEAP */
+#include "allocator.h" /* AllocatorAlloc AllocatorFree */
+
+/************************** TYPEDEFS & STRUCTS ****************************/
+
+typedef struct keyed_entry
+{
+	unsigned long key;
+	void *data;
+} entry_t;
+
+static void NotifyHandle(p_queue_t *queue, void *data, size_t handle);
+
+#define ENTRY_LESS(lhs, rhs) ((lhs).key < (rhs).key)
+#define ENTRY_MOVED(queue, entry, handle) \
+				NotifyHandle((p_queue_t *)(queue), (entry).data, (handle))
+
+DEFINE_HEAP(EntryHeap, entry_t, ENTRY_LESS, ENTRY_MOVED);
+
+struct p_queue
+{
+	EntryHeap_t *heap;
+	priority_keyfunc_t key_func;
+	priority_handlefunc_t handle_func;
+	const allocator_t *allocator;
+};
+
+/************************* API FUNCTIONS DEFINITIONS *************************/
+
+p_queue_t *PQueueCreate(priority_comparefunc_t func)
+{
+	return PQueueCreateKeyed(func, NULL, NULL);
+}
+
+p_queue_t *PQueueCreateIndexed(priority_comparefunc_t func, priority_handlefunc_t handle_func)
+{
+	return PQueueCreateKeyed(func, NULL, handle_func);
+}
+
+p_queue_t *PQueueCreateIntrusive(priority_comparefunc_t func, priority_keyfunc_t key_func,
+				priority_handlefunc_t handle_func, priority_linkfunc_t link_func)
+{
+	return PQueueCreateWithAllocator(AllocatorGetDefault(), func, key_func, 
+														handle_func, link_func);
+}
+
+p_queue_t *PQueueCreateKeyed(priority_comparefunc_t func,
+				priority_keyfunc_t key_func, priority_handlefunc_t handle_func)
+{
+	return PQueueCreateWithAllocator(AllocatorGetDefault(), func, key_func, 
+															handle_func, NULL);
+}
+
+p_queue_t *PQueueCreateWithAllocator(const allocator_t *allocator, 
+				priority_comparefunc_t func, priority_keyfunc_t key_func,
+				priority_handlefunc_t handle_func, priority_linkfunc_t link_func)
+{
+	p_queue_t *new_queue = NULL;
+
+	(void)func;
+	(void)link_func;
+	assert(NULL != allocator);
+	assert(NULL != func);
+
+	if (NULL == key_func)
+	{
+		return NULL;
+	}
+
+	new_queue = (p_queue_t *)AllocatorAlloc(allocator, sizeof(p_queue_t), 0);
+	if (NULL == new_queue)
+	{
+		return NULL;
+	}
+
+	new_queue->heap = EntryHeapCreateWithAllocator(allocator, new_queue);
+	if (NULL == new_queue->heap)
+	{
+		AllocatorFree(allocator, new_queue, sizeof(p_queue_t), 0);
+		return NULL;
+	}
+
+	new_queue->key_func = key_func;
+	new_queue->handle_func = handle_func;
+	new_queue->allocator = allocator;
+
+	return new_queue;
+}
+
+void PQueueDestroy(p_queue_t *queue)
+{
+	assert(NULL != queue);
+
+	EntryHeapDestroy(queue->heap);
+	queue->heap = NULL;
+
+	AllocatorFree(queue->allocator, queue, sizeof(p_queue_t), 0);
+}
+
+int PQueueEnqueue(p_queue_t *queue, void *data)
+{
+	entry_t entry = {0};
+
+	assert(NULL != queue);
+	assert(NULL != data);
+
+	entry.key = queue->key_func(data);
+	entry.data = data;
+
+	return 0 == EntryHeapPush(queue->heap, entry) ? 0 : -1;
+}
+
+void *PQueueDequeue(p_queue_t *queue)
+{
+	assert(NULL != queue);
+	assert(!EntryHeapIsEmpty(queue->heap));
+
+	return EntryHeapPop(queue->heap).data;
+}
+
+size_t PQueueSize(const p_queue_t *queue)
+{
+	assert(NULL != queue);
+
+	return EntryHeapSize(queue->heap);
+}
+
+void *PQueuePeek(p_queue_t *queue)
+{
+	assert(NULL != queue);
+	assert(!EntryHeapIsEmpty(queue->heap));
+
+	return EntryHeapPeek(queue->heap).data;
+}
+
+int IsPQueueEmpty(const p_queue_t *queue)
+{
+	assert(NULL != queue);
+
+	return EntryHeapIsEmpty(queue->heap);
+}
+
+void PQueueClear(p_queue_t *queue)
+{
+	assert(NULL != queue);
+
+	while (!EntryHeapIsEmpty(queue->heap))
+	{
+		EntryHeapErase(queue->heap, EntryHeapSize(queue->heap));
+	}
+}
+
+void *PQueueRemove(p_queue_t *queue, void *matchdata, priority_matchfunc_t matchfunc)
+{
+	entry_t *entries = NULL;
+	size_t index = 0;
+
+	assert(NULL != queue);
+	assert(NULL != matchfunc);
+	assert(NULL != matchdata);
+
+	entries = EntryHeapArray(queue->heap);
+	for (index = 0; index < EntryHeapSize(queue->heap); ++index)
+	{
+		if (matchfunc(entries[index].data, matchdata))
+		{
+			return EntryHeapErase(queue->heap, index + 1).data;
+		}
+	}
+
+	return NULL;
+}
+
+size_t PQueueRemoveAll(p_queue_t *queue, void *matchdata,
+                    priority_matchfunc_t matchfunc, priority_cleanfunc_t clean_func)
+{
+	entry_t *entries = NULL;
+	size_t size = 0;
+	size_t kept = 0;
+	size_t index = 0;
+
+	assert(NULL != queue);
+	assert(NULL != matchfunc);
+
+	entries = EntryHeapArray(queue->heap);
+	size = EntryHeapSize(queue->heap);
+
+	/* keep the survivors in front, then heapify them once */
+	for (index = 0; index < size; ++index)
+	{
+		if (matchfunc(entries[index].data, matchdata))
+		{
+			NotifyHandle(queue, entries[index].data, PQ_NO_HANDLE);
+			if (NULL != clean_func)
+			{
+				clean_func(entries[index].data);
+			}
+		}
+		else
+		{
+			entries[kept++] = entries[index];
+		}
+	}
+
+	EntryHeapRebuild(queue->heap, kept);
+
+	return size - kept;
+}
+
+void *PQueueFind(p_queue_t *queue, void *matchdata, priority_matchfunc_t matchfunc)
+{
+	entry_t *entries = NULL;
+	size_t index = 0;
+
+	assert(NULL != queue);
+	assert(NULL != matchfunc);
+	assert(NULL != matchdata);
+
+	entries = EntryHeapArray(queue->heap);
+	for (index = 0; index < EntryHeapSize(queue->heap); ++index)
+	{
+		if (matchfunc(entries[index].data, matchdata))
+		{
+			return entries[index].data;
+		}
+	}
+
+	return NULL;
+}
+
+int PQueueUpdate(p_queue_t *queue, size_t handle)
+{
+	entry_t *entry = NULL;
+
+	assert(NULL != queue);
+	assert(PQ_NO_HANDLE != handle);
+
+	entry = EntryHeapArray(queue->heap) + handle - 1;
+	entry->key = queue->key_func(entry->data);
+	EntryHeapUpdate(queue->heap, handle);
+
+	return 0;
+}
+
+void *PQueueErase(p_queue_t *queue, size_t handle)
+{
+	assert(NULL != queue);
+	assert(PQ_NO_HANDLE != handle);
+
+	return EntryHeapErase(queue->heap, handle).data;
+}
+
+#ifndef NDEBUG
+	void PrintQueue(p_queue_t *queue)
+	{
+		entry_t *entries = EntryHeapArray(queue->heap);
+		size_t index = 0;
+
+		for (index = 0; index < EntryHeapSize(queue->heap); ++index)
+		{
+			printf("%lu ", entries[index].key);
+		}
+		printf("\n");
+	}
+#endif
+
+/*********************** STATIC FUNCTIONS DEFINITIONS ************************/
+
+static void NotifyHandle(p_queue_t *queue, void *data, size_t handle)
+{
+	if (NULL != queue->handle_func)
+	{
+		queue->handle_func(data, handle);
+	}
+}
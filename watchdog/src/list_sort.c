@@ -0,0 +1,144 @@
+#include <stdlib.h> /* malloc free */
+#include <string.h> /* memcpy */
+#include <assert.h> /* assert */
+
+#include "list_sort.h" /* my functions */
+
+enum status {SUCCESS = 0, FAILURE = 1};
+
+/* runs this short are insertion sorted before the merges start */
+#define RUN_LENGTH (16)
+
+static int IsInOrder(void *before, void *after, sort_comparefunc_t func);
+static int IsArraySorted(void **data, size_t count, sort_comparefunc_t func);
+static void InsertionSort(void **data, size_t count, sort_comparefunc_t func);
+static void MergeRuns(void **from, void **to, size_t middle, size_t count, 
+														sort_comparefunc_t func);
+
+int ListSortArray(void **data, size_t count, sort_comparefunc_t func)
+{
+	void **buffer = NULL;
+	void **from = data;
+	void **to = NULL;
+	void **swap = NULL;
+	size_t width = 0;
+	size_t start = 0;
+
+	assert(NULL != data || 0 == count);
+	assert(NULL != func);
+
+	if (IsArraySorted(data, count, func))
+	{
+		return SUCCESS;
+	}
+
+	buffer = (void **)malloc(count * sizeof(void *));
+	if (NULL == buffer)
+	{
+		return FAILURE;
+	}
+
+	for (start = 0; start < count; start += RUN_LENGTH)
+	{
+		InsertionSort(data + start, RUN_LENGTH < count - start ? 
+										RUN_LENGTH : count - start, func);
+	}
+
+	/* bottom up, each pass merges pairs of runs into the other array */
+	to = buffer;
+	for (width = RUN_LENGTH; width < count; width *= 2)
+	{
+		for (start = 0; start < count; start += 2 * width)
+		{
+			MergeRuns(from + start, to + start, width < count - start ? 
+					width : count - start, 2 * width < count - start ? 
+									2 * width : count - start, func);
+		}
+
+		swap = from;
+		from = to;
+		to = swap;
+	}
+
+	if (from != data)
+	{
+		memcpy(data, from, count * sizeof(void *));
+	}
+
+	free(buffer);
+
+	return SUCCESS;
+}
+
+/* after may follow before in a sorted list when it is not bigger */
+static int IsInOrder(void *before, void *after, sort_comparefunc_t func)
+{
+	return 0 <= func(before, after);
+}
+
+static int IsArraySorted(void **data, size_t count, sort_comparefunc_t func)
+{
+	size_t index = 0;
+
+	for (index = 1; index < count; ++index)
+	{
+		if (!IsInOrder(data[index - 1], data[index], func))
+		{
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+static void InsertionSort(void **data, size_t count, sort_comparefunc_t func)
+{
+	void *current = NULL;
+	size_t index = 0;
+	size_t place = 0;
+
+	for (index = 1; index < count; ++index)
+	{
+		current = data[index];
+
+		for (place = index; 0 < place && !IsInOrder(data[place - 1], current, func); 
+																		--place)
+		{
+			data[place] = data[place - 1];
+		}
+		data[place] = current;
+	}
+}
+
+/*
+	Merges from[0, middle) and from[middle, count) into to. On equal
+	elements the left run goes first, which keeps the sort stable.
+*/
+static void MergeRuns(void **from, void **to, size_t middle, size_t count, 
+														sort_comparefunc_t func)
+{
+	size_t left = 0;
+	size_t right = middle;
+	size_t out = 0;
+
+	/* runs already in order are copied as they are */
+	if (middle == count || IsInOrder(from[middle - 1], from[middle], func))
+	{
+		memcpy(to, from, count * sizeof(void *));
+		return;
+	}
+
+	for (out = 0; out < count; ++out)
+	{
+		if (right == count || (left < middle && IsInOrder(from[left], from[right], func)))
+		{
+			to[out] = from[left];
+			++left;
+		}
+		else
+		{
+			to[out] = from[right];
+			++right;
+		}
+	}
+}
@@ -0,0 +1,228 @@
+#include <stddef.h> /* size_t */
+#include <assert.h> /* assert */
+
+#include "mpmc_queue.h" /* my functions */
+#include "allocator.h" /* AllocatorAlloc AllocatorFree */
+
+#define CACHE_LINE (64)
+#define MIN_CAPACITY (2)
+
+/* holds position + 1 once filled, position + capacity once emptied */
+typedef struct cell
+{
+	size_t sequence;
+	void *data;
+} cell_t;
+
+/* an index alone on its cache line */
+typedef union padded_index
+{
+	size_t value;
+	char pad[CACHE_LINE];
+} padded_index_t;
+
+/* allocated on a cache line, so each index has a line of its own */
+struct mpmc_queue
+{
+	padded_index_t enqueue_index;
+	padded_index_t dequeue_index;
+	cell_t *cells;
+	size_t mask; /* capacity - 1, a power of two - 1 */
+	const allocator_t *allocator;
+};
+
+static size_t ClaimRun(mpmc_queue_t *queue, size_t *index, size_t ready_offset,
+											size_t max, size_t *first);
+
+mpmc_queue_t *MPMCQueueCreate(size_t capacity)
+{
+	return MPMCQueueCreateWithAllocator(AllocatorGetDefault(), capacity);
+}
+
+mpmc_queue_t *MPMCQueueCreateWithAllocator(const allocator_t *allocator, size_t capacity)
+{
+	mpmc_queue_t *queue = NULL;
+	size_t rounded = MIN_CAPACITY;
+	size_t index = 0;
+
+	assert(NULL != allocator);
+
+	while (rounded < capacity)
+	{
+		rounded *= 2;
+	}
+
+	queue = (mpmc_queue_t *)AllocatorAlloc(allocator, sizeof(mpmc_queue_t), CACHE_LINE);
+	if (NULL == queue)
+	{
+		return NULL;
+	}
+
+	queue->cells = (cell_t *)AllocatorAlloc(allocator, rounded * sizeof(cell_t), CACHE_LINE);
+	if (NULL == queue->cells)
+	{
+		AllocatorFree(allocator, queue, sizeof(mpmc_queue_t), CACHE_LINE);
+		return NULL;
+	}
+
+	/* cell i is ready for the producer of position i */
+	for (index = 0; index < rounded; ++index)
+	{
+		queue->cells[index].sequence = index;
+		queue->cells[index].data = NULL;
+	}
+
+	queue->enqueue_index.value = 0;
+	queue->dequeue_index.value = 0;
+	queue->mask = rounded - 1;
+	queue->allocator = allocator;
+
+	return queue;
+}
+
+void MPMCQueueDestroy(mpmc_queue_t *queue)
+{
+	assert(NULL != queue);
+
+	AllocatorFree(queue->allocator, queue->cells,
+							(queue->mask + 1) * sizeof(cell_t), CACHE_LINE);
+	queue->cells = NULL;
+
+	AllocatorFree(queue->allocator, queue, sizeof(mpmc_queue_t), CACHE_LINE);
+}
+
+int MPMCQueueEnqueue(mpmc_queue_t *queue, void *data)
+{
+	return 1 != MPMCQueueEnqueueBatch(queue, &data, 1);
+}
+
+void *MPMCQueueDequeue(mpmc_queue_t *queue)
+{
+	void *data = NULL;
+
+	MPMCQueueDequeueBatch(queue, &data, 1);
+
+	return data;
+}
+
+size_t MPMCQueueEnqueueBatch(mpmc_queue_t *queue, void **data, size_t count)
+{
+	cell_t *cell = NULL;
+	size_t first = 0;
+	size_t run = 0;
+	size_t index = 0;
+
+	assert(NULL != queue);
+	assert(NULL != data || 0 == count);
+
+	run = ClaimRun(queue, &queue->enqueue_index.value, 0, count, &first);
+
+	for (index = 0; index < run; ++index)
+	{
+		assert(NULL != data[index]);
+
+		cell = &queue->cells[(first + index) & queue->mask];
+		cell->data = data[index];
+		__atomic_store_n(&cell->sequence, first + index + 1, __ATOMIC_RELEASE);
+	}
+
+	return run;
+}
+
+size_t MPMCQueueDequeueBatch(mpmc_queue_t *queue, void **data, size_t count)
+{
+	cell_t *cell = NULL;
+	size_t first = 0;
+	size_t run = 0;
+	size_t index = 0;
+
+	assert(NULL != queue);
+	assert(NULL != data || 0 == count);
+
+	run = ClaimRun(queue, &queue->dequeue_index.value, 1, count, &first);
+
+	for (index = 0; index < run; ++index)
+	{
+		cell = &queue->cells[(first + index) & queue->mask];
+		data[index] = cell->data;
+		/* ready for the producer one lap later */
+		__atomic_store_n(&cell->sequence, first + index + queue->mask + 1,
+															__ATOMIC_RELEASE);
+	}
+
+	return run;
+}
+
+size_t MPMCQueueSize(const mpmc_queue_t *queue)
+{
+	size_t dequeued = 0;
+	size_t enqueued = 0;
+
+	assert(NULL != queue);
+
+	/* dequeue first: the enqueue index read later cannot be behind it */
+	dequeued = __atomic_load_n(&queue->dequeue_index.value, __ATOMIC_RELAXED);
+	enqueued = __atomic_load_n(&queue->enqueue_index.value, __ATOMIC_RELAXED);
+
+	return enqueued - dequeued > queue->mask + 1 ? queue->mask + 1 : enqueued - dequeued;
+}
+
+size_t MPMCQueueCapacity(const mpmc_queue_t *queue)
+{
+	assert(NULL != queue);
+
+	return queue->mask + 1;
+}
+
+/*
+	Claims the longest run of positions, up to max, from *index on whose
+	cells hold their position + ready_offset, the producers' 0 or the
+	consumers' 1. A cell behind that means full / empty, ahead of it
+	means another thread claimed the position first.
+	The acquire load of a ready cell orders the access to its data after
+	the store that published it.
+*/
+static size_t ClaimRun(mpmc_queue_t *queue, size_t *index, size_t ready_offset,
+											size_t max, size_t *first)
+{
+	size_t position = __atomic_load_n(index, __ATOMIC_RELAXED);
+	cell_t *cell = NULL;
+	size_t sequence = 0;
+	size_t run = 0;
+	long diff = 0;
+
+	while (0 < max)
+	{
+		for (run = 0; run < max; ++run)
+		{
+			cell = &queue->cells[(position + run) & queue->mask];
+			sequence = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+			diff = (long)(sequence - (position + run + ready_offset));
+			if (0 != diff)
+			{
+				break;
+			}
+		}
+
+		if (0 < run)
+		{
+			/* on failure position is reloaded with the current index */
+			if (__atomic_compare_exchange_n(index, &position, position + run, 1,
+											__ATOMIC_RELAXED, __ATOMIC_RELAXED))
+			{
+				*first = position;
+				return run;
+			}
+		}
+		else if (0 > diff)
+		{
+			return 0;
+		}
+		else
+		{
+			position = __atomic_load_n(index, __ATOMIC_RELAXED);
+		}
+	}
+
+	return 0;
+}
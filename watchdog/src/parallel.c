@@ -0,0 +1,77 @@
+#define _GNU_SOURCE /* sysconf _SC_NPROCESSORS_ONLN */
+
+#include <stdlib.h> /* malloc free */
+#include <assert.h> /* assert */
+#include <pthread.h> /* pthread_create pthread_join */
+#include <unistd.h> /* sysconf */
+
+#include "parallel.h" /* my functions */
+
+typedef struct call
+{
+	parallel_func_t func;
+	void *arg;
+	pthread_t thread;
+	int is_started;
+} call_t;
+
+static void *RunCall(void *call);
+
+size_t ParallelThreads(void)
+{
+	long processors = sysconf(_SC_NPROCESSORS_ONLN);
+
+	return 0 < processors ? (size_t)processors : 1;
+}
+
+void ParallelRun(parallel_func_t func, void *args, size_t arg_size, size_t count)
+{
+	call_t *calls = NULL;
+	size_t index = 0;
+
+	assert(NULL != func);
+	assert(NULL != args || 0 == count);
+
+	calls = (call_t *)malloc(count * sizeof(call_t));
+	if (NULL == calls)
+	{
+		for (index = 0; index < count; ++index)
+		{
+			func((char *)args + index * arg_size);
+		}
+		return;
+	}
+
+	for (index = 0; index < count; ++index)
+	{
+		calls[index].func = func;
+		calls[index].arg = (char *)args + index * arg_size;
+		calls[index].is_started = 0 < index && 
+				0 == pthread_create(&calls[index].thread, NULL, RunCall, &calls[index]);
+	}
+
+	for (index = 0; index < count; ++index)
+	{
+		if (!calls[index].is_started)
+		{
+			func(calls[index].arg);
+		}
+	}
+
+	for (index = 0; index < count; ++index)
+	{
+		if (calls[index].is_started)
+		{
+			pthread_join(calls[index].thread, NULL);
+		}
+	}
+
+	free(calls);
+}
+
+static void *RunCall(void *call)
+{
+	((call_t *)call)->func(((call_t *)call)->arg);
+
+	return NULL;
+}
@@ -0,0 +1,418 @@
+#define _GNU_SOURCE /* mremap */
+
+/*************************** LIBRARY INCLUDES ******************************/
+#include <assert.h> /*asserts*/
+#include <errno.h> /* errno ENOENT EEXIST */
+#include <stdlib.h> /* mkstemp */
+#include <string.h> /* memcpy memcmp strlen */
+#include <fcntl.h> /* open */
+#include <unistd.h> /* close ftruncate fsync link unlink */
+#include <sys/mman.h> /* mmap mremap msync munmap */
+#include <sys/stat.h> /* fstat fchmod */
+
+/*************************** HEADER INCLUDES ******************************/
+
+#include "persistent_PQ.h" /* my functions */
+#include "allocator.h" /* AllocatorAlloc AllocatorFree */
+
+/************************** TYPEDEFS & STRUCTS ****************************/
+
+#define LOG_SLOT (0) /* heap.c's dummy */
+#define HEAP_ROOT (1)
+#define PARENT_INDEX(index) (index / 2)
+#define LEFT_CHILD_INDEX(index) (index * 2)
+#define HEADER_SIZE (64) /* the slots start on a cache line */
+#define RECORD_ALIGNMENT (8)
+#define MIN_CAPACITY (64) /* slots, slot 0 included */
+#define ROUND_UP(bytes, unit) (((bytes) + (unit) - 1) / (unit) * (unit))
+#define TEMP_SUFFIX (".XXXXXX") /* mkstemp() template */
+
+static const char g_magic[8] = "ILRDPPQ";
+
+/* the start of the file */
+typedef struct header
+{
+    char magic[8];              /* g_magic, in every queue file */
+    unsigned long version;
+    unsigned long record_size;
+    unsigned long capacity;     /* slots in the file, slot 0 included */
+    unsigned long size;         /* records in the heap */
+    unsigned long pending;      /* non 0 while an update is in flight */
+    unsigned long log_size;     /* size once the update is done */
+    unsigned long log_hole;     /* slot the record in slot 0 belongs in */
+} header_t;
+
+/* compiles only if the header fits before the slots */
+typedef char header_fits[sizeof(header_t) <= HEADER_SIZE ? 1 : -1];
+
+struct persistent_pq
+{
+    header_t *header;           /* start of the mapping */
+    size_t mapped_bytes;
+    size_t stride;              /* record size rounded up */
+    int fd;
+    persistent_comparefunc_t cmp_func;
+    const allocator_t *allocator;
+};
+
+/************************ STATIC FUNCTIONS DECLARATIONS **********************/
+
+static int Create(const char *path, size_t record_size,
+                                                const allocator_t *allocator);
+static int Format(int fd, size_t record_size);
+static int IsValid(const header_t *header, size_t record_size, size_t stride,
+                                                                off_t file_bytes);
+static size_t FileBytes(size_t capacity, size_t stride);
+static int Grow(persistent_pq_t *queue);
+static char *Slot(const persistent_pq_t *queue, size_t index);
+static void Begin(persistent_pq_t *queue, size_t hole, size_t size);
+static void MoveHole(persistent_pq_t *queue, size_t from, size_t to);
+static size_t SiftUp(persistent_pq_t *queue, size_t hole);
+static size_t SiftDown(persistent_pq_t *queue, size_t hole, size_t size);
+static void Commit(persistent_pq_t *queue);
+
+/************************* API FUNCTIONS DEFINITIONS *************************/
+
+persistent_pq_t *PersistentPQOpen(const char *path, size_t record_size,
+                                            persistent_comparefunc_t cmp_func)
+{
+    persistent_pq_t *queue = NULL;
+    const allocator_t *allocator = AllocatorGetDefault();
+    size_t stride = ROUND_UP(record_size, RECORD_ALIGNMENT);
+    struct stat file_stat;
+    header_t probe;
+    int fd = -1;
+
+    assert(NULL != path);
+    assert(0 < record_size);
+    assert(NULL != cmp_func);
+
+    /* an existing file is only ever read here, never made anew */
+    fd = open(path, O_RDWR);
+    if (-1 == fd && ENOENT == errno)
+    {
+        fd = Create(path, record_size, allocator);
+    }
+    if (-1 == fd)
+    {
+        return NULL;
+    }
+
+    memset(&probe, 0, sizeof(probe));
+    if (-1 == fstat(fd, &file_stat)
+            || (ssize_t)sizeof(probe) != pread(fd, &probe, sizeof(probe), 0)
+            || !IsValid(&probe, record_size, stride, file_stat.st_size))
+    {
+        close(fd);
+        return NULL;
+    }
+
+    queue = (persistent_pq_t *)AllocatorAlloc(allocator, sizeof(persistent_pq_t), 0);
+    if (NULL == queue)
+    {
+        close(fd);
+        return NULL;
+    }
+
+    queue->mapped_bytes = FileBytes(probe.capacity, stride);
+    queue->header = (header_t *)mmap(NULL, queue->mapped_bytes,
+                                PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (MAP_FAILED == (void *)queue->header)
+    {
+        AllocatorFree(allocator, queue, sizeof(persistent_pq_t), 0);
+        close(fd);
+        return NULL;
+    }
+    queue->stride = stride;
+    queue->fd = fd;
+    queue->cmp_func = cmp_func;
+    queue->allocator = allocator;
+
+    /* the record in slot 0 goes on from where it was left */
+    if (0 != queue->header->pending)
+    {
+        SiftDown(queue, SiftUp(queue, queue->header->log_hole),
+                                                    queue->header->log_size);
+        Commit(queue);
+    }
+
+    return queue;
+}
+
+void PersistentPQClose(persistent_pq_t *queue)
+{
+    assert(NULL != queue);
+
+    munmap(queue->header, queue->mapped_bytes);
+    queue->header = NULL;
+    close(queue->fd);
+
+    AllocatorFree(queue->allocator, queue, sizeof(persistent_pq_t), 0);
+}
+
+/* the new record starts as a hole after the last one */
+int PersistentPQEnqueue(persistent_pq_t *queue, const void *record)
+{
+    size_t size = 0;
+
+    assert(NULL != queue);
+    assert(NULL != record);
+
+    size = queue->header->size;
+    if (size + 1 >= queue->header->capacity && 0 != Grow(queue))
+    {
+        return -1;
+    }
+
+    memcpy(Slot(queue, LOG_SLOT), record, queue->header->record_size);
+    Begin(queue, size + 1, size + 1);
+
+    SiftUp(queue, size + 1);
+    Commit(queue);
+
+    return 0;
+}
+
+/* the last record starts as a hole at the root */
+int PersistentPQDequeue(persistent_pq_t *queue, void *record)
+{
+    size_t size = 0;
+
+    assert(NULL != queue);
+    assert(NULL != record);
+
+    size = queue->header->size;
+    if (0 == size)
+    {
+        return 1;
+    }
+
+    memcpy(record, Slot(queue, HEAP_ROOT), queue->header->record_size);
+
+    if (1 == size)
+    {
+        __atomic_store_n(&queue->header->size, 0, __ATOMIC_RELEASE);
+        return 0;
+    }
+
+    memcpy(Slot(queue, LOG_SLOT), Slot(queue, size), queue->header->record_size);
+    Begin(queue, HEAP_ROOT, size - 1);
+
+    SiftDown(queue, HEAP_ROOT, size - 1);
+    Commit(queue);
+
+    return 0;
+}
+
+const void *PersistentPQPeek(const persistent_pq_t *queue)
+{
+    assert(NULL != queue);
+
+    return 0 == queue->header->size ? NULL : Slot(queue, HEAP_ROOT);
+}
+
+size_t PersistentPQSize(const persistent_pq_t *queue)
+{
+    assert(NULL != queue);
+
+    return queue->header->size;
+}
+
+int IsPersistentPQEmpty(const persistent_pq_t *queue)
+{
+    assert(NULL != queue);
+
+    return 0 == queue->header->size;
+}
+
+int PersistentPQSync(persistent_pq_t *queue)
+{
+    assert(NULL != queue);
+
+    return msync(queue->header, queue->mapped_bytes, MS_SYNC);
+}
+
+/*********************** STATIC FUNCTIONS DEFINITIONS ************************/
+
+/*
+    The queue is made whole in a file of its own, then linked at path: path
+    is never a queue half made, and link() fails where rename() would
+    replace a file made there meanwhile. That file is opened instead.
+*/
+static int Create(const char *path, size_t record_size,
+                                                const allocator_t *allocator)
+{
+    size_t path_length = strlen(path);
+    size_t temp_bytes = path_length + sizeof(TEMP_SUFFIX);
+    char *temp_path = (char *)AllocatorAlloc(allocator, temp_bytes, 0);
+    int is_taken = 0;
+    int fd = -1;
+
+    if (NULL == temp_path)
+    {
+        return -1;
+    }
+    memcpy(temp_path, path, path_length);
+    memcpy(temp_path + path_length, TEMP_SUFFIX, sizeof(TEMP_SUFFIX));
+
+    fd = mkstemp(temp_path);
+    if (-1 == fd)
+    {
+        AllocatorFree(allocator, temp_path, temp_bytes, 0);
+        return -1;
+    }
+
+    /* mkstemp() gives 0600, the mode open() gave before */
+    if (0 != fchmod(fd, 0644) || 0 != Format(fd, record_size) 
+                                || 0 != fsync(fd) || 0 != link(temp_path, path))
+    {
+        is_taken = EEXIST == errno;
+        close(fd);
+        fd = is_taken ? open(path, O_RDWR) : -1;
+    }
+
+    unlink(temp_path);
+    AllocatorFree(allocator, temp_path, temp_bytes, 0);
+
+    return fd;
+}
+
+static int Format(int fd, size_t record_size)
+{
+    header_t header;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, g_magic, sizeof(g_magic));
+    header.version = PERSISTENT_PQ_VERSION;
+    header.record_size = record_size;
+    header.capacity = MIN_CAPACITY;
+
+    if (0 != ftruncate(fd, FileBytes(MIN_CAPACITY, ROUND_UP(record_size, RECORD_ALIGNMENT)))
+        || (ssize_t)sizeof(header) != pwrite(fd, &header, sizeof(header), 0))
+    {
+        return 1;
+    }
+
+    return 0;
+}
+
+static int IsValid(const header_t *header, size_t record_size, size_t stride,
+                                                                off_t file_bytes)
+{
+    return 0 == memcmp(header->magic, g_magic, sizeof(g_magic))
+            && PERSISTENT_PQ_VERSION == header->version
+            && record_size == header->record_size
+            && MIN_CAPACITY <= header->capacity
+            && header->size < header->capacity
+            && header->log_size < header->capacity
+            && header->log_hole < header->capacity
+            && (off_t)FileBytes(header->capacity, stride) <= file_bytes;
+}
+
+static size_t FileBytes(size_t capacity, size_t stride)
+{
+    return HEADER_SIZE + capacity * stride;
+}
+
+/* the file grows first: a crash before capacity is set only wastes room */
+static int Grow(persistent_pq_t *queue)
+{
+    size_t new_capacity = 2 * queue->header->capacity;
+    size_t new_bytes = FileBytes(new_capacity, queue->stride);
+    void *new_base = NULL;
+
+    if (0 != ftruncate(queue->fd, new_bytes))
+    {
+        return 1;
+    }
+
+#ifdef MREMAP_MAYMOVE
+    new_base = mremap(queue->header, queue->mapped_bytes, new_bytes, MREMAP_MAYMOVE);
+#else
+    new_base = mmap(NULL, new_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, queue->fd, 0);
+    if (MAP_FAILED != new_base)
+    {
+        munmap(queue->header, queue->mapped_bytes);
+    }
+#endif
+    if (MAP_FAILED == new_base)
+    {
+        return 1;
+    }
+
+    queue->header = (header_t *)new_base;
+    queue->mapped_bytes = new_bytes;
+    __atomic_store_n(&queue->header->capacity, new_capacity, __ATOMIC_RELEASE);
+
+    return 0;
+}
+
+static char *Slot(const persistent_pq_t *queue, size_t index)
+{
+    return (char *)queue->header + HEADER_SIZE + index * queue->stride;
+}
+
+/*
+    Slot 0 holds the moving record. Raising pending is the point from which
+    an open completes the update instead of ignoring it. The release
+    stores keep the compiler from moving the copies after them.
+*/
+static void Begin(persistent_pq_t *queue, size_t hole, size_t size)
+{
+    queue->header->log_size = size;
+    queue->header->log_hole = hole;
+    __atomic_store_n(&queue->header->pending, 1, __ATOMIC_RELEASE);
+}
+
+/* the record at from is copied into the hole, from becomes the hole */
+static void MoveHole(persistent_pq_t *queue, size_t from, size_t to)
+{
+    memcpy(Slot(queue, to), Slot(queue, from), queue->header->record_size);
+    __atomic_store_n(&queue->header->log_hole, from, __ATOMIC_RELEASE);
+}
+
+static size_t SiftUp(persistent_pq_t *queue, size_t hole)
+{
+    while (HEAP_ROOT < hole && 0 < queue->cmp_func(Slot(queue, PARENT_INDEX(hole)),
+                                                            Slot(queue, LOG_SLOT)))
+    {
+        MoveHole(queue, PARENT_INDEX(hole), hole);
+        hole = PARENT_INDEX(hole);
+    }
+
+    return hole;
+}
+
+static size_t SiftDown(persistent_pq_t *queue, size_t hole, size_t size)
+{
+    size_t child = 0;
+
+    while (LEFT_CHILD_INDEX(hole) <= size)
+    {
+        child = LEFT_CHILD_INDEX(hole);
+        if (child < size && 0 < queue->cmp_func(Slot(queue, child), Slot(queue, child + 1)))
+        {
+            ++child;
+        }
+
+        if (0 >= queue->cmp_func(Slot(queue, LOG_SLOT), Slot(queue, child)))
+        {
+            break;
+        }
+
+        MoveHole(queue, child, hole);
+        hole = child;
+    }
+
+    return hole;
+}
+
+/* writing slot 0 into the hole again after a crash changes nothing */
+static void Commit(persistent_pq_t *queue)
+{
+    header_t *header = queue->header;
+
+    memcpy(Slot(queue, header->log_hole), Slot(queue, LOG_SLOT), header->record_size);
+    __atomic_store_n(&header->size, header->log_size, __ATOMIC_RELEASE);
+    __atomic_store_n(&header->pending, 0, __ATOMIC_RELEASE);
+}
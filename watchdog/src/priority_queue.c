@@ -6,33 +6,76 @@
 
 
 #include<stdio.h> /* printf */
-#include <stdlib.h> /* malloc free */
+#include <stddef.h> /* NULL */
 #include <assert.h> /* asserts */
 
 #include "priority_queue.h" /* my functions */
 #include "sorted_linked_list.h" /* my functions */
+#include "allocator.h" /* AllocatorAlloc AllocatorFree */
 
 struct p_queue
 {
 	sorted_list_t *queue;
+	priority_handlefunc_t handle_func;
+	priority_linkfunc_t link_func;
+	const allocator_t *allocator;
 };
 
+static sorted_iter_t HandleToIter(p_queue_t *queue, size_t handle);
+static void NotifyHandle(p_queue_t *queue, void *data, size_t handle);
+
 p_queue_t *PQueueCreate(priority_comparefunc_t func)
 {
-	p_queue_t *new_queue = (p_queue_t *)malloc(sizeof(p_queue_t));
+	return PQueueCreateIndexed(func, NULL);
+}
+
+p_queue_t *PQueueCreateKeyed(priority_comparefunc_t func, 
+				priority_keyfunc_t key_func, priority_handlefunc_t handle_func)
+{
+	return PQueueCreateWithAllocator(AllocatorGetDefault(), func, key_func, 
+															handle_func, NULL);
+}
+
+p_queue_t *PQueueCreateIndexed(priority_comparefunc_t func, priority_handlefunc_t handle_func)
+{
+	return PQueueCreateWithAllocator(AllocatorGetDefault(), func, NULL, 
+															handle_func, NULL);
+}
+
+p_queue_t *PQueueCreateIntrusive(priority_comparefunc_t func, priority_keyfunc_t key_func,
+				priority_handlefunc_t handle_func, priority_linkfunc_t link_func)
+{
+	assert(NULL != link_func);
+
+	return PQueueCreateWithAllocator(AllocatorGetDefault(), func, key_func, 
+														handle_func, link_func);
+}
+
+p_queue_t *PQueueCreateWithAllocator(const allocator_t *allocator, 
+				priority_comparefunc_t func, priority_keyfunc_t key_func,
+				priority_handlefunc_t handle_func, priority_linkfunc_t link_func)
+{
+	p_queue_t *new_queue = NULL;
+
+	(void)key_func;
+	assert(NULL != allocator);
+	assert(NULL != func);
+
+	new_queue = (p_queue_t *)AllocatorAlloc(allocator, sizeof(p_queue_t), 0);
 	if (NULL == new_queue)
 	{
 		return NULL;
 	}
 
-	assert(NULL != func);
-
-	new_queue->queue = SortedListCreate(func);
+	new_queue->queue = SortedListCreateWithAllocator(allocator, func);
 	if (NULL == new_queue->queue)
 	{
-		free(new_queue);
+		AllocatorFree(allocator, new_queue, sizeof(p_queue_t), 0);
 		return NULL;
 	}
+	new_queue->handle_func = handle_func;
+	new_queue->link_func = link_func;
+	new_queue->allocator = allocator;
 
 	return new_queue;
 }
@@ -43,22 +86,38 @@ void PQueueDestroy(p_queue_t *queue)
 
 	SortedListDestroy(queue->queue);
 	queue->queue = NULL;
-	free(queue);
+	AllocatorFree(queue->allocator, queue, sizeof(p_queue_t), 0);
 }
 
 int PQueueEnqueue(p_queue_t *queue, void *data)
 {
+	sorted_iter_t inserted = {0};
+
 	assert(NULL != queue);
 	assert(NULL != data);
 
-	return NULL != SortedListInsert(queue->queue, data).iter ? 0 : -1 ;
+	inserted = NULL == queue->link_func ? SortedListInsert(queue->queue, data) :
+				SortedListInsertLink(queue->queue, queue->link_func(data), data);
+	if (IsSortedListIterEqual(inserted, SortedListEnd(queue->queue)))
+	{
+		return -1;
+	}
+
+	NotifyHandle(queue, data, (size_t)inserted.iter);
+
+	return 0;
 }
 
 void *PQueueDequeue(p_queue_t *queue)
 {
+	void *dequeued_data = NULL;
+
 	assert(NULL != queue);
 
-	return SortedListPopBack(queue->queue);
+	dequeued_data = SortedListPopBack(queue->queue);
+	NotifyHandle(queue, dequeued_data, PQ_NO_HANDLE);
+
+	return dequeued_data;
 }
 
 size_t PQueueSize(const p_queue_t *queue)
@@ -108,12 +167,90 @@ void *PQueueRemove(p_queue_t *queue, void *matchdata, priority_matchfunc_t match
 	if (0 == IsSortedListIterEqual(found, SortedListEnd(queue->queue)))
 	{
 		removed_data = SortedListGetData(found);
-		SortedListRemove(found);
+		SortedListRemove(queue->queue, found);
+		NotifyHandle(queue, removed_data, PQ_NO_HANDLE);
 	}
 
 	return removed_data;
 }
 
+size_t PQueueRemoveAll(p_queue_t *queue, void *matchdata, 
+                    priority_matchfunc_t matchfunc, priority_cleanfunc_t clean_func)
+{
+	sorted_iter_t runner = {0};
+	void *removed_data = NULL;
+	size_t removed = 0;
+
+	assert(NULL != queue);
+	assert(NULL != matchfunc);
+
+	runner = SortedListBegin(queue->queue);
+	while (0 == IsSortedListIterEqual(runner, SortedListEnd(queue->queue)))
+	{
+		removed_data = SortedListGetData(runner);
+		if (matchfunc(removed_data, matchdata))
+		{
+			runner = SortedListRemove(queue->queue, runner);
+			NotifyHandle(queue, removed_data, PQ_NO_HANDLE);
+			if (NULL != clean_func)
+			{
+				clean_func(removed_data);
+			}
+			++removed;
+		}
+		else
+		{
+			runner = SortedListNext(runner);
+		}
+	}
+
+	return removed;
+}
+
+void *PQueueFind(p_queue_t *queue, void *matchdata, priority_matchfunc_t matchfunc)
+{
+	sorted_iter_t found = {0};
+
+	assert(NULL != queue);
+	assert(NULL != matchfunc);
+	assert(NULL != matchdata);
+
+	found = SortedListFindIf(SortedListBegin(queue->queue), 
+							SortedListEnd(queue->queue), matchdata, matchfunc);
+
+	return IsSortedListIterEqual(found, SortedListEnd(queue->queue)) ? 
+											NULL : SortedListGetData(found);
+}
+
+/* the node is moved, not freed and made again: the handle stays */
+int PQueueUpdate(p_queue_t *queue, size_t handle)
+{
+	assert(NULL != queue);
+	assert(NULL != queue->handle_func);
+	assert(PQ_NO_HANDLE != handle);
+
+	SortedListResort(queue->queue, HandleToIter(queue, handle));
+
+	return 0;
+}
+
+void *PQueueErase(p_queue_t *queue, size_t handle)
+{
+	sorted_iter_t to_erase = {0};
+	void *erased_data = NULL;
+
+	assert(NULL != queue);
+	assert(NULL != queue->handle_func);
+	assert(PQ_NO_HANDLE != handle);
+
+	to_erase = HandleToIter(queue, handle);
+	erased_data = SortedListGetData(to_erase);
+	SortedListRemove(queue->queue, to_erase);
+	NotifyHandle(queue, erased_data, PQ_NO_HANDLE);
+
+	return erased_data;
+}
+
 void PQueuePrint(const p_queue_t *queue)
 {
 	assert(NULL != queue);
@@ -124,4 +261,22 @@ void PQueuePrint(const p_queue_t *queue)
 sorted_list_t *GetListInQueue(p_queue_t *queue)
 {
 	return queue->queue;
+}
+
+/* list nodes never move, so a node address is a stable handle */
+static sorted_iter_t HandleToIter(p_queue_t *queue, size_t handle)
+{
+	sorted_iter_t iterator = SortedListBegin(queue->queue);
+
+	iterator.iter = (dll_iterator_t)handle;
+
+	return iterator;
+}
+
+static void NotifyHandle(p_queue_t *queue, void *data, size_t handle)
+{
+	if (NULL != queue->handle_func && NULL != data)
+	{
+		queue->handle_func(data, handle);
+	}
 }
\ No newline at end of file
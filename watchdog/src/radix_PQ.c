@@ -0,0 +1,501 @@
+/*
+	Coder : Josh Benichou
+	Date : 02/07/2023
+	Reviewer : *****
+*/
+
+/*************************** LIBRARY INCLUDES ******************************/
+#include <assert.h> /*asserts*/
+#include <limits.h> /* CHAR_BIT */
+#include <stdio.h> /*printf */
+#include <stddef.h> /* NULL */
+
+/*************************** HEADER INCLUDES ******************************/
+
+#include "radix_PQ.h" /* our priority queue API */
+#include "vector.h" /* our vector API */
+#include "allocator.h" /* AllocatorAlloc AllocatorFree */
+
+/************************** TYPEDEFS & STRUCTS ****************************/
+
+/*
+	Bucket 0 holds the elements whose key equals last_key, bucket i > 0 the
+	ones whose highest bit differing from last_key is bit i - 1.
+*/
+#define NUM_OF_BUCKETS (sizeof(unsigned long) * CHAR_BIT + 1)
+#define INIT_BUCKET_CAPACITY (4)
+
+/* a handle packs the bucket in the low bits and the slot + 1 above them */
+#define BUCKET_BITS (7)
+#define BUCKET_MASK ((1UL << BUCKET_BITS) - 1)
+#define TO_HANDLE(bucket, slot) ((((slot) + 1) << BUCKET_BITS) | (bucket))
+#define HANDLE_BUCKET(handle) ((handle) & BUCKET_MASK)
+#define HANDLE_SLOT(handle) (((handle) >> BUCKET_BITS) - 1)
+
+typedef struct radix_entry
+{
+	unsigned long key;
+	void *data;
+} entry_t;
+
+struct p_queue
+{
+	vector_t *buckets[NUM_OF_BUCKETS];
+	unsigned long last_key;
+	size_t size;
+	priority_keyfunc_t key_func;
+	priority_handlefunc_t handle_func;
+	const allocator_t *allocator;
+};
+
+/************************ STATIC FUNCTIONS DECLARATIONS **********************/
+
+static int Insert(p_queue_t *queue, void *data, unsigned long key);
+static void *EraseAt(p_queue_t *queue, size_t bucket, size_t slot);
+static void FillFirstBucket(p_queue_t *queue);
+static size_t BucketOf(unsigned long last_key, unsigned long key);
+static entry_t *GetEntries(const p_queue_t *queue, size_t bucket);
+static void NotifyHandle(p_queue_t *queue, void *data, size_t handle);
+
+/************************* API FUNCTIONS DEFINITIONS *************************/
+
+p_queue_t *PQueueCreate(priority_comparefunc_t func)
+{
+	return PQueueCreateKeyed(func, NULL, NULL);
+}
+
+p_queue_t *PQueueCreateIndexed(priority_comparefunc_t func, priority_handlefunc_t handle_func)
+{
+	return PQueueCreateKeyed(func, NULL, handle_func);
+}
+
+p_queue_t *PQueueCreateIntrusive(priority_comparefunc_t func, priority_keyfunc_t key_func,
+				priority_handlefunc_t handle_func, priority_linkfunc_t link_func)
+{
+	return PQueueCreateWithAllocator(AllocatorGetDefault(), func, key_func, 
+														handle_func, link_func);
+}
+
+p_queue_t *PQueueCreateKeyed(priority_comparefunc_t func,
+				priority_keyfunc_t key_func, priority_handlefunc_t handle_func)
+{
+	return PQueueCreateWithAllocator(AllocatorGetDefault(), func, key_func, 
+															handle_func, NULL);
+}
+
+p_queue_t *PQueueCreateWithAllocator(const allocator_t *allocator, 
+				priority_comparefunc_t func, priority_keyfunc_t key_func,
+				priority_handlefunc_t handle_func, priority_linkfunc_t link_func)
+{
+	p_queue_t *new_queue = NULL;
+	size_t bucket = 0;
+
+	(void)func;
+	(void)link_func;
+	assert(NULL != allocator);
+	assert(NULL != func);
+
+	if (NULL == key_func)
+	{
+		return NULL;
+	}
+
+	new_queue = (p_queue_t *)AllocatorAlloc(allocator, sizeof(p_queue_t), 0);
+	if (NULL == new_queue)
+	{
+		return NULL;
+	}
+
+	for (bucket = 0; bucket < NUM_OF_BUCKETS; ++bucket)
+	{
+		new_queue->buckets[bucket] = VectorCreateWithAllocator(allocator, 
+										INIT_BUCKET_CAPACITY, sizeof(entry_t), 0);
+		if (NULL == new_queue->buckets[bucket])
+		{
+			while (0 < bucket)
+			{
+				VectorDestroy(new_queue->buckets[--bucket]);
+			}
+			AllocatorFree(allocator, new_queue, sizeof(p_queue_t), 0);
+			return NULL;
+		}
+	}
+
+	new_queue->last_key = 0;
+	new_queue->size = 0;
+	new_queue->key_func = key_func;
+	new_queue->handle_func = handle_func;
+	new_queue->allocator = allocator;
+
+	return new_queue;
+}
+
+void PQueueDestroy(p_queue_t *queue)
+{
+	size_t bucket = 0;
+
+	assert(NULL != queue);
+
+	for (bucket = 0; bucket < NUM_OF_BUCKETS; ++bucket)
+	{
+		VectorDestroy(queue->buckets[bucket]);
+		queue->buckets[bucket] = NULL;
+	}
+
+	AllocatorFree(queue->allocator, queue, sizeof(p_queue_t), 0);
+}
+
+int PQueueEnqueue(p_queue_t *queue, void *data)
+{
+	assert(NULL != queue);
+	assert(NULL != data);
+
+	if (0 != Insert(queue, data, queue->key_func(data)))
+	{
+		return -1;
+	}
+	++queue->size;
+
+	return 0;
+}
+
+void *PQueueDequeue(p_queue_t *queue)
+{
+	vector_t *first_bucket = NULL;
+	void *dequeued_data = NULL;
+
+	assert(NULL != queue);
+	assert(0 < queue->size);
+
+	FillFirstBucket(queue);
+
+	first_bucket = queue->buckets[0];
+	dequeued_data = GetEntries(queue, 0)[VectorSize(first_bucket) - 1].data;
+	VectorPopBack(first_bucket);
+	--queue->size;
+
+	NotifyHandle(queue, dequeued_data, PQ_NO_HANDLE);
+
+	return dequeued_data;
+}
+
+size_t PQueueSize(const p_queue_t *queue)
+{
+	assert(NULL != queue);
+
+	return queue->size;
+}
+
+void *PQueuePeek(p_queue_t *queue)
+{
+	assert(NULL != queue);
+	assert(0 < queue->size);
+
+	FillFirstBucket(queue);
+
+	return GetEntries(queue, 0)[VectorSize(queue->buckets[0]) - 1].data;
+}
+
+int IsPQueueEmpty(const p_queue_t *queue)
+{
+	assert(NULL != queue);
+
+	return 0 == queue->size;
+}
+
+void PQueueClear(p_queue_t *queue)
+{
+	size_t bucket = 0;
+
+	assert(NULL != queue);
+
+	for (bucket = 0; bucket < NUM_OF_BUCKETS; ++bucket)
+	{
+		while (0 < VectorSize(queue->buckets[bucket]))
+		{
+			NotifyHandle(queue, EraseAt(queue, bucket, 
+						VectorSize(queue->buckets[bucket]) - 1), PQ_NO_HANDLE);
+		}
+	}
+}
+
+void *PQueueRemove(p_queue_t *queue, void *matchdata, priority_matchfunc_t matchfunc)
+{
+	entry_t *entries = NULL;
+	void *removed_data = NULL;
+	size_t bucket = 0;
+	size_t slot = 0;
+
+	assert(NULL != queue);
+	assert(NULL != matchfunc);
+	assert(NULL != matchdata);
+
+	for (bucket = 0; bucket < NUM_OF_BUCKETS; ++bucket)
+	{
+		entries = GetEntries(queue, bucket);
+		for (slot = 0; slot < VectorSize(queue->buckets[bucket]); ++slot)
+		{
+			if (matchfunc(entries[slot].data, matchdata))
+			{
+				removed_data = EraseAt(queue, bucket, slot);
+				NotifyHandle(queue, removed_data, PQ_NO_HANDLE);
+
+				return removed_data;
+			}
+		}
+	}
+
+	return NULL;
+}
+
+size_t PQueueRemoveAll(p_queue_t *queue, void *matchdata,
+                    priority_matchfunc_t matchfunc, priority_cleanfunc_t clean_func)
+{
+	void *removed_data = NULL;
+	size_t removed = 0;
+	size_t bucket = 0;
+	size_t slot = 0;
+
+	assert(NULL != queue);
+	assert(NULL != matchfunc);
+
+	for (bucket = 0; bucket < NUM_OF_BUCKETS; ++bucket)
+	{
+		/* backwards: EraseAt() fills the slot from the back of the bucket */
+		for (slot = VectorSize(queue->buckets[bucket]); 0 < slot; --slot)
+		{
+			removed_data = GetEntries(queue, bucket)[slot - 1].data;
+			if (matchfunc(removed_data, matchdata))
+			{
+				EraseAt(queue, bucket, slot - 1);
+				NotifyHandle(queue, removed_data, PQ_NO_HANDLE);
+				if (NULL != clean_func)
+				{
+					clean_func(removed_data);
+				}
+				++removed;
+			}
+		}
+	}
+
+	return removed;
+}
+
+void *PQueueFind(p_queue_t *queue, void *matchdata, priority_matchfunc_t matchfunc)
+{
+	entry_t *entries = NULL;
+	size_t bucket = 0;
+	size_t slot = 0;
+
+	assert(NULL != queue);
+	assert(NULL != matchfunc);
+	assert(NULL != matchdata);
+
+	for (bucket = 0; bucket < NUM_OF_BUCKETS; ++bucket)
+	{
+		entries = GetEntries(queue, bucket);
+		for (slot = 0; slot < VectorSize(queue->buckets[bucket]); ++slot)
+		{
+			if (matchfunc(entries[slot].data, matchdata))
+			{
+				return entries[slot].data;
+			}
+		}
+	}
+
+	return NULL;
+}
+
+int PQueueUpdate(p_queue_t *queue, size_t handle)
+{
+	void *data = NULL;
+
+	assert(NULL != queue);
+	assert(PQ_NO_HANDLE != handle);
+
+	data = EraseAt(queue, HANDLE_BUCKET(handle), HANDLE_SLOT(handle));
+	if (0 != Insert(queue, data, queue->key_func(data)))
+	{
+		NotifyHandle(queue, data, PQ_NO_HANDLE);
+		return -1;
+	}
+	++queue->size;
+
+	return 0;
+}
+
+void *PQueueErase(p_queue_t *queue, size_t handle)
+{
+	void *erased_data = NULL;
+
+	assert(NULL != queue);
+	assert(PQ_NO_HANDLE != handle);
+
+	erased_data = EraseAt(queue, HANDLE_BUCKET(handle), HANDLE_SLOT(handle));
+	NotifyHandle(queue, erased_data, PQ_NO_HANDLE);
+
+	return erased_data;
+}
+
+/*********************** STATIC FUNCTIONS DEFINITIONS ************************/
+
+static int Insert(p_queue_t *queue, void *data, unsigned long key)
+{
+	entry_t entry = {0};
+	size_t bucket = 0;
+
+	assert(NULL != queue);
+
+	/* overdue, it comes out with the elements due now */
+	entry.key = key < queue->last_key ? queue->last_key : key;
+	entry.data = data;
+
+	bucket = BucketOf(queue->last_key, entry.key);
+	if (0 != VectorPushBack(queue->buckets[bucket], &entry))
+	{
+		return -1;
+	}
+
+	NotifyHandle(queue, data, TO_HANDLE(bucket, VectorSize(queue->buckets[bucket]) - 1));
+
+	return 0;
+}
+
+/* the last entry of the bucket takes the place of the erased one */
+static void *EraseAt(p_queue_t *queue, size_t bucket, size_t slot)
+{
+	entry_t *entries = GetEntries(queue, bucket);
+	size_t last_slot = VectorSize(queue->buckets[bucket]) - 1;
+	void *erased_data = NULL;
+
+	assert(NULL != queue);
+	assert(slot <= last_slot);
+
+	erased_data = entries[slot].data;
+
+	if (slot != last_slot)
+	{
+		entries[slot] = entries[last_slot];
+		NotifyHandle(queue, entries[slot].data, TO_HANDLE(bucket, slot));
+	}
+
+	VectorPopBack(queue->buckets[bucket]);
+	--queue->size;
+
+	return erased_data;
+}
+
+/*
+	Moves last_key up to the smallest key, and spreads the first non empty
+	bucket below it. Every element moves to a strictly lower bucket, so
+	each one is moved at most once per bit of its key.
+*/
+static void FillFirstBucket(p_queue_t *queue)
+{
+	entry_t *entries = NULL;
+	entry_t entry = {0};
+	size_t bucket = 0;
+	size_t bucket_size = 0;
+	size_t slot = 0;
+	size_t new_bucket = 0;
+
+	assert(NULL != queue);
+
+	if (0 < VectorSize(queue->buckets[0]))
+	{
+		return;
+	}
+
+	for (bucket = 1; 0 == VectorSize(queue->buckets[bucket]); ++bucket)
+	{
+		assert(bucket < NUM_OF_BUCKETS - 1);
+	}
+
+	entries = GetEntries(queue, bucket);
+	bucket_size = VectorSize(queue->buckets[bucket]);
+
+	queue->last_key = entries[0].key;
+	for (slot = 1; slot < bucket_size; ++slot)
+	{
+		if (entries[slot].key < queue->last_key)
+		{
+			queue->last_key = entries[slot].key;
+		}
+	}
+
+	while (0 < bucket_size)
+	{
+		entry = GetEntries(queue, bucket)[bucket_size - 1];
+
+		new_bucket = BucketOf(queue->last_key, entry.key);
+		assert(new_bucket < bucket);
+
+		/* out of memory: leave the rest in place, still >= last_key */
+		if (0 != VectorPushBack(queue->buckets[new_bucket], &entry))
+		{
+			return;
+		}
+		VectorPopBack(queue->buckets[bucket]);
+		--bucket_size;
+
+		NotifyHandle(queue, entry.data,
+				TO_HANDLE(new_bucket, VectorSize(queue->buckets[new_bucket]) - 1));
+	}
+}
+
+/* number of significant bits in last_key ^ key */
+static size_t BucketOf(unsigned long last_key, unsigned long key)
+{
+	unsigned long diff = last_key ^ key;
+	size_t bucket = 0;
+
+	#ifdef __GNUC__
+		if (0 != diff)
+		{
+			bucket = NUM_OF_BUCKETS - 1 - __builtin_clzl(diff);
+		}
+	#else
+		while (0 != diff)
+		{
+			diff >>= 1;
+			++bucket;
+		}
+	#endif
+
+	return bucket;
+}
+
+static entry_t *GetEntries(const p_queue_t *queue, size_t bucket)
+{
+	assert(NULL != queue);
+
+	return (entry_t *)VectorBegin(queue->buckets[bucket]);
+}
+
+static void NotifyHandle(p_queue_t *queue, void *data, size_t handle)
+{
+	if (NULL != queue->handle_func)
+	{
+		queue->handle_func(data, handle);
+	}
+}
+
+/*************************** DEBUG UTILS  ****************************/
+
+#ifndef NDEBUG
+	void PrintQueue(p_queue_t *queue)
+	{
+		size_t bucket = 0;
+
+		printf("last key %lu : ", queue->last_key);
+		for (bucket = 0; bucket < NUM_OF_BUCKETS; ++bucket)
+		{
+			if (0 < VectorSize(queue->buckets[bucket]))
+			{
+				printf("[%lu] %lu  ", (unsigned long)bucket,
+								(unsigned long)VectorSize(queue->buckets[bucket]));
+			}
+		}
+		printf("\n");
+	}
+#endif
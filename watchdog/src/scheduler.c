@@ -6,13 +6,14 @@
 
 #include <stdio.h> /* printf fscanf */
 #include <assert.h> /* asserts */
-#include <stdlib.h> /* malloc free */
 #include <unistd.h> /* sleep time */
 #include <string.h> /* strcmp */
 
 #include "scheduler.h" /* our scheduler functions */
 #include "priority_queue.h" /* our priority queue functions */
 #include "task.h" /* our task functions */
+#include "uid_map.h" /* our uid map functions */
+#include "allocator.h" /* AllocatorAlloc AllocatorFree */
 
 /* #define STOP_SIGNAL (0) */
 #define SUCCESS (0)
@@ -21,27 +22,59 @@
 struct scheduler
 {
     p_queue_t *tasks_pq;
+    uid_map_t *tasks_by_uid; /* the queued tasks that are not cancelled */
     int can_run_flag;
+    size_t cancelled_count;
+    double max_cancelled_ratio;
+    const allocator_t *allocator;
 };
 
 static int TimePriority(const void *queue_data, void *new_data);
-static int FindTask(const void *queue_data, void *uid);
+static void SetTaskHandle(void *queue_data, size_t handle);
+static unsigned long TimeKey(const void *queue_data);
+static dll_link_t *GetTaskLink(void *queue_data);
+static int IsCancelled(const void *queue_data, void *unused);
+static void DestroyTask(void *queue_data);
+static void DropCancelledIfNeeded(scheduler_t *scheduler);
+static int QueueTask(scheduler_t *scheduler, task_t *task);
 
 scheduler_t *SchedulerCreate(void)
 {
-	scheduler_t *scheduler = (scheduler_t *)malloc(sizeof(scheduler_t));
+	return SchedulerCreateWithAllocator(AllocatorGetDefault());
+}
+
+scheduler_t *SchedulerCreateWithAllocator(const allocator_t *allocator)
+{
+	scheduler_t *scheduler = NULL;
+
+	assert(NULL != allocator);
+
+	scheduler = (scheduler_t *)AllocatorAlloc(allocator, sizeof(scheduler_t), 0);
 	if (NULL == scheduler)
 	{
 		return NULL;
 	}
 
-	scheduler->tasks_pq = PQueueCreate(&TimePriority);
+	/* tasks carry their own queue links, queuing them allocates nothing */
+	scheduler->tasks_pq = PQueueCreateWithAllocator(allocator, &TimePriority, 
+								&TimeKey, &SetTaskHandle, &GetTaskLink);
 	if (NULL == scheduler->tasks_pq)
 	{
-		free(scheduler);
+		AllocatorFree(allocator, scheduler, sizeof(scheduler_t), 0);
 		return NULL;
 	}
+
+	scheduler->tasks_by_uid = UIDMapCreateWithAllocator(allocator, 0);
+	if (NULL == scheduler->tasks_by_uid)
+	{
+		PQueueDestroy(scheduler->tasks_pq);
+		AllocatorFree(allocator, scheduler, sizeof(scheduler_t), 0);
+		return NULL;
+	}
+	scheduler->allocator = allocator;
 	scheduler->can_run_flag = ALLOWED_TO_RUN;
+	scheduler->cancelled_count = 0;
+	scheduler->max_cancelled_ratio = DEFAULT_CANCELLED_RATIO;
 
 	return scheduler;
 }
@@ -55,7 +88,10 @@ void SchedulerDestroy(scheduler_t *scheduler)
 	PQueueDestroy(scheduler->tasks_pq);
 	scheduler->tasks_pq = NULL;
 
-	free(scheduler);
+	UIDMapDestroy(scheduler->tasks_by_uid);
+	scheduler->tasks_by_uid = NULL;
+
+	AllocatorFree(scheduler->allocator, scheduler, sizeof(scheduler_t), 0);
 }
 
 ilrd_uid_t SchedulerAdd(scheduler_t *scheduler
@@ -70,44 +106,86 @@ ilrd_uid_t SchedulerAdd(scheduler_t *scheduler
 	assert(NULL != params);
 	assert(NULL != clean_func);
 
-	task = TaskCreate(task_func, clean_func, params, time_to_run, time_interval);
+	task = TaskCreateWithAllocator(scheduler->allocator, task_func, clean_func, 
+											params, time_to_run, time_interval);
 	if (NULL == task)
 	{	
 		return GetBadUID();
 	}
 
-	return SUCCESS == PQueueEnqueue(scheduler->tasks_pq, task) ? 
-												TaskGetUID(task) : GetBadUID();
+	if (SUCCESS != QueueTask(scheduler, task))
+	{
+		TaskDestroy(task);
+		return GetBadUID();
+	}
+
+	return TaskGetUID(task);
 }
 
 int SchedulerRemove(scheduler_t *scheduler, ilrd_uid_t uid)
 {
-	void *data = NULL;
-	int status = FAILURE;
+	task_t *task = NULL;
+
 	assert(NULL != scheduler);
 
-	data = PQueueRemove(scheduler->tasks_pq, &uid, &FindTask);
-	if (NULL != data)
+	task = (task_t *)UIDMapRemove(scheduler->tasks_by_uid, uid);
+	if (NULL == task)
 	{
-		TaskDestroy((task_t *)data);
-		status = SUCCESS;
+		return FAILURE;
 	}
 
-	return status;
+	TaskCancel(task);
+	++scheduler->cancelled_count;
+
+	DropCancelledIfNeeded(scheduler);
+
+	return SUCCESS;
+}
+
+void SchedulerSetCancelledRatio(scheduler_t *scheduler, double ratio)
+{
+	assert(NULL != scheduler);
+	assert(0 <= ratio && 1 >= ratio);
+
+	scheduler->max_cancelled_ratio = ratio;
+
+	DropCancelledIfNeeded(scheduler);
+}
+
+int SchedulerReschedule(scheduler_t *scheduler, ilrd_uid_t uid, time_t time_to_run)
+{
+	task_t *task = NULL;
+
+	assert(NULL != scheduler);
+
+	task = (task_t *)UIDMapFind(scheduler->tasks_by_uid, uid);
+	if (NULL == task)
+	{
+		return FAILURE;
+	}
+
+	TaskSetStartTime(task, time_to_run);
+
+	return PQueueUpdate(scheduler->tasks_pq, TaskGetQueueHandle(task));
 }
 
 size_t SchedulerSize(const scheduler_t *scheduler)
 {
 	assert(NULL != scheduler);
 
-	return PQueueSize(scheduler->tasks_pq);
+	return PQueueSize(scheduler->tasks_pq) - scheduler->cancelled_count;
 }
 
 int IsSchedulerEmpty(const scheduler_t *scheduler)
 {
 	assert(NULL != scheduler);
 
-	return IsPQueueEmpty(scheduler->tasks_pq);
+	if (0 == scheduler->cancelled_count)
+	{
+		return IsPQueueEmpty(scheduler->tasks_pq);
+	}
+
+	return 0 == SchedulerSize(scheduler);
 }
 
 void SchedulerClear(scheduler_t *scheduler)
@@ -121,6 +199,9 @@ void SchedulerClear(scheduler_t *scheduler)
 		to_free = PQueueDequeue(scheduler->tasks_pq);
 		TaskDestroy((task_t *)to_free);
 	}
+
+	UIDMapClear(scheduler->tasks_by_uid);
+	scheduler->cancelled_count = 0;
 }
 
 int SchedulerRun(scheduler_t *scheduler)
@@ -145,6 +226,16 @@ int SchedulerRun(scheduler_t *scheduler)
 		&& 1 != IsSchedulerEmpty(scheduler))
 	{
 		curr_task = (task_t *)PQueueDequeue(scheduler->tasks_pq);
+		if (IsTaskCancelled(curr_task))
+		{
+			TaskDestroy(curr_task);
+			--scheduler->cancelled_count;
+			continue;
+		}
+
+		/* a running task cannot be removed nor rescheduled */
+		UIDMapRemove(scheduler->tasks_by_uid, TaskGetUID(curr_task));
+
 		time_stamp = time(NULL);
 		if (FAILURE == time_stamp)
 		{
@@ -176,7 +267,7 @@ int SchedulerRun(scheduler_t *scheduler)
 			}
 
 			TaskSetStartTime(curr_task, time_stamp + TaskGetFrequency(curr_task));
-			status = PQueueEnqueue(scheduler->tasks_pq, curr_task);
+			status = QueueTask(scheduler, curr_task);
 			if (SUCCESS != status)
 			{
 				fclose(user_input);
@@ -217,12 +308,74 @@ static int TimePriority(const void *queue_data, void *new_data)
     return TaskGetStartTime((task_t*)queue_data) - TaskGetStartTime((task_t*)new_data);
 }
 
-static int FindTask(const void *queue_data, void *uid)
+/* deadlines only move forward, see PQueueCreateKeyed() */
+static unsigned long TimeKey(const void *queue_data)
 {
-	ilrd_uid_t queue_data_uid = TaskGetUID((task_t *)queue_data);
+	time_t start_time = TaskGetStartTime((task_t *)queue_data);
 
-    assert(NULL != queue_data);
-    assert(NULL != uid);
+	assert(NULL != queue_data);
+
+	return 0 < start_time ? (unsigned long)start_time : 0;
+}
+
+static void SetTaskHandle(void *queue_data, size_t handle)
+{
+	assert(NULL != queue_data);
+
+	TaskSetQueueHandle((task_t *)queue_data, handle);
+}
+
+static dll_link_t *GetTaskLink(void *queue_data)
+{
+	assert(NULL != queue_data);
+
+	return TaskGetQueueLink((task_t *)queue_data);
+}
+
+static int IsCancelled(const void *queue_data, void *unused)
+{
+	(void)unused;
+	assert(NULL != queue_data);
+
+	return IsTaskCancelled((task_t *)queue_data);
+}
+
+static void DestroyTask(void *queue_data)
+{
+	assert(NULL != queue_data);
+
+	TaskDestroy((task_t *)queue_data);
+}
+
+/* drops all the tombstones in one pass, once there are too many of them */
+static void DropCancelledIfNeeded(scheduler_t *scheduler)
+{
+	assert(NULL != scheduler);
+
+	if (0 < scheduler->cancelled_count && (double)scheduler->cancelled_count > 
+			scheduler->max_cancelled_ratio * PQueueSize(scheduler->tasks_pq))
+	{
+		PQueueRemoveAll(scheduler->tasks_pq, NULL, &IsCancelled, &DestroyTask);
+		scheduler->cancelled_count = 0;
+	}
+}
+
+/* the task can be found by its uid for as long as it is queued */
+static int QueueTask(scheduler_t *scheduler, task_t *task)
+{
+	assert(NULL != scheduler);
+	assert(NULL != task);
+
+	if (0 != UIDMapInsert(scheduler->tasks_by_uid, TaskGetUID(task), task))
+	{
+		return FAILURE;
+	}
+
+	if (SUCCESS != PQueueEnqueue(scheduler->tasks_pq, task))
+	{
+		UIDMapRemove(scheduler->tasks_by_uid, TaskGetUID(task));
+		return FAILURE;
+	}
 
-    return IsSameUID(queue_data_uid, *(ilrd_uid_t *)uid);
+	return SUCCESS;
 }
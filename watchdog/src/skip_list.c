@@ -0,0 +1,677 @@
+/*
+	Coder : Josh Benichou
+	Date : 02/07/2023
+	Reviewer : *****
+*/
+
+/*************************** LIBRARY INCLUDES ******************************/
+#include <assert.h> /*asserts*/
+#include <stdio.h> /*printf */
+#include <stdlib.h> /* NULL */
+
+/*************************** HEADER INCLUDES ******************************/
+
+#include "skip_list.h" /* our sorted list API */
+#include "list_sort.h" /* ListSortArray */
+#include "allocator.h" /* AllocatorAlloc AllocatorFree */
+
+/************************** TYPEDEFS & STRUCTS ****************************/
+
+#define MAX_LEVEL (32)
+#define RANDOM_SEED (0x2545F491UL)
+
+typedef struct skip_links
+{
+	dll_iterator_t next;
+	dll_iterator_t prev;
+} skip_links_t;
+
+/* the levels of a node above the bottom one, up[0] is level 1 */
+typedef struct skip_tower
+{
+	size_t height;
+	int is_in_place;
+	skip_links_t up[1];
+} skip_tower_t;
+
+/* same size as a d_linked_list node, so it fits a dll_link_t */
+struct iterator
+{
+	void *data;
+	dll_iterator_t next;
+	dll_iterator_t prev;
+	skip_tower_t *tower; /* NULL when the node is only on the bottom level */
+};
+
+struct sorted_list
+{
+	struct iterator head;
+	struct iterator tail;
+	sort_comparefunc_t cmp_func;
+	size_t size;
+	size_t level; /* highest level in use */
+	unsigned long random_state;
+	const allocator_t *allocator;
+};
+
+/* tower of the in place nodes that are only on the bottom level */
+static skip_tower_t g_in_place_tower = {0, 1, {{NULL, NULL}}};
+
+/* compiles only if a dll_link_t can hold a node */
+typedef char link_holds_node[sizeof(dll_link_t) >= sizeof(struct iterator) ? 1 : -1];
+
+/************************ STATIC FUNCTIONS DECLARATIONS **********************/
+
+static sorted_iter_t ToIter(const sorted_list_t *list, dll_iterator_t node);
+static sorted_list_t *FromArray(const allocator_t *allocator, sort_comparefunc_t func, 
+														void **data, size_t count);
+static skip_tower_t *NewTower(const allocator_t *allocator, size_t height, int is_in_place);
+static void FreeTower(const allocator_t *allocator, skip_tower_t *tower);
+static size_t Height(dll_iterator_t node);
+static skip_links_t *Up(dll_iterator_t node, size_t level);
+static size_t RandomHeight(sorted_list_t *list);
+static dll_iterator_t NewNode(sorted_list_t *list, void *data);
+static void FindPreds(sorted_list_t *list, void *data, dll_iterator_t *preds);
+static void LastPreds(sorted_list_t *list, dll_iterator_t *preds);
+static void LinkNode(sorted_list_t *list, dll_iterator_t node, dll_iterator_t *preds);
+static void UnlinkNode(sorted_list_t *list, dll_iterator_t node);
+static void FreeNode(sorted_list_t *list, dll_iterator_t node);
+static void *PopNode(sorted_list_t *list, dll_iterator_t node);
+
+/************************* API FUNCTIONS DEFINITIONS *************************/
+
+sorted_list_t *SortedListCreate(sort_comparefunc_t func)
+{
+	return SortedListCreateWithAllocator(AllocatorGetDefault(), func);
+}
+
+sorted_list_t *SortedListCreateWithAllocator(const allocator_t *allocator, sort_comparefunc_t func)
+{
+	sorted_list_t *new_list = NULL;
+	size_t level = 0;
+
+	assert(NULL != allocator);
+	assert(NULL != func);
+
+	new_list = (sorted_list_t *)AllocatorAlloc(allocator, sizeof(sorted_list_t), 0);
+	if (NULL == new_list)
+	{
+		return NULL;
+	}
+
+	new_list->head.tower = NewTower(allocator, MAX_LEVEL - 1, 0);
+	new_list->tail.tower = NewTower(allocator, MAX_LEVEL - 1, 0);
+	if (NULL == new_list->head.tower || NULL == new_list->tail.tower)
+	{
+		FreeTower(allocator, new_list->head.tower);
+		FreeTower(allocator, new_list->tail.tower);
+		AllocatorFree(allocator, new_list, sizeof(sorted_list_t), 0);
+		return NULL;
+	}
+
+	new_list->head.data = NULL;
+	new_list->head.prev = NULL;
+	new_list->head.next = &new_list->tail;
+	new_list->tail.data = NULL;
+	new_list->tail.prev = &new_list->head;
+	new_list->tail.next = NULL;
+
+	for (level = 1; level < MAX_LEVEL; ++level)
+	{
+		Up(&new_list->head, level)->next = &new_list->tail;
+		Up(&new_list->head, level)->prev = NULL;
+		Up(&new_list->tail, level)->next = NULL;
+		Up(&new_list->tail, level)->prev = &new_list->head;
+	}
+
+	new_list->cmp_func = func;
+	new_list->size = 0;
+	new_list->level = 0;
+	new_list->random_state = RANDOM_SEED;
+	new_list->allocator = allocator;
+
+	return new_list;
+}
+
+sorted_list_t *SortedListFromArray(sort_comparefunc_t func, void **data, size_t count)
+{
+	return FromArray(AllocatorGetDefault(), func, data, count);
+}
+
+void SortedListDestroy(sorted_list_t *list)
+{
+	dll_iterator_t runner = NULL;
+	dll_iterator_t next = NULL;
+
+	assert(NULL != list);
+
+	for (runner = list->head.next; runner != &list->tail; runner = next)
+	{
+		next = runner->next;
+		FreeNode(list, runner);
+	}
+
+	FreeTower(list->allocator, list->head.tower);
+	FreeTower(list->allocator, list->tail.tower);
+
+	AllocatorFree(list->allocator, list, sizeof(sorted_list_t), 0);
+}
+
+void *SortedListGetData(sorted_iter_t iterator)
+{
+	assert(NULL != iterator.iter);
+
+	return iterator.iter->data;
+}
+
+sorted_iter_t SortedListInsert(sorted_list_t *list, void *data)
+{
+	dll_iterator_t preds[MAX_LEVEL];
+	dll_iterator_t node = NULL;
+
+	assert(NULL != list);
+	assert(NULL != data);
+
+	node = NewNode(list, data);
+	if (NULL == node)
+	{
+		return SortedListEnd(list);
+	}
+
+	FindPreds(list, data, preds);
+	LinkNode(list, node, preds);
+
+	return ToIter(list, node);
+}
+
+/* the towers need the place on every level, the hint only gives level 0 */
+sorted_iter_t SortedListInsertHint(sorted_list_t *list, sorted_iter_t hint, void *data)
+{
+	assert(hint.list == list);
+
+	(void)hint;
+
+	return SortedListInsert(list, data);
+}
+
+int SortedListInsertArray(sorted_list_t *list, void **data, size_t count)
+{
+	sorted_list_t *batch = NULL;
+
+	assert(NULL != list);
+	assert(NULL != data || 0 == count);
+
+	batch = FromArray(list->allocator, list->cmp_func, data, count);
+	if (NULL == batch)
+	{
+		return 1;
+	}
+
+	SortedListMerge(list, batch);
+	SortedListDestroy(batch);
+
+	return 0;
+}
+
+sorted_iter_t SortedListInsertLink(sorted_list_t *list, dll_link_t *link, void *data)
+{
+	dll_iterator_t preds[MAX_LEVEL];
+	dll_iterator_t node = (dll_iterator_t)link;
+
+	assert(NULL != list);
+	assert(NULL != link);
+	assert(NULL != data);
+
+	/* without room for a tower the node only goes on the bottom level */
+	node->tower = NewTower(list->allocator, RandomHeight(list), 1);
+	if (NULL == node->tower)
+	{
+		node->tower = &g_in_place_tower;
+	}
+	node->data = data;
+
+	FindPreds(list, data, preds);
+	LinkNode(list, node, preds);
+
+	return ToIter(list, node);
+}
+
+sorted_iter_t SortedListRemove(sorted_list_t *list, sorted_iter_t iterator)
+{
+	dll_iterator_t next = NULL;
+
+	assert(NULL != list);
+	assert(iterator.list == list);
+
+	next = iterator.iter->next;
+	UnlinkNode(list, iterator.iter);
+	FreeNode(list, iterator.iter);
+
+	iterator.iter = next;
+
+	return iterator;
+}
+
+/* off every level and back in, the tower goes with the node */
+sorted_iter_t SortedListResort(sorted_list_t *list, sorted_iter_t iterator)
+{
+	dll_iterator_t preds[MAX_LEVEL];
+
+	assert(NULL != list);
+	assert(iterator.list == list);
+
+	UnlinkNode(list, iterator.iter);
+	FindPreds(list, iterator.iter->data, preds);
+	LinkNode(list, iterator.iter, preds);
+
+	return iterator;
+}
+
+size_t SortedListCount(const sorted_list_t *list)
+{
+	assert(NULL != list);
+
+	return list->size;
+}
+
+sorted_iter_t SortedListFind(sorted_list_t *list, sorted_iter_t from, sorted_iter_t to, void *matchdata)
+{
+	dll_iterator_t preds[MAX_LEVEL];
+
+	assert(NULL != list);
+	assert(from.list == to.list);
+
+	(void)from;
+	(void)to;
+
+	FindPreds(list, matchdata, preds);
+
+	return ToIter(list, preds[0]->next);
+}
+
+sorted_iter_t SortedListFindIf(sorted_iter_t from, sorted_iter_t to, void *matchdata, sort_matchfunc_t func)
+{
+	assert(NULL != func);
+	assert(NULL != matchdata);
+	assert(from.list == to.list);
+
+	while (from.iter != to.iter && 1 != func(from.iter->data, matchdata))
+	{
+		from.iter = from.iter->next;
+	}
+
+	return from;
+}
+
+int SortedListForEachElement(sorted_iter_t from, sorted_iter_t to, void *userdata, sort_actionfunc_t func)
+{
+	int status = 0;
+
+	assert(NULL != func);
+	assert(NULL != userdata);
+	assert(from.list == to.list);
+
+	for (; from.iter != to.iter; from.iter = from.iter->next)
+	{
+		status = func(from.iter->data, userdata);
+		if (1 == status)
+		{
+			break;
+		}
+	}
+
+	return status;
+}
+
+sorted_iter_t SortedListBegin(const sorted_list_t *list)
+{
+	assert(NULL != list);
+
+	return ToIter(list, list->head.next);
+}
+
+sorted_iter_t SortedListEnd(const sorted_list_t *list)
+{
+	assert(NULL != list);
+
+	return ToIter(list, (dll_iterator_t)&list->tail);
+}
+
+sorted_iter_t SortedListNext(sorted_iter_t iterator)
+{
+	iterator.iter = iterator.iter->next;
+
+	return iterator;
+}
+
+sorted_iter_t SortedListPrev(sorted_iter_t iterator)
+{
+	iterator.iter = iterator.iter->prev;
+
+	return iterator;
+}
+
+int IsSortedListEmpty(const sorted_list_t *list)
+{
+	assert(NULL != list);
+
+	return 0 == list->size;
+}
+
+int IsSortedListIterEqual(sorted_iter_t iterator1, sorted_iter_t iterator2)
+{
+	return iterator1.iter == iterator2.iter;
+}
+
+/* the nodes of src keep their towers, only their links change */
+void SortedListMerge(sorted_list_t *dest, sorted_list_t *src)
+{
+	dll_iterator_t preds[MAX_LEVEL];
+	dll_iterator_t node = NULL;
+
+	assert(NULL != dest);
+	assert(NULL != src);
+
+	while (0 < src->size)
+	{
+		node = src->head.next;
+		UnlinkNode(src, node);
+
+		FindPreds(dest, node->data, preds);
+		LinkNode(dest, node, preds);
+	}
+}
+
+/* relinking nodes needs the d_linked_list layout, merges on one thread */
+void SortedListParallelMerge(sorted_list_t *dest, sorted_list_t *src, size_t threads)
+{
+	(void)threads;
+
+	SortedListMerge(dest, src);
+}
+
+void *SortedListPopFront(sorted_list_t *list)
+{
+	assert(NULL != list);
+
+	return PopNode(list, list->head.next);
+}
+
+void *SortedListPopBack(sorted_list_t *list)
+{
+	assert(NULL != list);
+
+	return PopNode(list, list->tail.prev);
+}
+
+void SortedListPrint(sorted_list_t *list)
+{
+	dll_iterator_t runner = NULL;
+
+	assert(NULL != list);
+
+	for (runner = list->head.next; runner != &list->tail; runner = runner->next)
+	{
+		printf("%d -> ", *(int *)runner->data);
+	}
+	printf("\n");
+}
+
+/*********************** STATIC FUNCTIONS DEFINITIONS ************************/
+
+/* in list order already, each node goes last, after the last node of each level */
+static sorted_list_t *FromArray(const allocator_t *allocator, sort_comparefunc_t func, 
+														void **data, size_t count)
+{
+	dll_iterator_t preds[MAX_LEVEL];
+	sorted_list_t *new_list = NULL;
+	dll_iterator_t node = NULL;
+	size_t index = 0;
+
+	assert(NULL != func);
+	assert(NULL != data || 0 == count);
+
+	new_list = SortedListCreateWithAllocator(allocator, func);
+	if (NULL == new_list)
+	{
+		return NULL;
+	}
+
+	if (0 != ListSortArray(data, count, func))
+	{
+		SortedListDestroy(new_list);
+		return NULL;
+	}
+
+	for (index = 0; index < count; ++index)
+	{
+		node = NewNode(new_list, data[index]);
+		if (NULL == node)
+		{
+			SortedListDestroy(new_list);
+			return NULL;
+		}
+
+		LastPreds(new_list, preds);
+		LinkNode(new_list, node, preds);
+	}
+
+	return new_list;
+}
+
+static sorted_iter_t ToIter(const sorted_list_t *list, dll_iterator_t node)
+{
+	sorted_iter_t iterator;
+
+	(void)list;
+	iterator.iter = node;
+	#ifndef NDEBUG
+		iterator.list = (sorted_list_t *)list;
+	#endif
+
+	return iterator;
+}
+
+/* NULL for a node that has no level above the bottom one */
+static skip_tower_t *NewTower(const allocator_t *allocator, size_t height, int is_in_place)
+{
+	skip_tower_t *tower = NULL;
+
+	if (0 == height)
+	{
+		return is_in_place ? &g_in_place_tower : NULL;
+	}
+
+	tower = (skip_tower_t *)AllocatorAlloc(allocator, sizeof(skip_tower_t) + 
+										(height - 1) * sizeof(skip_links_t), 0);
+	if (NULL == tower)
+	{
+		return NULL;
+	}
+
+	tower->height = height;
+	tower->is_in_place = is_in_place;
+
+	return tower;
+}
+
+/* NULL and the shared in place tower are not freed */
+static void FreeTower(const allocator_t *allocator, skip_tower_t *tower)
+{
+	if (NULL == tower || &g_in_place_tower == tower)
+	{
+		return;
+	}
+
+	AllocatorFree(allocator, tower, sizeof(skip_tower_t) + 
+								(tower->height - 1) * sizeof(skip_links_t), 0);
+}
+
+static size_t Height(dll_iterator_t node)
+{
+	return NULL == node->tower ? 0 : node->tower->height;
+}
+
+static skip_links_t *Up(dll_iterator_t node, size_t level)
+{
+	assert(0 < level);
+	assert(level <= Height(node));
+
+	return &node->tower->up[level - 1];
+}
+
+/* level i with probability 2^-(i+1), from one xorshift32 draw */
+static size_t RandomHeight(sorted_list_t *list)
+{
+	unsigned long bits = list->random_state;
+	size_t height = 0;
+
+	bits ^= (bits << 13) & 0xFFFFFFFFUL;
+	bits ^= bits >> 17;
+	bits ^= (bits << 5) & 0xFFFFFFFFUL;
+	list->random_state = bits;
+
+	while ((bits & 1) && height < MAX_LEVEL - 1)
+	{
+		++height;
+		bits >>= 1;
+	}
+
+	return height;
+}
+
+/*
+	preds[level] is the node after which data goes on that level: the last
+	one that is not smaller than data, like the linear FindMyPlace().
+*/
+static dll_iterator_t NewNode(sorted_list_t *list, void *data)
+{
+	dll_iterator_t node = (dll_iterator_t)AllocatorAlloc(list->allocator, 
+													sizeof(struct iterator), 0);
+	size_t height = 0;
+
+	if (NULL == node)
+	{
+		return NULL;
+	}
+
+	height = RandomHeight(list);
+	node->tower = NewTower(list->allocator, height, 0);
+	if (0 < height && NULL == node->tower)
+	{
+		AllocatorFree(list->allocator, node, sizeof(struct iterator), 0);
+		return NULL;
+	}
+	node->data = data;
+
+	return node;
+}
+
+static void FindPreds(sorted_list_t *list, void *data, dll_iterator_t *preds)
+{
+	dll_iterator_t curr = &list->head;
+	dll_iterator_t tail = &list->tail;
+	size_t level = 0;
+
+	for (level = MAX_LEVEL - 1; level > list->level; --level)
+	{
+		preds[level] = curr;
+	}
+
+	for (; 0 < level; --level)
+	{
+		while (Up(curr, level)->next != tail && 
+					0 <= list->cmp_func(Up(curr, level)->next->data, data))
+		{
+			curr = Up(curr, level)->next;
+		}
+		preds[level] = curr;
+	}
+
+	while (curr->next != tail && 0 <= list->cmp_func(curr->next->data, data))
+	{
+		curr = curr->next;
+	}
+	preds[0] = curr;
+}
+
+/* the place right before the tail, on every level */
+static void LastPreds(sorted_list_t *list, dll_iterator_t *preds)
+{
+	size_t level = 0;
+
+	preds[0] = list->tail.prev;
+	for (level = 1; level < MAX_LEVEL; ++level)
+	{
+		preds[level] = Up(&list->tail, level)->prev;
+	}
+}
+
+static void LinkNode(sorted_list_t *list, dll_iterator_t node, dll_iterator_t *preds)
+{
+	size_t height = Height(node);
+	size_t level = 0;
+
+	node->prev = preds[0];
+	node->next = preds[0]->next;
+	node->next->prev = node;
+	preds[0]->next = node;
+
+	for (level = 1; level <= height; ++level)
+	{
+		Up(node, level)->prev = preds[level];
+		Up(node, level)->next = Up(preds[level], level)->next;
+		Up(Up(node, level)->next, level)->prev = node;
+		Up(preds[level], level)->next = node;
+	}
+
+	if (height > list->level)
+	{
+		list->level = height;
+	}
+	++list->size;
+}
+
+static void UnlinkNode(sorted_list_t *list, dll_iterator_t node)
+{
+	size_t height = Height(node);
+	size_t level = 0;
+
+	node->prev->next = node->next;
+	node->next->prev = node->prev;
+
+	for (level = 1; level <= height; ++level)
+	{
+		Up(Up(node, level)->prev, level)->next = Up(node, level)->next;
+		Up(Up(node, level)->next, level)->prev = Up(node, level)->prev;
+	}
+
+	--list->size;
+}
+
+static void FreeNode(sorted_list_t *list, dll_iterator_t node)
+{
+	int is_in_place = NULL != node->tower && node->tower->is_in_place;
+
+	FreeTower(list->allocator, node->tower);
+
+	if (!is_in_place)
+	{
+		AllocatorFree(list->allocator, node, sizeof(struct iterator), 0);
+	}
+}
+
+static void *PopNode(sorted_list_t *list, dll_iterator_t node)
+{
+	void *data = node->data;
+
+	if (0 == list->size)
+	{
+		return NULL;
+	}
+
+	UnlinkNode(list, node);
+	FreeNode(list, node);
+
+	return data;
+}
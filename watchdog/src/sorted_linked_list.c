@@ -4,38 +4,75 @@
 
 #include "sorted_linked_list.h" /* our sorted linked list header */
 #include "d_linked_list.h"
+#include "parallel.h" /* ParallelRun ParallelThreads */
+#include "list_sort.h" /* ListSortArray */
+#include "allocator.h" /* AllocatorAlloc AllocatorFree */
 
 struct sorted_list
 {
     dll_t *list;
     sort_comparefunc_t cmp_func;
+    const allocator_t *allocator;
 };
 
-
+/* the part of the merge a thread does, by index in the merged order */
+typedef struct merge_part
+{
+    sorted_list_t *list;
+    dll_iterator_t *dest_nodes;
+    size_t dest_count;
+    dll_iterator_t *src_nodes;
+    size_t src_count;
+    dll_iterator_t *merged; /* merged[0] and merged[last] are the sentinels */
+    size_t first;
+    size_t last;
+} merge_part_t;
+
+
+static sorted_list_t *FromArray(const allocator_t *allocator, sort_comparefunc_t func, 
+                                                        void **data, size_t count);
 static sorted_iter_t FindMyPlace(sorted_list_t *list, void *data);
+static sorted_iter_t FindFromHint(sorted_list_t *list, sorted_iter_t hint, void *data);
+static int IsBefore(sorted_list_t *list, sorted_iter_t iterator, void *data);
+static dll_iterator_t *ListNodes(dll_t *list, dll_iterator_t *nodes);
+static int IsNodeBefore(sorted_list_t *list, dll_iterator_t dest_node, dll_iterator_t src_node);
+static void MergePart(void *part);
+static void LinkPart(void *part);
 
 sorted_list_t *SortedListCreate(sort_comparefunc_t func)
+{
+    return SortedListCreateWithAllocator(AllocatorGetDefault(), func);
+}
+
+sorted_list_t *SortedListCreateWithAllocator(const allocator_t *allocator, sort_comparefunc_t func)
 {
     sorted_list_t *new_list = NULL;
 
+    assert(NULL != allocator);
     assert(NULL != func);
 
-    new_list = (sorted_list_t *)malloc(sizeof(struct sorted_list));
+    new_list = (sorted_list_t *)AllocatorAlloc(allocator, sizeof(struct sorted_list), 0);
     if (NULL == new_list)
     {
         return NULL;
     }
     new_list->cmp_func = func;
-    new_list->list = DLLCreate();
+    new_list->allocator = allocator;
+    new_list->list = DLLCreateWithAllocator(allocator, 1);
     if (NULL == new_list->list)
     {   
-        free(new_list);
+        AllocatorFree(allocator, new_list, sizeof(struct sorted_list), 0);
         return NULL;
     }
 
     return new_list;
 }
 
+sorted_list_t *SortedListFromArray(sort_comparefunc_t func, void **data, size_t count)
+{
+    return FromArray(AllocatorGetDefault(), func, data, count);
+}
+
 void SortedListDestroy(sorted_list_t *list)
 {
     assert(NULL != list);
@@ -43,7 +80,7 @@ void SortedListDestroy(sorted_list_t *list)
     DLLDestroy(list->list);
     list->list = NULL;
     
-    free(list);
+    AllocatorFree(list->allocator, list, sizeof(struct sorted_list), 0);
     list = NULL;
 }
 
@@ -69,20 +106,228 @@ sorted_iter_t SortedListInsert(sorted_list_t *list, void *data)
     return iterator;
 }
 
+sorted_iter_t SortedListInsertHint(sorted_list_t *list, sorted_iter_t hint, void *data)
+{
+    sorted_iter_t iterator;
+
+    assert(NULL != list);
+    assert(NULL != data);
+    assert(hint.list == list);
+
+    iterator = FindFromHint(list, hint, data);
+
+    iterator.iter = DLLInsertBefore(list->list, iterator.iter, data);
+    #ifndef NDEBUG
+        iterator.list = list;        
+    #endif
+
+    return iterator;
+}
+
+int SortedListInsertArray(sorted_list_t *list, void **data, size_t count)
+{
+    sorted_list_t *batch = NULL;
+
+    assert(NULL != list);
+    assert(NULL != data || 0 == count);
+
+    /* from the allocator of list, so that the merge can splice its nodes */
+    batch = FromArray(list->allocator, list->cmp_func, data, count);
+    if (NULL == batch)
+    {
+        return 1;
+    }
+
+    /* on equal elements the ones of list stay first, as after inserts */
+    SortedListMerge(list, batch);
+    SortedListDestroy(batch);
+
+    return 0;
+}
+
+sorted_iter_t SortedListInsertLink(sorted_list_t *list, dll_link_t *link, void *data)
+{
+    sorted_iter_t iterator;
+
+    assert(NULL != list);
+    assert(NULL != link);
+    assert(NULL != data);
+
+    iterator = FindMyPlace(list, data);
+
+    iterator.iter = DLLInsertLinkBefore(list->list, iterator.iter, link, data);
+
+    return iterator;
+}
+
+static sorted_list_t *FromArray(const allocator_t *allocator, sort_comparefunc_t func, 
+                                                        void **data, size_t count)
+{
+    sorted_list_t *new_list = NULL;
+    size_t index = 0;
+
+    assert(NULL != func);
+    assert(NULL != data || 0 == count);
+
+    new_list = SortedListCreateWithAllocator(allocator, func);
+    if (NULL == new_list)
+    {
+        return NULL;
+    }
+
+    if (0 != ListSortArray(data, count, func))
+    {
+        SortedListDestroy(new_list);
+        return NULL;
+    }
+
+    /* in list order already, each node goes last */
+    for (index = 0; index < count; ++index)
+    {
+        if (IsDLLIterEqual(DLLEnd(new_list->list), DLLPushBack(new_list->list, data[index])))
+        {
+            SortedListDestroy(new_list);
+            return NULL;
+        }
+    }
+
+    return new_list;
+}
+
+/*
+    The place is before the first element that is smaller than data. Walks
+    in from both ends at once: every element from front on the left is not
+    smaller, every element from back on is smaller.
+*/
 static sorted_iter_t FindMyPlace(sorted_list_t *list, void *data)
 {
-    sorted_iter_t runner = SortedListBegin(list);
+    sorted_iter_t front = SortedListBegin(list);
+    sorted_iter_t back = SortedListEnd(list);
     assert(NULL != list);
 
-    while (runner.iter != DLLEnd(list->list))
+    while (!IsSortedListIterEqual(front, back))
     {
-        if (0 > list->cmp_func(SortedListGetData(runner), data))
+        if (!IsBefore(list, front, data))
+        {
+            return front;
+        }
+        front = SortedListNext(front);
+
+        if (IsSortedListIterEqual(front, back) || 
+                                    IsBefore(list, SortedListPrev(back), data))
         {
-            break;
+            return back;
         }
-        runner = SortedListNext(runner);
+        back = SortedListPrev(back);
     }
-    return runner;
+
+    return front;
+}
+
+static sorted_iter_t FindFromHint(sorted_list_t *list, sorted_iter_t hint, void *data)
+{
+    sorted_iter_t begin = SortedListBegin(list);
+    sorted_iter_t end = SortedListEnd(list);
+
+    if (!IsSortedListIterEqual(hint, end) && IsBefore(list, hint, data))
+    {
+        do
+        {
+            hint = SortedListNext(hint);
+        }
+        while (!IsSortedListIterEqual(hint, end) && IsBefore(list, hint, data));
+
+        return hint;
+    }
+
+    while (!IsSortedListIterEqual(hint, begin) && 
+                                    !IsBefore(list, SortedListPrev(hint), data))
+    {
+        hint = SortedListPrev(hint);
+    }
+
+    return hint;
+}
+
+static dll_iterator_t *ListNodes(dll_t *list, dll_iterator_t *nodes)
+{
+    dll_iterator_t runner = NULL;
+
+    for (runner = DLLBegin(list); runner != DLLEnd(list); runner = DLLNext(runner))
+    {
+        *nodes = runner;
+        ++nodes;
+    }
+
+    return nodes;
+}
+
+/* on equal elements, the one of dest stays first, as in SortedListMerge() */
+static int IsNodeBefore(sorted_list_t *list, dll_iterator_t dest_node, dll_iterator_t src_node)
+{
+    return 0 <= list->cmp_func(DLLGetData(dest_node), DLLGetData(src_node));
+}
+
+/*
+    Writes merged[first + 1 .. last], after the head sentinel. The number
+    of dest nodes among the first "first" merged ones is found by binary
+    search on the merge path.
+*/
+static void MergePart(void *part)
+{
+    merge_part_t *merge = (merge_part_t *)part;
+    size_t low = merge->first > merge->src_count ? merge->first - merge->src_count : 0;
+    size_t high = merge->first < merge->dest_count ? merge->first : merge->dest_count;
+    size_t middle = 0;
+    size_t dest_index = 0;
+    size_t src_index = 0;
+    size_t out = 0;
+
+    while (low < high)
+    {
+        middle = low + (high - low) / 2;
+        if (IsNodeBefore(merge->list, merge->dest_nodes[middle], 
+                            merge->src_nodes[merge->first - middle - 1]))
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    dest_index = low;
+    src_index = merge->first - low;
+
+    for (out = merge->first; out < merge->last; ++out)
+    {
+        if (src_index == merge->src_count || (dest_index < merge->dest_count && 
+                IsNodeBefore(merge->list, merge->dest_nodes[dest_index], 
+                                            merge->src_nodes[src_index])))
+        {
+            merge->merged[out + 1] = merge->dest_nodes[dest_index];
+            ++dest_index;
+        }
+        else
+        {
+            merge->merged[out + 1] = merge->src_nodes[src_index];
+            ++src_index;
+        }
+    }
+}
+
+static void LinkPart(void *part)
+{
+    merge_part_t *merge = (merge_part_t *)part;
+
+    DLLLinkSequence(merge->merged + merge->first, merge->last - merge->first);
+}
+
+/* data goes after the element of iterator */
+static int IsBefore(sorted_list_t *list, sorted_iter_t iterator, void *data)
+{
+    return 0 <= list->cmp_func(SortedListGetData(iterator), data);
 }
 
 sorted_iter_t SortedListBegin(const sorted_list_t *list)
@@ -161,7 +406,8 @@ void SortedListMerge(sorted_list_t *dest, sorted_list_t *src)
             match = src_runner;
             src_runner = SortedListNext(src_runner);    
 
-            DLLSplice(dest_runner.iter, match.iter, SortedListNext(match).iter);
+            DLLSplice(dest->list, dest_runner.iter, src->list, 
+                                        match.iter, SortedListNext(match).iter);
         }
         else
         {
@@ -171,13 +417,122 @@ void SortedListMerge(sorted_list_t *dest, sorted_list_t *src)
 
     if (!IsSortedListIterEqual(src_runner, SortedListEnd(src)))
     {
-        DLLSplice(dest_runner.iter, src_runner.iter, SortedListEnd(src).iter);
+        DLLSplice(dest->list, dest_runner.iter, src->list, 
+                                    src_runner.iter, SortedListEnd(src).iter);
     }    
 }
 
-sorted_iter_t SortedListRemove(sorted_iter_t iterator)
+void SortedListParallelMerge(sorted_list_t *dest, sorted_list_t *src, size_t threads)
+{
+    size_t dest_count = 0;
+    size_t src_count = 0;
+    size_t total = 0;
+    dll_iterator_t *nodes = NULL;
+    merge_part_t *parts = NULL;
+    size_t index = 0;
+
+    assert(NULL != dest);
+    assert(NULL != src);
+
+    threads = 0 == threads ? ParallelThreads() : threads;
+    dest_count = DLLSize(dest->list);
+    src_count = DLLSize(src->list);
+    total = dest_count + src_count;
+
+    /* nodes: dest, src, then the merged order between the two sentinels */
+    if (1 < threads && 0 < dest_count && 0 < src_count)
+    {
+        nodes = (dll_iterator_t *)malloc((2 * total + 2) * sizeof(dll_iterator_t));
+        parts = (merge_part_t *)malloc(threads * sizeof(merge_part_t));
+    }
+    if (NULL == nodes || NULL == parts)
+    {
+        free(nodes);
+        free(parts);
+        SortedListMerge(dest, src);
+        return;
+    }
+
+    ListNodes(dest->list, nodes);
+    ListNodes(src->list, nodes + dest_count);
+    nodes[total] = DLLPrev(DLLBegin(dest->list));
+    nodes[2 * total + 1] = DLLEnd(dest->list);
+
+    /* the whole of src moves in O(1), the merge only relinks */
+    DLLSplice(dest->list, DLLEnd(dest->list), src->list, 
+                                    DLLBegin(src->list), DLLEnd(src->list));
+
+    for (index = 0; index < threads; ++index)
+    {
+        parts[index].list = dest;
+        parts[index].dest_nodes = nodes;
+        parts[index].dest_count = dest_count;
+        parts[index].src_nodes = nodes + dest_count;
+        parts[index].src_count = src_count;
+        parts[index].merged = nodes + total;
+        parts[index].first = total * index / threads;
+        parts[index].last = total * (index + 1) / threads;
+    }
+
+    ParallelRun(MergePart, parts, sizeof(merge_part_t), threads);
+
+    /*
+        the links between the parts are made by the part on the right: each
+        part links its first node after merged[first], written by the part
+        on its left, which sets the prev of that node, and this one its next
+    */
+    for (index = 0; index < threads; ++index)
+    {
+        parts[index].last += 1 + (threads - 1 == index);
+    }
+
+    ParallelRun(LinkPart, parts, sizeof(merge_part_t), threads);
+
+    free(parts);
+    free(nodes);
+}
+
+sorted_iter_t SortedListRemove(sorted_list_t *list, sorted_iter_t iterator)
 {
-    iterator.iter = DLLRemove(NULL, iterator.iter);
+    assert(NULL != list);
+    assert(iterator.list == list);
+
+    iterator.iter = DLLRemove(list->list, iterator.iter);
+
+    return iterator;
+}
+
+/* the walk starts beside the element, so that it never meets it */
+sorted_iter_t SortedListResort(sorted_list_t *list, sorted_iter_t iterator)
+{
+    sorted_iter_t next = {0};
+    sorted_iter_t place = {0};
+    void *data = NULL;
+
+    assert(NULL != list);
+    assert(iterator.list == list);
+
+    data = SortedListGetData(iterator);
+    next = SortedListNext(iterator);
+
+    if (!IsSortedListIterEqual(next, SortedListEnd(list)) && IsBefore(list, next, data))
+    {
+        place = FindFromHint(list, next, data);
+    }
+    else
+    {
+        place = iterator;
+        while (!IsSortedListIterEqual(place, SortedListBegin(list)) && 
+                                    !IsBefore(list, SortedListPrev(place), data))
+        {
+            place = SortedListPrev(place);
+        }
+    }
+
+    if (!IsSortedListIterEqual(place, iterator) && !IsSortedListIterEqual(place, next))
+    {
+        DLLSplice(list->list, place.iter, list->list, iterator.iter, next.iter);
+    }
 
     return iterator;
 }
@@ -224,6 +579,9 @@ sorted_iter_t SortedListFindIf(sorted_iter_t from, sorted_iter_t to, void *match
     assert(from.list == to.list);
 
     return_iter.iter = DLLFind(from.iter, to.iter, matchdata, func);
+    #ifndef NDEBUG
+        return_iter.list = from.list;
+    #endif
 
     return return_iter;
 }    
@@ -4,15 +4,28 @@
 	Reviewer : 
 */	
 
-#include <stdlib.h> /* printf */
+#include <stddef.h> /* NULL */
 #include <assert.h> /* assert */
 
 #include "task.h" /* task function */
+#include "allocator.h" /* AllocatorAlloc AllocatorFree */
 
 task_t *TaskCreate(task_func_t taskfunc, clean_func_t clean_func
                         , void *task_params, time_t start_run_time, time_t frequency)
-{	
-	task_t *task = (task_t *)malloc(sizeof(task_t));
+{
+	return TaskCreateWithAllocator(AllocatorGetDefault(), taskfunc, clean_func, 
+									task_params, start_run_time, frequency);
+}
+
+task_t *TaskCreateWithAllocator(const allocator_t *allocator, task_func_t taskfunc, 
+                        clean_func_t clean_func, void *task_params, 
+                        time_t start_run_time, time_t frequency)
+{
+	task_t *task = NULL;
+
+	assert(NULL != allocator);
+
+	task = (task_t *)AllocatorAlloc(allocator, sizeof(task_t), 0);
 	if (NULL == task)
 	{
 		return NULL;
@@ -27,6 +40,9 @@ task_t *TaskCreate(task_func_t taskfunc, clean_func_t clean_func
 	task->start_run_time = start_run_time;
 	task->frequency = frequency;
 	task->uid = UIDCreate();
+	task->queue_handle = 0;
+	task->is_cancelled = 0;
+	task->allocator = allocator;
 
 	return task;
 }
@@ -35,9 +51,28 @@ void TaskDestroy(task_t *task)
 {
 	assert(NULL != task);
 
+	if (!task->is_cancelled)
+	{
+		task->clean_func(task);
+	}
+
+	AllocatorFree(task->allocator, task, sizeof(task_t), 0);
+}
+
+void TaskCancel(task_t *task)
+{
+	assert(NULL != task);
+	assert(!task->is_cancelled);
+
 	task->clean_func(task);
+	task->is_cancelled = 1;
+}
+
+int IsTaskCancelled(const task_t *task)
+{
+	assert(NULL != task);
 
-	free(task);
+	return task->is_cancelled;
 }
 
 ilrd_uid_t TaskGetUID(task_t *task)
@@ -94,4 +129,25 @@ void TaskSetStartTime(task_t *task, time_t new_time_to_set)
 	assert(NULL != task);
 
 	task->start_run_time = new_time_to_set;
-}
\ No newline at end of file
+}
+
+size_t TaskGetQueueHandle(task_t *task)
+{
+	assert(NULL != task);
+
+	return task->queue_handle;
+}
+
+void TaskSetQueueHandle(task_t *task, size_t handle)
+{
+	assert(NULL != task);
+
+	task->queue_handle = handle;
+}
+
+dll_link_t *TaskGetQueueLink(task_t *task)
+{
+	assert(NULL != task);
+
+	return &task->queue_link;
+}
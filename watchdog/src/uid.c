@@ -5,26 +5,57 @@
 */	
 
 #include <unistd.h> /* getpid() */
+#include <pthread.h> /* pthread_once pthread_atfork */
 
 #include "uid.h" /* our UID functions */ 
 
+/* each thread takes counters from here a block at a time */
+#define COUNTER_BLOCK (1024)
+
 static size_t counter = 1;
+static __thread size_t t_next_counter = 0;
+static __thread size_t t_end_counter = 0;
+
+/* read once per process by Seed(), again in a forked child */
+static pid_t g_pid = 0;
+static time_t g_time = -1; /* until a time() succeeds, see SeedTime() */
+static pthread_once_t g_seed_once = PTHREAD_ONCE_INIT;
 
 const ilrd_uid_t g_bad_uid = {0, 0, 0};
 
+/* compiles only if the packed form is one 64 bit word */
+typedef char packed_is_64_bits[8 == sizeof(uid_packed_t) ? 1 : -1];
+
+static void Seed(void);
+static void Reseed(void);
+static time_t SeedTime(void);
+
 ilrd_uid_t UIDCreate(void)
 {
 	ilrd_uid_t new_uid;
+	time_t seed_time = -1;
 
-	new_uid.counter = counter++;
+	if (0 == __atomic_load_n(&g_pid, __ATOMIC_ACQUIRE))
+	{
+		pthread_once(&g_seed_once, Seed);
+	}
 
-	new_uid.time = time(NULL);
-	if (-1 == new_uid.time)
+	seed_time = SeedTime();
+	if (-1 == seed_time)
 	{
 		return GetBadUID();
 	}
 
-	new_uid.pid = getpid();
+	/* one atomic add per block, the UIDs of a block are the thread's own */
+	if (t_next_counter == t_end_counter)
+	{
+		t_next_counter = __atomic_fetch_add(&counter, COUNTER_BLOCK, __ATOMIC_RELAXED);
+		t_end_counter = t_next_counter + COUNTER_BLOCK;
+	}
+
+	new_uid.counter = t_next_counter++;
+	new_uid.time = seed_time;
+	new_uid.pid = g_pid;
 
 	return new_uid;
 
@@ -32,11 +63,68 @@ ilrd_uid_t UIDCreate(void)
 
 int IsSameUID(ilrd_uid_t uid1, ilrd_uid_t uid2)
 {
-	return 1 == (uid1.counter == uid2.counter && uid1.time == uid2.time  
-											&& uid1.pid == uid2.pid) ? 1 : 0;
+	/* the counter differs the most often, it goes first */
+	return uid1.counter == uid2.counter && uid1.pid == uid2.pid  
+											&& uid1.time == uid2.time;
 }
 
 ilrd_uid_t GetBadUID(void)
 {
 	return g_bad_uid;
 }
+
+uid_packed_t UIDPack(ilrd_uid_t uid)
+{
+	return ((uid_packed_t)uid.pid << UID_COUNTER_BITS) | 
+				((uid_packed_t)uid.counter & (((uid_packed_t)1 << UID_COUNTER_BITS) - 1));
+}
+
+/* the splitmix64 finalizer */
+size_t UIDHash(ilrd_uid_t uid)
+{
+	uid_packed_t hash = UIDPack(uid);
+
+	hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9UL;
+	hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBUL;
+
+	return (size_t)(hash ^ (hash >> 31));
+}
+
+static void Seed(void)
+{
+	Reseed();
+
+	/* a child has its own pid, the counter can go on from the parent's */
+	pthread_atfork(NULL, NULL, Reseed);
+}
+
+/* g_pid is stored last, once it is set g_time can be read */
+static void Reseed(void)
+{
+	__atomic_store_n(&g_time, time(NULL), __ATOMIC_RELAXED);
+	__atomic_store_n(&g_pid, getpid(), __ATOMIC_RELEASE);
+}
+
+/* 
+	A time() that failed at the seed is tried again on the next UIDCreate(),
+	not kept for good. The first thread to get a time sets it for all.
+*/
+static time_t SeedTime(void)
+{
+	time_t seed_time = __atomic_load_n(&g_time, __ATOMIC_RELAXED);
+	time_t failed = -1;
+
+	if (-1 != seed_time)
+	{
+		return seed_time;
+	}
+
+	seed_time = time(NULL);
+	if (-1 != seed_time && !__atomic_compare_exchange_n(&g_time, &failed, 
+							seed_time, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+	{
+		seed_time = failed;
+	}
+
+	return seed_time;
+}
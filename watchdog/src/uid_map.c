@@ -0,0 +1,457 @@
+#include <stddef.h> /* size_t */
+#include <string.h> /* memcpy memset */
+#include <assert.h> /* assert */
+
+#include "uid_map.h" /* my functions */
+#include "allocator.h" /* AllocatorAlloc AllocatorAllocZeroed AllocatorFree */
+
+enum status {SUCCESS = 0, FAILURE = 1};
+
+#define GROUP_SIZE (8)
+#define MIGRATE_GROUPS (2) /* old groups moved by each insert / remove */
+#define NOT_FOUND ((size_t)-1)
+
+/*
+	Control bytes, a full slot holds the low 7 bits of the hash of its key.
+	They are stored xored with CTRL_EMPTY, so a zeroed table is empty.
+*/
+#define CTRL_EMPTY (0x80)
+#define CTRL_DELETED (0xFE)
+#define H2_BITS (7)
+#define H2_MASK (0x7F)
+
+#define LSBS (0x0101010101010101UL)
+#define LOWS (0x7F7F7F7F7F7F7F7FUL)
+#define MSBS (0x8080808080808080UL)
+
+/* the control bytes of a group, bit 7 of each byte flags a match */
+typedef unsigned long group_word_t;
+
+typedef struct slot
+{
+	ilrd_uid_t key;
+	void *value;
+} slot_t;
+
+typedef struct table
+{
+	unsigned char *ctrl; /* stored form, NULL for no table */
+	slot_t *slots;
+	size_t group_mask; /* number of groups - 1, a power of two - 1 */
+	size_t size;
+	size_t growth_left; /* empty slots that can still be filled */
+} table_t;
+
+struct uid_map
+{
+	table_t current;
+	table_t old; /* moving into current while growing */
+	size_t next_old_group;
+	const allocator_t *allocator;
+};
+
+/* compiles only if a word holds the control bytes of a group */
+typedef char word_holds_group[GROUP_SIZE == sizeof(group_word_t) ? 1 : -1];
+
+static int InitTable(const allocator_t *allocator, table_t *table, size_t groups);
+static void FreeTable(const allocator_t *allocator, table_t *table);
+static size_t MaxLoad(const table_t *table);
+static unsigned char GetCtrl(const table_t *table, size_t index);
+static void SetCtrl(table_t *table, size_t index, unsigned char ctrl);
+static group_word_t LoadGroup(const table_t *table, size_t group);
+static group_word_t MatchByte(group_word_t word, unsigned char byte);
+static group_word_t MatchEmpty(group_word_t word);
+static group_word_t MatchFree(group_word_t word);
+static size_t FirstMatch(group_word_t matches);
+static size_t FindIn(const table_t *table, ilrd_uid_t key, size_t hash);
+static size_t FindFreeSlot(const table_t *table, size_t hash);
+static void InsertIn(table_t *table, ilrd_uid_t key, void *value, size_t hash);
+static void EraseAt(table_t *table, size_t index);
+static int StartGrowth(uid_map_t *map);
+static void Migrate(uid_map_t *map, size_t groups);
+
+uid_map_t *UIDMapCreate(size_t capacity)
+{
+	return UIDMapCreateWithAllocator(AllocatorGetDefault(), capacity);
+}
+
+uid_map_t *UIDMapCreateWithAllocator(const allocator_t *allocator, size_t capacity)
+{
+	uid_map_t *map = NULL;
+	size_t groups = 1;
+
+	assert(NULL != allocator);
+
+	map = (uid_map_t *)AllocatorAlloc(allocator, sizeof(uid_map_t), 0);
+	if (NULL == map)
+	{
+		return NULL;
+	}
+
+	/* 7 of the 8 slots of a group can be full */
+	while (groups * (GROUP_SIZE - 1) < capacity)
+	{
+		groups *= 2;
+	}
+
+	if (SUCCESS != InitTable(allocator, &map->current, groups))
+	{
+		AllocatorFree(allocator, map, sizeof(uid_map_t), 0);
+		return NULL;
+	}
+	map->old.ctrl = NULL;
+	map->old.slots = NULL;
+	map->old.group_mask = 0;
+	map->old.size = 0;
+	map->next_old_group = 0;
+	map->allocator = allocator;
+
+	return map;
+}
+
+void UIDMapDestroy(uid_map_t *map)
+{
+	assert(NULL != map);
+
+	FreeTable(map->allocator, &map->current);
+	FreeTable(map->allocator, &map->old);
+
+	AllocatorFree(map->allocator, map, sizeof(uid_map_t), 0);
+}
+
+int UIDMapInsert(uid_map_t *map, ilrd_uid_t key, void *value)
+{
+	size_t hash = UIDHash(key);
+	size_t index = 0;
+
+	assert(NULL != map);
+
+	index = FindIn(&map->current, key, hash);
+	if (NOT_FOUND != index)
+	{
+		map->current.slots[index].value = value;
+		return SUCCESS;
+	}
+
+	index = FindIn(&map->old, key, hash);
+	if (NOT_FOUND != index)
+	{
+		map->old.slots[index].value = value;
+		return SUCCESS;
+	}
+
+	Migrate(map, MIGRATE_GROUPS);
+
+	if (0 == map->current.growth_left && SUCCESS != StartGrowth(map))
+	{
+		return FAILURE;
+	}
+
+	InsertIn(&map->current, key, value, hash);
+
+	return SUCCESS;
+}
+
+void *UIDMapFind(const uid_map_t *map, ilrd_uid_t key)
+{
+	size_t hash = UIDHash(key);
+	size_t index = 0;
+
+	assert(NULL != map);
+
+	index = FindIn(&map->current, key, hash);
+	if (NOT_FOUND != index)
+	{
+		return map->current.slots[index].value;
+	}
+
+	index = FindIn(&map->old, key, hash);
+
+	return NOT_FOUND != index ? map->old.slots[index].value : NULL;
+}
+
+void *UIDMapRemove(uid_map_t *map, ilrd_uid_t key)
+{
+	size_t hash = UIDHash(key);
+	size_t index = 0;
+	void *value = NULL;
+
+	assert(NULL != map);
+
+	index = FindIn(&map->current, key, hash);
+	if (NOT_FOUND != index)
+	{
+		value = map->current.slots[index].value;
+		EraseAt(&map->current, index);
+	}
+	else
+	{
+		index = FindIn(&map->old, key, hash);
+		if (NOT_FOUND != index)
+		{
+			value = map->old.slots[index].value;
+			EraseAt(&map->old, index);
+		}
+	}
+
+	Migrate(map, MIGRATE_GROUPS);
+
+	return value;
+}
+
+void UIDMapClear(uid_map_t *map)
+{
+	assert(NULL != map);
+
+	FreeTable(map->allocator, &map->old);
+
+	memset(map->current.ctrl, 0, (map->current.group_mask + 1) * GROUP_SIZE);
+	map->current.size = 0;
+	map->current.growth_left = MaxLoad(&map->current);
+}
+
+size_t UIDMapSize(const uid_map_t *map)
+{
+	assert(NULL != map);
+
+	return map->current.size + map->old.size;
+}
+
+static int InitTable(const allocator_t *allocator, table_t *table, size_t groups)
+{
+	size_t slots = groups * GROUP_SIZE;
+
+	/* large zeroed blocks come as fresh pages, nothing is written now */
+	table->slots = (slot_t *)AllocatorAlloc(allocator, slots * sizeof(slot_t), 0);
+	table->ctrl = (unsigned char *)AllocatorAllocZeroed(allocator, slots);
+	if (NULL == table->slots || NULL == table->ctrl)
+	{
+		AllocatorFree(allocator, table->slots, slots * sizeof(slot_t), 0);
+		AllocatorFree(allocator, table->ctrl, slots, 0);
+		table->ctrl = NULL;
+		return FAILURE;
+	}
+
+	table->group_mask = groups - 1;
+	table->size = 0;
+	table->growth_left = MaxLoad(table);
+
+	return SUCCESS;
+}
+
+/* the size is only read for a table that exists */
+static void FreeTable(const allocator_t *allocator, table_t *table)
+{
+	size_t slots = (table->group_mask + 1) * GROUP_SIZE;
+
+	AllocatorFree(allocator, table->ctrl, slots, 0);
+	AllocatorFree(allocator, table->slots, slots * sizeof(slot_t), 0);
+	table->ctrl = NULL;
+	table->slots = NULL;
+	table->size = 0;
+}
+
+/* at least one slot in 8 stays empty, so every probe ends */
+static size_t MaxLoad(const table_t *table)
+{
+	return (table->group_mask + 1) * (GROUP_SIZE - 1);
+}
+
+static unsigned char GetCtrl(const table_t *table, size_t index)
+{
+	return table->ctrl[index] ^ CTRL_EMPTY;
+}
+
+static void SetCtrl(table_t *table, size_t index, unsigned char ctrl)
+{
+	table->ctrl[index] = ctrl ^ CTRL_EMPTY;
+}
+
+/* byte i of the group is byte i of the word, bits 8i to 8i + 7 */
+static group_word_t LoadGroup(const table_t *table, size_t group)
+{
+	group_word_t word = 0;
+
+	memcpy(&word, table->ctrl + group * GROUP_SIZE, sizeof(word));
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	word = __builtin_bswap64(word);
+#endif
+
+	return word ^ MSBS;
+}
+
+/* the bytes that are zero once byte is xored out, no false positives */
+static group_word_t MatchByte(group_word_t word, unsigned char byte)
+{
+	group_word_t zeroed = word ^ (LSBS * byte);
+
+	return ~(((zeroed & LOWS) + LOWS) | zeroed | LOWS);
+}
+
+/* bit 7 set and bit 1 clear: 0x80, not 0xFE nor a full byte */
+static group_word_t MatchEmpty(group_word_t word)
+{
+	return word & ~(word << 6) & MSBS;
+}
+
+/* empty or deleted, bit 7 set */
+static group_word_t MatchFree(group_word_t word)
+{
+	return word & MSBS;
+}
+
+static size_t FirstMatch(group_word_t matches)
+{
+	return (size_t)__builtin_ctzl(matches) / 8;
+}
+
+/* probes group after group, 1, 2, 3... groups further each time */
+static size_t FindIn(const table_t *table, ilrd_uid_t key, size_t hash)
+{
+	group_word_t word = 0;
+	group_word_t matches = 0;
+	size_t group = 0;
+	size_t step = 0;
+	size_t index = 0;
+
+	if (NULL == table->ctrl)
+	{
+		return NOT_FOUND;
+	}
+
+	group = (hash >> H2_BITS) & table->group_mask;
+	for (step = 1; step <= table->group_mask + 1; ++step)
+	{
+		word = LoadGroup(table, group);
+
+		for (matches = MatchByte(word, hash & H2_MASK); 0 != matches; 
+														matches &= matches - 1)
+		{
+			index = group * GROUP_SIZE + FirstMatch(matches);
+			if (IsSameUID(table->slots[index].key, key))
+			{
+				return index;
+			}
+		}
+
+		if (0 != MatchEmpty(word))
+		{
+			return NOT_FOUND;
+		}
+
+		group = (group + step) & table->group_mask;
+	}
+
+	return NOT_FOUND;
+}
+
+static size_t FindFreeSlot(const table_t *table, size_t hash)
+{
+	group_word_t matches = 0;
+	size_t group = (hash >> H2_BITS) & table->group_mask;
+	size_t step = 0;
+
+	for (step = 1; ; ++step)
+	{
+		matches = MatchFree(LoadGroup(table, group));
+		if (0 != matches)
+		{
+			return group * GROUP_SIZE + FirstMatch(matches);
+		}
+
+		group = (group + step) & table->group_mask;
+	}
+}
+
+static void InsertIn(table_t *table, ilrd_uid_t key, void *value, size_t hash)
+{
+	size_t index = FindFreeSlot(table, hash);
+
+	assert(0 < table->growth_left);
+
+	table->growth_left -= CTRL_EMPTY == GetCtrl(table, index);
+	SetCtrl(table, index, (unsigned char)(hash & H2_MASK));
+	table->slots[index].key = key;
+	table->slots[index].value = value;
+	++table->size;
+}
+
+/*
+	A probe never went past a group that has an empty slot, so the slot
+	can be empty again. Otherwise probes may need to go on past it.
+*/
+static void EraseAt(table_t *table, size_t index)
+{
+	if (0 != MatchEmpty(LoadGroup(table, index / GROUP_SIZE)))
+	{
+		SetCtrl(table, index, CTRL_EMPTY);
+		++table->growth_left;
+	}
+	else
+	{
+		SetCtrl(table, index, CTRL_DELETED);
+	}
+	--table->size;
+}
+
+/*
+	Out of empty slots. A table at most half full is only clogged with
+	deleted slots, and is moved to a new table of the same size, else to
+	one twice the size. Either way it has room for all that can be
+	inserted before the move ends.
+*/
+static int StartGrowth(uid_map_t *map)
+{
+	table_t grown;
+	size_t groups = map->current.group_mask + 1;
+
+	assert(NULL == map->old.ctrl);
+
+	if (map->current.size > MaxLoad(&map->current) / 2)
+	{
+		groups *= 2;
+	}
+
+	if (SUCCESS != InitTable(map->allocator, &grown, groups))
+	{
+		return FAILURE;
+	}
+
+	map->old = map->current;
+	map->current = grown;
+	map->next_old_group = 0;
+
+	Migrate(map, MIGRATE_GROUPS);
+
+	return SUCCESS;
+}
+
+/* moved slots are marked deleted in old, lookups there skip them */
+static void Migrate(uid_map_t *map, size_t groups)
+{
+	slot_t *slot = NULL;
+	size_t index = 0;
+	size_t end = 0;
+
+	for (; NULL != map->old.ctrl && 0 < groups; --groups)
+	{
+		index = map->next_old_group * GROUP_SIZE;
+		for (end = index + GROUP_SIZE; index < end; ++index)
+		{
+			if (0 == (GetCtrl(&map->old, index) & CTRL_EMPTY))
+			{
+				slot = &map->old.slots[index];
+				InsertIn(&map->current, slot->key, slot->value, UIDHash(slot->key));
+				SetCtrl(&map->old, index, CTRL_DELETED);
+				--map->old.size;
+			}
+		}
+
+		++map->next_old_group;
+		if (map->next_old_group > map->old.group_mask)
+		{
+			FreeTable(map->allocator, &map->old);
+		}
+	}
+}
@@ -0,0 +1,401 @@
+#include <string.h> /* memmove memcpy */
+#include <assert.h> /* asserts */
+
+#include "unrolled_list.h" /* my functions */
+#include "allocator.h" /* AllocatorAlloc AllocatorFree */
+
+/* the first slots of a node are used, the rest is free */
+struct ulist_node
+{
+	ulist_node_t *next;
+	ulist_node_t *prev;
+	size_t count;
+	void *slots[ULIST_NODE_SLOTS];
+};
+
+/* head and tail are empty sentinels, end is {&tail, 0} */
+struct unrolled_list
+{
+	ulist_node_t head;
+	ulist_node_t tail;
+	size_t size;
+	const allocator_t *allocator;
+};
+
+/* compiles only if a full node can be split in two */
+typedef char node_splits[2 <= ULIST_NODE_SLOTS ? 1 : -1];
+
+static ulist_iter_t ToIter(const ulist_node_t *node, size_t index);
+static ulist_node_t *AddNodeAfter(ulist_t *list, ulist_node_t *node);
+static void RemoveNode(ulist_t *list, ulist_node_t *node);
+static ulist_iter_t MakeRoom(ulist_t *list, ulist_node_t *node, size_t index);
+
+ulist_t *UListCreate(void)
+{
+	return UListCreateWithAllocator(AllocatorGetDefault());
+}
+
+ulist_t *UListCreateWithAllocator(const allocator_t *allocator)
+{
+	ulist_t *list = NULL;
+
+	assert(NULL != allocator);
+
+	list = (ulist_t *)AllocatorAlloc(allocator, sizeof(ulist_t), 0);
+	if (NULL == list)
+	{
+		return NULL;
+	}
+
+	list->head.next = &list->tail;
+	list->head.prev = NULL;
+	list->head.count = 0;
+	list->tail.next = NULL;
+	list->tail.prev = &list->head;
+	list->tail.count = 0;
+	list->size = 0;
+	list->allocator = allocator;
+
+	return list;
+}
+
+void UListDestroy(ulist_t *list)
+{
+	ulist_node_t *node = NULL;
+
+	assert(NULL != list);
+
+	while (&list->tail != list->head.next)
+	{
+		node = list->head.next;
+		RemoveNode(list, node);
+	}
+
+	AllocatorFree(list->allocator, list, sizeof(ulist_t), 0);
+}
+
+ulist_iter_t UListInsertBefore(ulist_t *list, ulist_iter_t iterator, void *data)
+{
+	ulist_node_t *node = iterator.node;
+	size_t index = iterator.index;
+
+	assert(NULL != list);
+	assert(NULL != node);
+
+	/* the end is past the last slot of the last node */
+	if (&list->tail == node)
+	{
+		node = list->tail.prev;
+		index = node->count;
+	}
+
+	if (&list->head == node || ULIST_NODE_SLOTS == node->count)
+	{
+		iterator = MakeRoom(list, node, index);
+		if (NULL == iterator.node)
+		{
+			return UListEnd(list);
+		}
+		node = iterator.node;
+		index = iterator.index;
+	}
+
+	memmove(&node->slots[index + 1], &node->slots[index], 
+								(node->count - index) * sizeof(void *));
+	node->slots[index] = data;
+	++node->count;
+	++list->size;
+
+	return ToIter(node, index);
+}
+
+ulist_iter_t UListRemove(ulist_t *list, ulist_iter_t iterator)
+{
+	ulist_node_t *node = iterator.node;
+	ulist_node_t *next = NULL;
+	size_t index = iterator.index;
+
+	assert(NULL != list);
+	assert(index < node->count);
+
+	--node->count;
+	--list->size;
+	memmove(&node->slots[index], &node->slots[index + 1], 
+								(node->count - index) * sizeof(void *));
+
+	next = node->next;
+	if (0 == node->count)
+	{
+		RemoveNode(list, node);
+		return ToIter(next, 0);
+	}
+
+	if (node->count < ULIST_NODE_SLOTS / 2 && &list->tail != next && 
+							node->count + next->count <= ULIST_NODE_SLOTS)
+	{
+		memcpy(&node->slots[node->count], next->slots, next->count * sizeof(void *));
+		node->count += next->count;
+		RemoveNode(list, next);
+	}
+
+	return index < node->count ? ToIter(node, index) : ToIter(node->next, 0);
+}
+
+ulist_iter_t UListPushFront(ulist_t *list, void *data)
+{
+	return UListInsertBefore(list, UListBegin(list), data);
+}
+
+ulist_iter_t UListPushBack(ulist_t *list, void *data)
+{
+	return UListInsertBefore(list, UListEnd(list), data);
+}
+
+void *UListPopFront(ulist_t *list)
+{
+	void *data = NULL;
+
+	assert(NULL != list);
+
+	if (0 == list->size)
+	{
+		return NULL;
+	}
+
+	data = UListGetData(UListBegin(list));
+	UListRemove(list, UListBegin(list));
+
+	return data;
+}
+
+void *UListPopBack(ulist_t *list)
+{
+	void *data = NULL;
+
+	assert(NULL != list);
+
+	if (0 == list->size)
+	{
+		return NULL;
+	}
+
+	data = UListGetData(UListPrev(UListEnd(list)));
+	UListRemove(list, UListPrev(UListEnd(list)));
+
+	return data;
+}
+
+void *UListGetData(ulist_iter_t iterator)
+{
+	assert(NULL != iterator.node);
+	assert(iterator.index < iterator.node->count);
+
+	return iterator.node->slots[iterator.index];
+}
+
+void UListSetData(ulist_iter_t iterator, void *data)
+{
+	assert(NULL != iterator.node);
+	assert(iterator.index < iterator.node->count);
+
+	iterator.node->slots[iterator.index] = data;
+}
+
+ulist_iter_t UListBegin(const ulist_t *list)
+{
+	assert(NULL != list);
+
+	return ToIter(list->head.next, 0);
+}
+
+ulist_iter_t UListEnd(const ulist_t *list)
+{
+	assert(NULL != list);
+
+	return ToIter(&list->tail, 0);
+}
+
+ulist_iter_t UListNext(ulist_iter_t iterator)
+{
+	assert(NULL != iterator.node);
+
+	if (iterator.index + 1 < iterator.node->count)
+	{
+		++iterator.index;
+		return iterator;
+	}
+
+	return ToIter(iterator.node->next, 0);
+}
+
+ulist_iter_t UListPrev(ulist_iter_t iterator)
+{
+	ulist_node_t *prev = NULL;
+
+	assert(NULL != iterator.node);
+
+	if (0 < iterator.index)
+	{
+		--iterator.index;
+		return iterator;
+	}
+
+	/* the head has no slot, before the beginning is {&head, 0} */
+	prev = iterator.node->prev;
+
+	return ToIter(prev, 0 == prev->count ? 0 : prev->count - 1);
+}
+
+size_t UListSize(const ulist_t *list)
+{
+	assert(NULL != list);
+
+	return list->size;
+}
+
+int IsUListEmpty(const ulist_t *list)
+{
+	assert(NULL != list);
+
+	return 0 == list->size;
+}
+
+int IsUListIterEqual(ulist_iter_t iterator1, ulist_iter_t iterator2)
+{
+	return iterator1.node == iterator2.node && iterator1.index == iterator2.index;
+}
+
+/* whole nodes first, then the part of the last one */
+int UListForEachElement(ulist_iter_t from, ulist_iter_t to, void *userdata, ulist_actionfunc_t func)
+{
+	size_t stop = 0;
+	int status = 0;
+
+	assert(NULL != userdata);
+	assert(NULL != func);
+
+	for (;;)
+	{
+		stop = from.node == to.node ? to.index : from.node->count;
+
+		for (; from.index < stop; ++from.index)
+		{
+			status = func(from.node->slots[from.index], userdata);
+			if (1 == status)
+			{
+				return status;
+			}
+		}
+
+		if (from.node == to.node)
+		{
+			return status;
+		}
+
+		from = ToIter(from.node->next, 0);
+	}
+}
+
+ulist_iter_t UListFind(ulist_iter_t from, ulist_iter_t to, void *matchdata, ulist_matchfunc_t func)
+{
+	size_t stop = 0;
+
+	assert(NULL != matchdata);
+	assert(NULL != func);
+
+	for (;;)
+	{
+		stop = from.node == to.node ? to.index : from.node->count;
+
+		for (; from.index < stop; ++from.index)
+		{
+			if (1 == func(from.node->slots[from.index], matchdata))
+			{
+				return from;
+			}
+		}
+
+		if (from.node == to.node)
+		{
+			return from;
+		}
+
+		from = ToIter(from.node->next, 0);
+	}
+}
+
+static ulist_iter_t ToIter(const ulist_node_t *node, size_t index)
+{
+	ulist_iter_t iterator;
+
+	iterator.node = (ulist_node_t *)node;
+	iterator.index = index;
+
+	return iterator;
+}
+
+static ulist_node_t *AddNodeAfter(ulist_t *list, ulist_node_t *node)
+{
+	ulist_node_t *new_node = (ulist_node_t *)AllocatorAlloc(list->allocator, 
+														sizeof(ulist_node_t), 0);
+	if (NULL == new_node)
+	{
+		return NULL;
+	}
+
+	new_node->count = 0;
+	new_node->prev = node;
+	new_node->next = node->next;
+	node->next->prev = new_node;
+	node->next = new_node;
+
+	return new_node;
+}
+
+static void RemoveNode(ulist_t *list, ulist_node_t *node)
+{
+	node->prev->next = node->next;
+	node->next->prev = node->prev;
+
+	AllocatorFree(list->allocator, node, sizeof(ulist_node_t), 0);
+}
+
+/*
+	Where data goes when node is the head or full: a new node of its own
+	at either end of node, so pushes at one end fill nodes up, or else
+	the upper half of node moves to a new one.
+	node is NULL on failure.
+*/
+static ulist_iter_t MakeRoom(ulist_t *list, ulist_node_t *node, size_t index)
+{
+	ulist_node_t *new_node = NULL;
+	size_t half = ULIST_NODE_SLOTS / 2;
+
+	if (&list->head == node || ULIST_NODE_SLOTS == index)
+	{
+		return ToIter(AddNodeAfter(list, node), 0);
+	}
+
+	if (0 == index)
+	{
+		node = node->prev;
+		if (&list->head == node || ULIST_NODE_SLOTS == node->count)
+		{
+			return ToIter(AddNodeAfter(list, node), 0);
+		}
+
+		return ToIter(node, node->count);
+	}
+
+	new_node = AddNodeAfter(list, node);
+	if (NULL == new_node)
+	{
+		return ToIter(NULL, 0);
+	}
+
+	new_node->count = node->count - half;
+	node->count = half;
+	memcpy(new_node->slots, &node->slots[half], new_node->count * sizeof(void *));
+
+	return index <= half ? ToIter(node, index) : ToIter(new_node, index - half);
+}
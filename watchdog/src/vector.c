@@ -1,42 +1,87 @@
-#include <stdlib.h> /* malloc, realloc, free */
+#define _GNU_SOURCE /* posix_memalign mremap */
+
+#include <stdlib.h> /* size_t */
 #include <assert.h> /* assert */
-#include <string.h> /* memcpy */
+#include <string.h> /* memcpy memmove */
 #include <stdio.h> /* printf */
+#include <sys/mman.h> /* mmap mremap madvise munmap */
 
 #include "vector.h" /* my functions */
+#include "allocator.h" /* AllocatorAlloc AllocatorRealloc AllocatorFree */
 
 
 enum status {FAILURE = 1, SUCCESS = 0};
 
+#define MIN_CAPACITY (1)
+#define HUGE_PAGE_SIZE ((size_t)2 << 20)
+#define ROUND_UP(bytes, unit) (((bytes) + (unit) - 1) / (unit) * (unit))
+
 struct vector
 {
 	size_t capacity;
+	size_t min_capacity;
 	size_t element_size;
-	size_t ratio;
+	vector_grow_t grow_policy;
+	vector_shrink_t shrink_policy;
 	void* base;
 	void* end;
-	
+	int is_aligned;
+	size_t mapped_bytes; /* length of the mapping of base, 0 when allocated */
+	const allocator_t *allocator;
 };
 
+static size_t GrownCapacity(const vector_t *vector);
+static int ShouldShrink(const vector_t *vector);
+static int ReserveFor(vector_t *vector, size_t count);
+static void *AllocBuffer(const allocator_t *allocator, int is_aligned, size_t bytes, 
+														size_t *mapped_bytes);
+static int ResizeBuffer(vector_t *vector, size_t new_bytes);
+static void FreeBuffer(const vector_t *vector);
+static size_t BufferAlignment(int is_aligned);
+
 vector_t *VectorCreate(size_t init_capacity, size_t size_of_one_element)
 {
-	vector_t *vector = malloc(sizeof(vector_t));		
+	return VectorCreateWithAllocator(AllocatorGetDefault(), init_capacity, 
+													size_of_one_element, 0);
+}
+
+vector_t *VectorCreateAligned(size_t init_capacity, size_t size_of_one_element)
+{
+	return VectorCreateWithAllocator(AllocatorGetDefault(), init_capacity, 
+													size_of_one_element, 1);
+}
+
+vector_t *VectorCreateWithAllocator(const allocator_t *allocator, size_t init_capacity, 
+										size_t size_of_one_element, int is_aligned)
+{
+	vector_t *vector = NULL;
+
+	assert(NULL != allocator);
+
+	vector = (vector_t *)AllocatorAlloc(allocator, sizeof(vector_t), 0);
 	if (NULL == vector)
 	{
 		return NULL;
 	}
 
-	vector->base = malloc(init_capacity * size_of_one_element);
+	init_capacity = MIN_CAPACITY > init_capacity ? MIN_CAPACITY : init_capacity;
+
+	vector->base = AllocBuffer(allocator, is_aligned, init_capacity * size_of_one_element,
+															&vector->mapped_bytes);
 	if (NULL == vector->base)
 	{
-		free(vector);
+		AllocatorFree(allocator, vector, sizeof(vector_t), 0);
 		return NULL;
 	}
 
 	vector->end = vector->base;
 	vector->capacity = init_capacity;
+	vector->min_capacity = init_capacity;
 	vector->element_size = size_of_one_element;
-	vector->ratio = 2; 	
+	vector->grow_policy = VECTOR_GROW_DOUBLE;
+	vector->shrink_policy = VECTOR_SHRINK_AT_QUARTER;
+	vector->is_aligned = is_aligned;
+	vector->allocator = allocator;
 
 	return vector;
 }
@@ -45,124 +90,165 @@ void VectorDestroy(vector_t *vector)
 {
 	assert(NULL != vector);
 
-	free(vector->base);
+	FreeBuffer(vector);
 	vector->base = NULL;
 
-	free(vector);
+	AllocatorFree(vector->allocator, vector, sizeof(vector_t), 0);
+}
+
+void VectorSetPolicy(vector_t *vector, vector_grow_t grow_policy, vector_shrink_t shrink_policy)
+{
+	assert(NULL != vector);
+
+	vector->grow_policy = grow_policy;
+	vector->shrink_policy = shrink_policy;
 }
 
 void *VectorGetAccessToElement(const vector_t *vector, size_t index)
 {
+	size_t offset = 0;
 	assert(NULL != vector);
-	if(index < VectorSize(vector))
+
+	offset = index * vector->element_size;
+
+	/* compares byte offsets, VectorSize() would cost a divide */
+	if (offset < (size_t)((char*)vector->end - (char*)vector->base))
 	{
-		return (char*)vector->base + (index * vector->element_size);
+		return (char*)vector->base + offset;
 	}
 
 	return NULL;
 }
 
+void *VectorBegin(const vector_t *vector)
+{
+	assert(NULL != vector);
+
+	return vector->base;
+}
+
+void *VectorEnd(const vector_t *vector)
+{
+	assert(NULL != vector);
+
+	return vector->end;
+}
+
 size_t VectorSize(const vector_t *vector)
 {
 	assert(NULL != vector);
 
-	return ((char*)vector->end - (char*)vector->base) / vector->element_size;	
+	return ((char*)vector->end - (char*)vector->base) / vector->element_size;
 }
 
 int VectorReserve(vector_t *vector, size_t new_capacity)
 {
-	void *temp_vec = NULL;
+	size_t size = 0;
 	assert(NULL != vector);
 
-	temp_vec = realloc(vector->base, new_capacity * (vector->element_size));
+	size = VectorSize(vector);
+	if (new_capacity < size || MIN_CAPACITY > new_capacity)
+	{
+		return FAILURE;
+	}
 
-	if (NULL == temp_vec)
+	if (FAILURE == ResizeBuffer(vector, new_capacity * vector->element_size))
 	{
 		return FAILURE;
 	}
 
-	vector->base = temp_vec;
+	vector->end = (char*)vector->base + (size * vector->element_size);
+	vector->capacity = new_capacity;
 
 	return SUCCESS;
 }
 
 int VectorPushBack(vector_t *vector, const void *value)
 {
-	size_t slots_left = 0;
-	int realloc_failure = 0;
-	
 	assert(NULL != vector);
 
-	slots_left = (VectorCapacity(vector) - VectorSize(vector));
-
-	if (0 == slots_left)
+	if ((char*)vector->end == (char*)vector->base + vector->capacity * vector->element_size)
 	{
-		/*printf("No slots_left, reserving... \n");*/														
+		/*printf("No slots_left, reserving... \n");*/
 
-		realloc_failure = VectorReserve(vector, vector->capacity * vector->ratio);
-		if (FAILURE == realloc_failure)
+		if (FAILURE == VectorReserve(vector, GrownCapacity(vector)))
 		{
 			return FAILURE;
 		}
-
-		vector->end = (char*)vector->base + (vector->capacity * vector->element_size);
-		vector->capacity = vector->capacity * vector->ratio;
 	}
 
-	if (NULL == memcpy(vector->end, value, vector->element_size))
-	{
-		return FAILURE;
-	}	
+	memcpy(vector->end, value, vector->element_size);
 	vector->end = (char*)vector->end + vector->element_size;
 
 	return SUCCESS;
 }
 
-int VectorShrink(vector_t *vector)
+int VectorPushBackN(vector_t *vector, const void *values, size_t count)
 {
-	int status = 0;
 	assert(NULL != vector);
+	assert(NULL != values || 0 == count);
+
+	if (FAILURE == ReserveFor(vector, count))
+	{
+		return FAILURE;
+	}
+
+	memcpy(vector->end, values, count * vector->element_size);
+	vector->end = (char*)vector->end + count * vector->element_size;
+
+	return SUCCESS;
+}
 
-	status = VectorReserve(vector, vector->capacity / vector->ratio);
+int VectorInsertRange(vector_t *vector, size_t index, const void *values, size_t count)
+{
+	char *insert_at = NULL;
+
+	assert(NULL != vector);
+	assert(NULL != values || 0 == count);
 
-	if (FAILURE == status)
+	if (index > VectorSize(vector) || FAILURE == ReserveFor(vector, count))
 	{
 		return FAILURE;
 	}
 
-	vector->capacity = vector->capacity / vector->ratio;
-	vector->end = (char*)vector->base + (vector->capacity * vector->element_size);
+	insert_at = (char*)vector->base + index * vector->element_size;
+	memmove(insert_at + count * vector->element_size, insert_at,
+				(char*)vector->end - insert_at);
+	memcpy(insert_at, values, count * vector->element_size);
+	vector->end = (char*)vector->end + count * vector->element_size;
 
 	return SUCCESS;
 }
 
+int VectorShrink(vector_t *vector)
+{
+	size_t size = 0;
+	assert(NULL != vector);
+
+	size = VectorSize(vector);
+
+	return VectorReserve(vector, MIN_CAPACITY > size ? MIN_CAPACITY : size);
+}
+
 void VectorPopBack(vector_t *vector)
 {
-	size_t slots_left = 0;
-	int realloc_failure = 0;
-	
 	assert(NULL != vector);
 
 	if (vector->end == vector->base)
-	{	
+	{
 		/*printf("Nothing to pop :\n");*/
 		return;
 	}
 
-	slots_left = (VectorCapacity(vector) - VectorSize(vector));
+	vector->end = (char*)vector->end - vector->element_size;
 
-	if ((vector->capacity / vector->ratio) == slots_left)
+	if (ShouldShrink(vector))
 	{
-		/*printf("To much slots spare, shrinking...\n");	*/													
+		/*printf("To much slots spare, shrinking...\n");	*/
 
-		realloc_failure = VectorShrink(vector);
-		if (FAILURE == realloc_failure)
-		{
-			return;
-		}
+		/* a failed shrink only keeps the spare room */
+		VectorReserve(vector, vector->capacity / 2);
 	}
-
-	vector->end = (char*)vector->end - vector->element_size;
 }
 
 size_t VectorCapacity(const vector_t *vector)
@@ -171,3 +257,175 @@ size_t VectorCapacity(const vector_t *vector)
 
 	return vector->capacity;
 }
+
+static size_t GrownCapacity(const vector_t *vector)
+{
+	assert(NULL != vector);
+
+	if (VECTOR_GROW_ONE_AND_HALF == vector->grow_policy)
+	{
+		return vector->capacity + vector->capacity / 2 + 1;
+	}
+
+	return vector->capacity * 2;
+}
+
+/*
+	Halving must leave the vector at most half full, or the next pushes
+	grow it right back.
+*/
+static int ShouldShrink(const vector_t *vector)
+{
+	size_t size = VectorSize(vector);
+
+	assert(NULL != vector);
+
+	if (vector->capacity / 2 < vector->min_capacity)
+	{
+		return 0;
+	}
+
+	switch (vector->shrink_policy)
+	{
+		case VECTOR_SHRINK_AT_QUARTER:
+			return size <= vector->capacity / 4;
+
+		case VECTOR_SHRINK_AT_HALF:
+			return size <= vector->capacity / 2;
+
+		default:
+			return 0;
+	}
+}
+
+/* grows once, to the policy's next capacity or more if count needs it */
+static int ReserveFor(vector_t *vector, size_t count)
+{
+	size_t needed = VectorSize(vector) + count;
+	size_t grown = 0;
+
+	assert(NULL != vector);
+
+	if (needed <= vector->capacity)
+	{
+		return SUCCESS;
+	}
+
+	grown = GrownCapacity(vector);
+
+	return VectorReserve(vector, needed > grown ? needed : grown);
+}
+
+/*
+	Aligned buffers below the threshold come from the allocator, aligned.
+	Above it, with the malloc allocator, they are anonymous mappings,
+	rounded up to whole huge pages and advised to be backed by them.
+	Another allocator gets all the buffers, so it sees all the memory.
+*/
+static void *AllocBuffer(const allocator_t *allocator, int is_aligned, size_t bytes, 
+														size_t *mapped_bytes)
+{
+	void *buffer = NULL;
+
+	*mapped_bytes = 0;
+
+	if (!is_aligned || VECTOR_HUGE_PAGE_THRESHOLD > bytes || 
+										AllocatorMalloc() != allocator)
+	{
+		return AllocatorAlloc(allocator, bytes, BufferAlignment(is_aligned));
+	}
+
+	buffer = mmap(NULL, ROUND_UP(bytes, HUGE_PAGE_SIZE), PROT_READ | PROT_WRITE,
+										MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (MAP_FAILED == buffer)
+	{
+		return NULL;
+	}
+	*mapped_bytes = ROUND_UP(bytes, HUGE_PAGE_SIZE);
+
+#ifdef MADV_HUGEPAGE
+	/* only a hint, small pages still work */
+	madvise(buffer, *mapped_bytes, MADV_HUGEPAGE);
+#endif
+
+	return buffer;
+}
+
+/* on failure the vector keeps its buffer */
+static int ResizeBuffer(vector_t *vector, size_t new_bytes)
+{
+	size_t used_bytes = (char*)vector->end - (char*)vector->base;
+	size_t new_mapped_bytes = 0;
+	void *new_base = NULL;
+
+	if (!vector->is_aligned)
+	{
+		new_base = AllocatorRealloc(vector->allocator, vector->base, 
+								vector->capacity * vector->element_size, new_bytes);
+		if (NULL == new_base)
+		{
+			return FAILURE;
+		}
+		vector->base = new_base;
+
+		return SUCCESS;
+	}
+
+	if (0 != vector->mapped_bytes && VECTOR_HUGE_PAGE_THRESHOLD <= new_bytes)
+	{
+		new_mapped_bytes = ROUND_UP(new_bytes, HUGE_PAGE_SIZE);
+		if (new_mapped_bytes == vector->mapped_bytes)
+		{
+			/* still fits the mapping, nothing to do */
+			return SUCCESS;
+		}
+
+#ifdef MREMAP_MAYMOVE
+		/* moves the pages instead of copying them */
+		new_base = mremap(vector->base, vector->mapped_bytes,
+											new_mapped_bytes, MREMAP_MAYMOVE);
+		if (MAP_FAILED == new_base)
+		{
+			return FAILURE;
+		}
+		vector->base = new_base;
+		vector->mapped_bytes = new_mapped_bytes;
+
+		return SUCCESS;
+#endif
+	}
+
+	new_base = AllocBuffer(vector->allocator, 1, new_bytes, &new_mapped_bytes);
+	if (NULL == new_base)
+	{
+		return FAILURE;
+	}
+
+	memcpy(new_base, vector->base, used_bytes);
+	FreeBuffer(vector);
+
+	vector->base = new_base;
+	vector->mapped_bytes = new_mapped_bytes;
+
+	return SUCCESS;
+}
+
+/* the buffer is capacity elements long, as it was allocated */
+static void FreeBuffer(const vector_t *vector)
+{
+	if (0 != vector->mapped_bytes)
+	{
+		munmap(vector->base, vector->mapped_bytes);
+	}
+	else
+	{
+		AllocatorFree(vector->allocator, vector->base, 
+						vector->capacity * vector->element_size, 
+										BufferAlignment(vector->is_aligned));
+	}
+}
+
+static size_t BufferAlignment(int is_aligned)
+{
+	return is_aligned ? VECTOR_ALIGNMENT : 0;
+}
@@ -18,24 +18,41 @@ static atomic_int g_threshold_counter = 0;
 static atomic_int g_should_i_stop = 0;
 static size_t g_is_wd = 0;
 
+/* the kernel compares the heartbeat counters as 32 bit words */
+typedef char beat_is_futex_word[4 == sizeof(atomic_uint) ? 1 : -1];
+
 /************************ STATIC FUNCTIONS DECLARATIONS **********************/
 
-static int TASKSendSignal(void *data);
-static int TASKCheckTreshRevive(void *data);
+static int TASKBeat(void *data);
 static int TASKShouldITerminate(void *data);
 
+static void *MonitorPeer(void *data);
+static void RevivePeer(info_t *info);
+static int WaitForPeer(info_t *info);
+#ifndef NDEBUG
+static int TargetPid(info_t *info);
+#endif
+
 static void SigHandler(int signum);
 static void SetSignalsToHandle(struct sigaction *act);
 static void SetTaskInScheduler(info_t *info);
 static void SetSemaphores(info_t *app_thr_info, char  *sem_1, char  *sem_2);
+static void SetHeartbeat(info_t *info);
+static unsigned int PeerBeat(info_t *info);
+static atomic_uint *PeerWord(info_t *info);
+static long Futex(atomic_uint *word, int op, unsigned int value, 
+                                            const struct timespec *timeout);
 static void UnsetEnvVar();
 
 static void CheckMAlloc(void *ptr, char *calling_func);
 static void CheckSemOpen(void *sem, char *calling_func, char *named_sem);
 static void CheckSemClose(void *sem, char *calling_func, char *named_sem);
 static void CheckSemUnlink(char *calling_func, char *named_sem);
+static void CheckShmOpen(int fd, char *calling_func, char *named_shm);
+static void CheckMMap(void *mapped, char *calling_func, char *named_shm);
 static void CheckUnsetEnv(int status, char *calling_func, char *env_name);
 static void CheckSchedulerAdd(ilrd_uid_t uid_to_check);
+static void CheckThreadCreate(int status, char *calling_func);
 static void CleanUp(info_t *info);
 
 static void CleanUpStubFunc(void *data);
@@ -51,6 +68,8 @@ info_t *CreateInfoStruct(char  *sem_1, char  *sem_2)
     CheckMAlloc(info->scheduler,"SchedulerCreate");
 
     SetSemaphores(info, sem_1, sem_2);
+    SetHeartbeat(info);
+    pthread_mutex_init(&info->peer_lock, NULL);
 
     info->target_pid = getppid();
 
@@ -90,8 +109,18 @@ void* InitScheduler(void *data)
     #endif
     sem_wait(info->sem_2);
 
+    /* only once paired, a revive would take part in the handshake */
+    info->last_peer_beat = PeerBeat(info);
+    CheckThreadCreate(pthread_create(&info->monitor, NULL, MonitorPeer, info),
+                                                            "InitScheduler");
+
     SchedulerRun(info->scheduler);
 
+    /* whatever ended the run, the monitor has to end too */
+    atomic_store(&g_should_i_stop, 1);
+    Futex(PeerWord(info), FUTEX_WAKE, 1, NULL);
+    pthread_join(info->monitor, NULL);
+
     CleanUp(info);
 
     #ifndef NDEBUG
@@ -133,7 +162,7 @@ void SetWDIndicator(size_t wd_flag)
 
 /*********************** STATIC FUNCTIONS DEFINITIONS ************************/
 
-static int TASKSendSignal(void *data)
+static int TASKBeat(void *data)
 {
     info_t *info = (info_t *)data;
 
@@ -141,69 +170,132 @@ static int TASKSendSignal(void *data)
         printf("%s : ", g_is_wd == WATCH_DOG ? "WATCHDOG" : "APP THREAD");
         printf("%d    ->    ", getpid() % 100);
         printf("%s : ", g_is_wd == APP_THREAD ? "WATCHDOG" : "APP THREAD");
-        printf("%d\n", info->target_pid % 100);
+        printf("%d\n", TargetPid(info) % 100);
 
     #endif
 
-    kill(info->target_pid, SIGUSR1);
+    atomic_fetch_add(&info->heartbeat->beats[g_is_wd], 1);
+    Futex(&info->heartbeat->beats[g_is_wd], FUTEX_WAKE, 1, NULL);
+
+    return 0;
+}
+
+static int TASKShouldITerminate(void *data)
+{
+    if (g_should_i_stop)
+    {
+        info_t *info = (info_t *)data;
+        SchedulerStop(info->scheduler);
+        if (APP_THREAD == g_is_wd)
+        {
+            /* a revive in flight finishes first, the new WD gets it */
+            pthread_mutex_lock(&info->peer_lock);
+            if(SUCCESS != kill(info->target_pid, SIGUSR2))
+            {
+                printf("WD DID NOT RECEIVE SIGUSR2\n");
+            } 
+            pthread_mutex_unlock(&info->peer_lock);
+        }
+
+    }
 
     return 0;
 }
 
-static int TASKCheckTreshRevive(void *data)
+/*
+    Sleeps on the peer's counter, an interval at most: a beat wakes it at
+    once, a timeout is a missed beat. A counter that moved before the wait
+    began fails it with EAGAIN, so no beat goes unseen.
+*/
+static void *MonitorPeer(void *data)
 {
     info_t *info = (info_t *)data;
+    struct timespec interval = {0, 0};
 
     assert(data);
 
-    atomic_fetch_add(&g_threshold_counter, 1);
-    if (g_threshold_counter > atol(getenv("THRESHOLD")))
+    interval.tv_sec = atol(getenv(INTERVALS));
+
+    while (!g_should_i_stop)
     {
-        char *args[3] = {NULL}; 
-        FillArgs(args);
+        if (SUCCESS != Futex(PeerWord(info), FUTEX_WAIT, info->last_peer_beat, 
+                                            &interval) && ETIMEDOUT == errno)
+        {
+            atomic_fetch_add(&g_threshold_counter, 1);
+        }
+        else if (PeerBeat(info) != info->last_peer_beat)
+        {
+            info->last_peer_beat = PeerBeat(info);
+            atomic_store(&g_threshold_counter, RESET);
+        }
 
-/*         SchedulerStop(info->scheduler);
- */        kill(info->target_pid, SIGKILL);
-        wait(&info->target_pid);
+        if (g_threshold_counter > atol(getenv(THRESHOLD)) && !g_should_i_stop)
+        {
+            RevivePeer(info);
+        }
+    }
 
-        info->target_pid = ForkNExec(args);
+    return NULL;
+}
 
-        sem_post(info->sem_1);
-        sem_wait(info->sem_2);
+static void RevivePeer(info_t *info)
+{
+    char *args[3] = {NULL}; 
 
-        atomic_store(&g_threshold_counter, RESET);
-/*         SchedulerRun(info->scheduler);
- */    }
+    assert(info);
 
-    return 0;
+    FillArgs(args);
+
+    pthread_mutex_lock(&info->peer_lock);
+    kill(info->target_pid, SIGKILL);
+    waitpid(info->target_pid, NULL, 0);
+    info->target_pid = ForkNExec(args);
+    pthread_mutex_unlock(&info->peer_lock);
+
+    sem_post(info->sem_1);
+    if (SUCCESS == WaitForPeer(info))
+    {
+        info->last_peer_beat = PeerBeat(info);
+    }
+    atomic_store(&g_threshold_counter, RESET);
 }
 
-static int TASKShouldITerminate(void *data)
+/* the handshake of a revived peer, given up when asked to stop */
+static int WaitForPeer(info_t *info)
 {
-    if (g_should_i_stop)
+    struct timespec deadline = {0, 0};
+
+    while (!g_should_i_stop)
     {
-        info_t *info = (info_t *)data;
-        SchedulerStop(info->scheduler);
-        if (APP_THREAD == g_is_wd)
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += atol(getenv(INTERVALS));
+
+        if (SUCCESS == sem_timedwait(info->sem_2, &deadline))
         {
-            if(SUCCESS != kill(info->target_pid, SIGUSR2))
-            {
-                printf("WD DID NOT RECEIVE SIGUSR2\n");
-            } 
+            return SUCCESS;
         }
-
     }
 
-    return 0;
+    return FAILURE;
 }
 
+/* only the debug prints read target_pid out of the lock's holders */
+#ifndef NDEBUG
+static int TargetPid(info_t *info)
+{
+    int pid = 0;
+
+    pthread_mutex_lock(&info->peer_lock);
+    pid = info->target_pid;
+    pthread_mutex_unlock(&info->peer_lock);
+
+    return pid;
+}
+#endif
+
 static void SigHandler(int signum)
 { 
-    if (SIGUSR1 == signum)
-    { 
-        atomic_store(&g_threshold_counter, RESET);
-    }
-    else if (SIGUSR2 == signum)
+    if (SIGUSR2 == signum)
     {
         atomic_store(&g_should_i_stop, 1);
     }
@@ -214,7 +306,6 @@ static void SetSignalsToHandle(struct sigaction *act)
     assert(act);
 
     act->sa_handler = SigHandler;
-    sigaction(SIGUSR1, act, NULL); 
     sigaction(SIGUSR2, act, NULL); 
 }
 
@@ -223,9 +314,7 @@ static void SetTaskInScheduler(info_t *info)
     ilrd_uid_t returned_uid = {0,0,0};
     assert(info);
 
-    returned_uid = SchedulerAdd(info->scheduler, TASKSendSignal, info, CleanUpStubFunc, time(NULL), atol(getenv("INTERVALS")));
-    CheckSchedulerAdd(returned_uid);
-    returned_uid = SchedulerAdd(info->scheduler, TASKCheckTreshRevive, info, CleanUpStubFunc, time(NULL) , atol(getenv("INTERVALS")));
+    returned_uid = SchedulerAdd(info->scheduler, TASKBeat, info, CleanUpStubFunc, time(NULL), atol(getenv("INTERVALS")));
     CheckSchedulerAdd(returned_uid);
     returned_uid = SchedulerAdd(info->scheduler, TASKShouldITerminate, info, CleanUpStubFunc, time(NULL), atol(getenv("INTERVALS")));
     CheckSchedulerAdd(returned_uid);
@@ -244,6 +333,42 @@ static void SetSemaphores(info_t *app_thr_info, char  *sem_1, char  *sem_2)
     CheckSemOpen(app_thr_info->sem_2, "SetSemaphores", WD_SEMA);
 }
 
+/* both sides create the page if missing, the watchdog removes it */
+static void SetHeartbeat(info_t *info)
+{
+    int fd = -1;
+
+    assert(info);
+
+    fd = shm_open(HEARTBEAT_SHM, O_CREAT | O_RDWR, 0666);
+    CheckShmOpen(fd, "SetHeartbeat", HEARTBEAT_SHM);
+    CheckShmOpen(ftruncate(fd, sizeof(heartbeat_t)), "SetHeartbeat", HEARTBEAT_SHM);
+
+    info->heartbeat = mmap(NULL, sizeof(heartbeat_t), PROT_READ | PROT_WRITE, 
+                                                        MAP_SHARED, fd, 0);
+    CheckMMap(info->heartbeat, "SetHeartbeat", HEARTBEAT_SHM);
+
+    close(fd);
+}
+
+static unsigned int PeerBeat(info_t *info)
+{
+    return atomic_load(PeerWord(info));
+}
+
+static atomic_uint *PeerWord(info_t *info)
+{
+    return &info->heartbeat->beats[WATCH_DOG == g_is_wd ? 
+                                                    APP_THREAD : WATCH_DOG];
+}
+
+/* shared futex: the words are waited on and woken across the processes */
+static long Futex(atomic_uint *word, int op, unsigned int value, 
+                                            const struct timespec *timeout)
+{
+    return syscall(SYS_futex, word, op, value, timeout, NULL, 0);
+}
+
 static void UnsetEnvVar()
 {
     CheckUnsetEnv(unsetenv(WATCHDOG_ON), "UnsetEnvVar", WATCHDOG_ON);  
@@ -260,10 +385,14 @@ static void CleanUp(info_t *info)
     CheckSemClose(info->sem_1, "CleanUp", "wd_sem");
     CheckSemClose(info->sem_2, "CleanUp", "app_sem");
 
+    munmap(info->heartbeat, sizeof(heartbeat_t));
+    pthread_mutex_destroy(&info->peer_lock);
+
     if (WATCH_DOG == g_is_wd)
     {
         CheckSemUnlink("CleanUp", APP_SEMA);
         CheckSemUnlink("CleanUp", WD_SEMA);
+        shm_unlink(HEARTBEAT_SHM);
     }
 
     atomic_store(&g_threshold_counter, RESET);
@@ -322,6 +451,26 @@ static void CheckSemUnlink(char *calling_func, char *named_sem)
     } 
 }
 
+static void CheckShmOpen(int fd, char *calling_func, char *named_shm)
+{
+    if (0 > fd)
+    {
+        perror(calling_func);
+        printf("%s\n", named_shm);
+        exit(EXIT_FAILURE);
+    }
+}
+
+static void CheckMMap(void *mapped, char *calling_func, char *named_shm)
+{
+    if (MAP_FAILED == mapped)
+    {
+        perror(calling_func);
+        printf("%s\n", named_shm);
+        exit(EXIT_FAILURE);
+    }
+}
+
 static void CheckSchedulerAdd(ilrd_uid_t uid_to_check)
 {
     if (IsSameUID(GetBadUID(), uid_to_check))
@@ -331,6 +480,16 @@ static void CheckSchedulerAdd(ilrd_uid_t uid_to_check)
     }
 }
 
+static void CheckThreadCreate(int status, char *calling_func)
+{
+    if (SUCCESS != status)
+    {
+        errno = status;
+        perror(calling_func);
+        exit(EXIT_FAILURE);
+    }
+}
+
 static void CleanUpStubFunc(void *data)
 { 
     (UNUSED)data;
@@ -0,0 +1,157 @@
+/****************************************************
+ *  ALLOCATOR BENCHMARK                             *
+ *                                                  *
+ *  Memory held by a scheduler per queued task,     *
+ *  measured through a counting allocator. Built    *
+ *  once per priority queue backend (see the bench  *
+ *  target of the Makefile). Then the cost of going *
+ *  through the allocator table instead of calling  *
+ *  malloc() / free() directly.                     *
+ *                                                  *
+ ****************************************************/
+
+/*************************** LIBRARY INCLUDES ******************************/
+
+#include <stdio.h> /* printf */
+#include <stdlib.h> /* malloc free */
+#include <time.h> /* clock time */
+
+/*************************** HEADER INCLUDES ******************************/
+
+#include "scheduler.h" /* scheduler API */
+#include "allocator.h" /* counting_allocator_t */
+
+/************************** TYPEDEFS & STRUCTS ****************************/
+
+#ifndef PQ_BACKEND
+    #define PQ_BACKEND "sorted list"
+#endif
+
+#define PAIRS (10000000)
+#define BLOCK_SIZE (32)
+#define WINDOW (64)
+
+/************************ STATIC FUNCTIONS DECLARATIONS **********************/
+
+static void BenchBytesPerTask(size_t n);
+static void BenchTableCost(void);
+static int Nothing(void *params);
+static void NoClean(void *params);
+static double NsPerPair(clock_t start);
+
+/************************************ MAIN ***********************************/
+
+int main(void)
+{
+    printf("%-12s %10s %14s %14s %14s\n", "backend", "tasks", "bytes/task",
+                                                "peak/task", "blocks/task");
+
+    BenchBytesPerTask(1000);
+    BenchBytesPerTask(100000);
+
+    BenchTableCost();
+
+    return 0;
+}
+
+/*********************** STATIC FUNCTIONS DEFINITIONS ************************/
+
+/* the empty scheduler is not counted, only what the tasks add to it */
+static void BenchBytesPerTask(size_t n)
+{
+    counting_allocator_t counting;
+    scheduler_t *scheduler = NULL;
+    size_t empty_bytes = 0;
+    size_t empty_blocks = 0;
+    time_t later = time(NULL) + 3600;
+    int params = 0;
+    size_t index = 0;
+
+    AllocatorInitCounting(&counting, AllocatorMalloc());
+
+    scheduler = SchedulerCreateWithAllocator(&counting.allocator);
+    if (NULL == scheduler)
+    {
+        return;
+    }
+    empty_bytes = counting.bytes;
+    empty_blocks = counting.blocks;
+
+    for (index = 0; index < n; ++index)
+    {
+        SchedulerAdd(scheduler, Nothing, &params, NoClean,
+                                            later + (time_t)(index % 1000), 0);
+    }
+
+    printf("%-12s %10lu %14.1f %14.1f %14.2f\n", PQ_BACKEND, (unsigned long)n,
+                (double)(counting.bytes - empty_bytes) / n,
+                (double)(counting.peak_bytes - empty_bytes) / n,
+                (double)(counting.blocks - empty_blocks) / n);
+
+    SchedulerDestroy(scheduler);
+}
+
+/* a window of live blocks, so that free() does not hand back the same one */
+static void BenchTableCost(void)
+{
+    counting_allocator_t counting;
+    void *blocks[WINDOW] = {NULL};
+    size_t index = 0;
+    clock_t start = 0;
+
+    AllocatorInitCounting(&counting, AllocatorMalloc());
+
+    printf("\n%-28s %12s\n", "32 byte blocks", "ns/pair");
+
+    start = clock();
+    for (index = 0; index < PAIRS; ++index)
+    {
+        free(blocks[index % WINDOW]);
+        blocks[index % WINDOW] = malloc(BLOCK_SIZE);
+    }
+    printf("%-28s %12.2f\n", "malloc / free", NsPerPair(start));
+
+    start = clock();
+    for (index = 0; index < PAIRS; ++index)
+    {
+        AllocatorFree(AllocatorMalloc(), blocks[index % WINDOW], BLOCK_SIZE, 0);
+        blocks[index % WINDOW] = AllocatorAlloc(AllocatorMalloc(), BLOCK_SIZE, 0);
+    }
+    printf("%-28s %12.2f\n", "malloc allocator", NsPerPair(start));
+
+    for (index = 0; index < WINDOW; ++index)
+    {
+        free(blocks[index]);
+        blocks[index] = NULL;
+    }
+
+    start = clock();
+    for (index = 0; index < PAIRS; ++index)
+    {
+        AllocatorFree(&counting.allocator, blocks[index % WINDOW], BLOCK_SIZE, 0);
+        blocks[index % WINDOW] = AllocatorAlloc(&counting.allocator, BLOCK_SIZE, 0);
+    }
+    printf("%-28s %12.2f\n", "counting allocator", NsPerPair(start));
+
+    for (index = 0; index < WINDOW; ++index)
+    {
+        AllocatorFree(&counting.allocator, blocks[index], BLOCK_SIZE, 0);
+    }
+}
+
+static int Nothing(void *params)
+{
+    (void)params;
+
+    return 0;
+}
+
+static void NoClean(void *params)
+{
+    (void)params;
+}
+
+static double NsPerPair(clock_t start)
+{
+    return (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / PAIRS;
+}
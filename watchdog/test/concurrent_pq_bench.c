@@ -0,0 +1,346 @@
+/****************************************************
+ *  CONCURRENT PRIORITY QUEUE BENCHMARK             *
+ *                                                  *
+ *  Hold model on 1 to 16 threads: each operation   *
+ *  dequeues an element and enqueues it again with  *
+ *  a later key. The multi-queue of concurrent_PQ   *
+ *  against one heap behind one mutex. Afterwards   *
+ *  the queue is drained, checking that every       *
+ *  element is still there exactly once. Then how   *
+ *  relaxed the order is: the share of dequeues, on *
+ *  one thread, smaller than the one before.        *
+ *                                                  *
+ ****************************************************/
+
+/*************************** LIBRARY INCLUDES ******************************/
+
+#include <stdio.h> /* printf */
+#include <stdlib.h> /* malloc free */
+#include <string.h> /* memset */
+#include <time.h> /* clock_gettime */
+#include <pthread.h> /* pthread_mutex_t */
+
+/*************************** HEADER INCLUDES ******************************/
+
+#include "concurrent_PQ.h" /* p_queue_t API */
+#include "heap.h" /* heap_t API */
+#include "parallel.h" /* ParallelRun */
+
+/************************** TYPEDEFS & STRUCTS ****************************/
+
+#define MAX_THREADS (16)
+#define ELEMENTS (10000)
+#define OPERATIONS (2000000) /* in all, split between the threads */
+#define MAX_STEP (1000)
+
+typedef struct element
+{
+    unsigned long key;
+    size_t handle;
+    size_t id;
+} element_t;
+
+typedef struct locked_heap
+{
+    pthread_mutex_t lock;
+    heap_t *heap;
+} locked_heap_t;
+
+typedef struct worker
+{
+    p_queue_t *queue;       /* either this */
+    locked_heap_t *locked;  /* or this */
+    size_t operations;
+    unsigned long random;
+    size_t misses;          /* dequeues that found nothing */
+} worker_t;
+
+/************************ STATIC FUNCTIONS DECLARATIONS **********************/
+
+static void BenchThreads(size_t threads);
+static double RunWorkers(p_queue_t *queue, locked_heap_t *locked, size_t threads);
+static void Work(void *worker);
+static size_t CountLost(element_t *elements, p_queue_t *queue, locked_heap_t *locked);
+static void BenchOrder(void);
+static element_t *CreateElements(size_t count);
+static unsigned long Step(unsigned long *random);
+static int KeyCmp(const void *queuedata, void *comparedata);
+static unsigned long Key(const void *queuedata);
+static void SetHandle(void *queuedata, size_t handle);
+static double Seconds(void);
+
+/************************************ MAIN ***********************************/
+
+int main(void)
+{
+    size_t threads = 0;
+
+    printf("%8s %16s %16s %10s\n", "threads", "mutex heap ns", "multi-queue ns",
+                                                                    "lost");
+    for (threads = 1; threads <= MAX_THREADS; threads *= 2)
+    {
+        BenchThreads(threads);
+    }
+
+    BenchOrder();
+
+    return 0;
+}
+
+/*********************** STATIC FUNCTIONS DEFINITIONS ************************/
+
+/* ns per operation, wall time across all the threads */
+static void BenchThreads(size_t threads)
+{
+    element_t *heap_elements = CreateElements(ELEMENTS);
+    element_t *queue_elements = CreateElements(ELEMENTS);
+    locked_heap_t locked;
+    p_queue_t *queue = PQueueCreateKeyed(KeyCmp, Key, SetHandle);
+    double heap_ns = 0;
+    double queue_ns = 0;
+    size_t lost = 0;
+    size_t index = 0;
+
+    locked.heap = HeapCreate(KeyCmp);
+    pthread_mutex_init(&locked.lock, NULL);
+
+    if (NULL == heap_elements || NULL == queue_elements || NULL == queue
+                                                        || NULL == locked.heap)
+    {
+        printf("out of memory\n");
+        exit(1);
+    }
+
+    for (index = 0; index < ELEMENTS; ++index)
+    {
+        HeapPush(locked.heap, &heap_elements[index]);
+        PQueueEnqueue(queue, &queue_elements[index]);
+    }
+
+    heap_ns = RunWorkers(NULL, &locked, threads);
+    queue_ns = RunWorkers(queue, NULL, threads);
+
+    lost = CountLost(heap_elements, NULL, &locked)
+                                    + CountLost(queue_elements, queue, NULL);
+
+    printf("%8lu %16.1f %16.1f %10lu\n", (unsigned long)threads, heap_ns,
+                                                    queue_ns, (unsigned long)lost);
+
+    PQueueDestroy(queue);
+    HeapDestroy(locked.heap);
+    pthread_mutex_destroy(&locked.lock);
+    free(heap_elements);
+    free(queue_elements);
+}
+
+static double RunWorkers(p_queue_t *queue, locked_heap_t *locked, size_t threads)
+{
+    worker_t workers[MAX_THREADS];
+    size_t misses = 0;
+    size_t index = 0;
+    double seconds = 0;
+
+    memset(workers, 0, sizeof(workers));
+    for (index = 0; index < threads; ++index)
+    {
+        workers[index].queue = queue;
+        workers[index].locked = locked;
+        workers[index].operations = OPERATIONS / threads;
+        workers[index].random = 2 * index + 1;
+    }
+
+    seconds = Seconds();
+    ParallelRun(Work, workers, sizeof(worker_t), threads);
+    seconds = Seconds() - seconds;
+
+    for (index = 0; index < threads; ++index)
+    {
+        misses += workers[index].misses;
+    }
+    if (0 != misses)
+    {
+        printf("%lu dequeues found the queue empty\n", (unsigned long)misses);
+    }
+
+    return seconds * 1e9 / (OPERATIONS / threads * threads);
+}
+
+/* the queue never runs dry: every element taken out goes back in */
+static void Work(void *worker)
+{
+    worker_t *me = (worker_t *)worker;
+    element_t *element = NULL;
+    size_t index = 0;
+
+    for (index = 0; index < me->operations; ++index)
+    {
+        if (NULL != me->queue)
+        {
+            element = (element_t *)PQueueDequeue(me->queue);
+        }
+        else
+        {
+            pthread_mutex_lock(&me->locked->lock);
+            element = IsHeapEmpty(me->locked->heap) ? NULL
+                                        : (element_t *)HeapPeek(me->locked->heap);
+            HeapPop(me->locked->heap);
+            pthread_mutex_unlock(&me->locked->lock);
+        }
+
+        if (NULL == element)
+        {
+            ++me->misses;
+            continue;
+        }
+        element->key += Step(&me->random);
+
+        if (NULL != me->queue)
+        {
+            PQueueEnqueue(me->queue, element);
+        }
+        else
+        {
+            pthread_mutex_lock(&me->locked->lock);
+            HeapPush(me->locked->heap, element);
+            pthread_mutex_unlock(&me->locked->lock);
+        }
+    }
+}
+
+/* drains the queue, elements missing or found twice */
+static size_t CountLost(element_t *elements, p_queue_t *queue, locked_heap_t *locked)
+{
+    unsigned char *seen = (unsigned char *)calloc(ELEMENTS, 1);
+    element_t *element = NULL;
+    size_t lost = 0;
+    size_t index = 0;
+
+    if (NULL == seen)
+    {
+        return ELEMENTS;
+    }
+
+    while (NULL != queue ? !IsPQueueEmpty(queue) : !IsHeapEmpty(locked->heap))
+    {
+        if (NULL != queue)
+        {
+            element = (element_t *)PQueueDequeue(queue);
+        }
+        else
+        {
+            element = (element_t *)HeapPeek(locked->heap);
+            HeapPop(locked->heap);
+        }
+        lost += element < elements || element >= elements + ELEMENTS
+                                                    || 0 != seen[element->id]++;
+    }
+
+    for (index = 0; index < ELEMENTS; ++index)
+    {
+        lost += 1 != seen[index];
+    }
+
+    free(seen);
+
+    return lost;
+}
+
+/* handles are exercised too: every tenth element is erased and put back */
+static void BenchOrder(void)
+{
+    element_t *elements = CreateElements(ELEMENTS);
+    p_queue_t *queue = PQueueCreateKeyed(KeyCmp, Key, SetHandle);
+    element_t *element = NULL;
+    unsigned long random = 1;
+    unsigned long last = 0;
+    size_t smaller = 0;
+    size_t count = 0;
+    size_t index = 0;
+
+    if (NULL == elements || NULL == queue)
+    {
+        printf("out of memory\n");
+        exit(1);
+    }
+
+    for (index = 0; index < ELEMENTS; ++index)
+    {
+        elements[index].key = Step(&random) * ELEMENTS;
+        PQueueEnqueue(queue, &elements[index]);
+    }
+
+    for (index = 0; index < ELEMENTS; index += 10)
+    {
+        if (&elements[index] != PQueueErase(queue, elements[index].handle)
+                                        || PQ_NO_HANDLE != elements[index].handle)
+        {
+            printf("erase by handle failed\n");
+        }
+        PQueueEnqueue(queue, &elements[index]);
+    }
+
+    while (NULL != (element = (element_t *)PQueueDequeue(queue)))
+    {
+        smaller += element->key < last;
+        last = element->key;
+        ++count;
+    }
+
+    printf("\n%lu of %lu dequeues smaller than the one before (%.1f%%)\n",
+                (unsigned long)smaller, (unsigned long)count, 100.0 * smaller / count);
+
+    PQueueDestroy(queue);
+    free(elements);
+}
+
+static element_t *CreateElements(size_t count)
+{
+    element_t *elements = (element_t *)malloc(count * sizeof(element_t));
+    unsigned long random = 7;
+    size_t index = 0;
+
+    for (index = 0; NULL != elements && index < count; ++index)
+    {
+        elements[index].key = Step(&random);
+        elements[index].handle = PQ_NO_HANDLE;
+        elements[index].id = index;
+    }
+
+    return elements;
+}
+
+/* 1 to MAX_STEP, from a per caller linear congruential generator */
+static unsigned long Step(unsigned long *random)
+{
+    *random = *random * 1103515245ul + 12345ul;
+
+    return (*random >> 16) % MAX_STEP + 1;
+}
+
+static int KeyCmp(const void *queuedata, void *comparedata)
+{
+    unsigned long left = ((const element_t *)queuedata)->key;
+    unsigned long right = ((const element_t *)comparedata)->key;
+
+    return (left > right) - (left < right);
+}
+
+static unsigned long Key(const void *queuedata)
+{
+    return ((const element_t *)queuedata)->key;
+}
+
+static void SetHandle(void *queuedata, size_t handle)
+{
+    ((element_t *)queuedata)->handle = handle;
+}
+
+/* wall time, clock() would add up the threads */
+static double Seconds(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
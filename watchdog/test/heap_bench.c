@@ -0,0 +1,207 @@
+/****************************************************
+ *  HEAP BENCHMARK                                  *
+ *                                                  *
+ *  Counts the compare calls of heap_t against the  *
+ *  previous recursive swap-based heapify, on the   *
+ *  same push / pop sequence.                       *
+ *                                                  *
+ ****************************************************/
+
+/*************************** LIBRARY INCLUDES ******************************/
+
+#include <stdio.h> /* printf */
+#include <stdlib.h> /* malloc free rand */
+#include <time.h> /* clock */
+
+/*************************** HEADER INCLUDES ******************************/
+
+#include "heap.h" /* heap API */
+
+/************************** TYPEDEFS & STRUCTS ****************************/
+
+#define RUNS (3)
+
+static size_t g_cmp_counter = 0;
+
+/************************ STATIC FUNCTIONS DECLARATIONS **********************/
+
+static int CountingCmp(const void *heap_data, void *new_data);
+static void BenchHeap(size_t n, int *keys);
+static void BenchReference(size_t n, int *keys);
+static void RefHeapifyUp(void **arr, size_t index);
+static void RefHeapifyDown(void **arr, size_t size, size_t index);
+static void RefSwap(void **arr, size_t index1, size_t index2);
+
+/************************************ MAIN ***********************************/
+
+int main(void)
+{
+    size_t sizes[] = {1000, 100000, 1000000};
+    size_t index = 0;
+    size_t key = 0;
+    int *keys = NULL;
+
+    printf("%10s %-12s %14s %14s %10s\n",
+                        "n", "impl", "cmp/push", "cmp/pop", "ms");
+
+    for (index = 0; index < sizeof(sizes) / sizeof(sizes[0]); ++index)
+    {
+        keys = (int *)malloc(sizes[index] * sizeof(int));
+        if (NULL == keys)
+        {
+            return 1;
+        }
+
+        srand(42);
+        for (key = 0; key < sizes[index]; ++key)
+        {
+            keys[key] = rand();
+        }
+
+        BenchReference(sizes[index], keys);
+        BenchHeap(sizes[index], keys);
+
+        free(keys);
+    }
+
+    return 0;
+}
+
+/*********************** STATIC FUNCTIONS DEFINITIONS ************************/
+
+static int CountingCmp(const void *heap_data, void *new_data)
+{
+    int lhs = *(const int *)heap_data;
+    int rhs = *(int *)new_data;
+
+    ++g_cmp_counter;
+
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+static void BenchHeap(size_t n, int *keys)
+{
+    heap_t *heap = HeapCreate(CountingCmp);
+    size_t push_cmp = 0;
+    size_t pop_cmp = 0;
+    size_t index = 0;
+    size_t run = 0;
+    clock_t start = clock();
+
+    if (NULL == heap)
+    {
+        return;
+    }
+
+    for (run = 0; run < RUNS; ++run)
+    {
+        g_cmp_counter = 0;
+        for (index = 0; index < n; ++index)
+        {
+            HeapPush(heap, &keys[index]);
+        }
+        push_cmp += g_cmp_counter;
+
+        g_cmp_counter = 0;
+        while (!IsHeapEmpty(heap))
+        {
+            HeapPop(heap);
+        }
+        pop_cmp += g_cmp_counter;
+    }
+
+    printf("%10lu %-12s %14.2f %14.2f %10.1f\n", (unsigned long)n, "heap_t",
+                        (double)push_cmp / (RUNS * n), (double)pop_cmp / (RUNS * n),
+                        (double)(clock() - start) * 1000 / CLOCKS_PER_SEC);
+
+    HeapDestroy(heap);
+}
+
+/*
+    Previous heap.c algorithm: recursive heapify that swaps at every level,
+    and pops by swapping the last element to the root.
+*/
+static void BenchReference(size_t n, int *keys)
+{
+    void **arr = (void **)malloc((n + 1) * sizeof(void *));
+    size_t push_cmp = 0;
+    size_t pop_cmp = 0;
+    size_t size = 0;
+    size_t index = 0;
+    size_t run = 0;
+    clock_t start = clock();
+
+    if (NULL == arr)
+    {
+        return;
+    }
+
+    for (run = 0; run < RUNS; ++run)
+    {
+        g_cmp_counter = 0;
+        for (index = 0; index < n; ++index)
+        {
+            arr[++size] = &keys[index];
+            RefHeapifyUp(arr, size);
+        }
+        push_cmp += g_cmp_counter;
+
+        g_cmp_counter = 0;
+        while (0 < size)
+        {
+            RefSwap(arr, 1, size);
+            --size;
+            RefHeapifyDown(arr, size, 1);
+        }
+        pop_cmp += g_cmp_counter;
+    }
+
+    printf("%10lu %-12s %14.2f %14.2f %10.1f\n", (unsigned long)n, "recursive",
+                        (double)push_cmp / (RUNS * n), (double)pop_cmp / (RUNS * n),
+                        (double)(clock() - start) * 1000 / CLOCKS_PER_SEC);
+
+    free(arr);
+}
+
+static void RefHeapifyUp(void **arr, size_t index)
+{
+    if (1 >= index)
+    {
+        return;
+    }
+
+    if (0 < CountingCmp(arr[index / 2], arr[index]))
+    {
+        RefSwap(arr, index, index / 2);
+        RefHeapifyUp(arr, index / 2);
+    }
+}
+
+static void RefHeapifyDown(void **arr, size_t size, size_t index)
+{
+    size_t biggest = index;
+
+    if (index * 2 <= size && 0 < CountingCmp(arr[biggest], arr[index * 2]))
+    {
+        biggest = index * 2;
+    }
+
+    if (index * 2 + 1 <= size && 0 < CountingCmp(arr[biggest], arr[index * 2 + 1]))
+    {
+        biggest = index * 2 + 1;
+    }
+
+    if (biggest != index)
+    {
+        RefSwap(arr, index, biggest);
+        RefHeapifyDown(arr, size, biggest);
+    }
+}
+
+static void RefSwap(void **arr, size_t index1, size_t index2)
+{
+    void *temp = arr[index1];
+
+    arr[index1] = arr[index2];
+    arr[index2] = temp;
+}
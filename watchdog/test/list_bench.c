@@ -0,0 +1,137 @@
+/****************************************************
+ *  LIST BENCHMARK                                  *
+ *                                                  *
+ *  Queue workload on dll_t, one pop front and one  *
+ *  push back per op, with and without a node pool, *
+ *  and with the nodes inside the elements.         *
+ *  malloc / free are wrapped by the linker to      *
+ *  count the allocator calls (see the Makefile).   *
+ *                                                  *
+ ****************************************************/
+
+/*************************** LIBRARY INCLUDES ******************************/
+
+#include <stdio.h> /* printf */
+#include <stdlib.h> /* malloc free */
+#include <time.h> /* clock */
+
+/*************************** HEADER INCLUDES ******************************/
+
+#include "d_linked_list.h" /* dll API */
+
+/************************** TYPEDEFS & STRUCTS ****************************/
+
+#define OPS (1000000)
+
+static size_t g_alloc_calls = 0;
+
+void *__real_malloc(size_t size);
+void __real_free(void *ptr);
+void *__wrap_malloc(size_t size);
+void __wrap_free(void *ptr);
+
+/************************ STATIC FUNCTIONS DECLARATIONS **********************/
+
+static void BenchList(size_t n, dll_t *dll, const char *name);
+static void BenchLinked(size_t n);
+
+/************************************ MAIN ***********************************/
+
+int main(void)
+{
+    size_t sizes[] = {1000, 100000, 1000000};
+    size_t index = 0;
+
+    printf("%10s %-8s %16s %12s\n", "n", "nodes", "allocs/op", "ns/op");
+
+    for (index = 0; index < sizeof(sizes) / sizeof(sizes[0]); ++index)
+    {
+        BenchList(sizes[index], DLLCreate(), "malloc");
+        BenchList(sizes[index], DLLCreatePooled(), "pooled");
+        BenchLinked(sizes[index]);
+    }
+
+    return 0;
+}
+
+/*********************** STATIC FUNCTIONS DEFINITIONS ************************/
+
+static void BenchList(size_t n, dll_t *dll, const char *name)
+{
+    size_t index = 0;
+    size_t calls = 0;
+    clock_t start = 0;
+
+    if (NULL == dll)
+    {
+        return;
+    }
+
+    for (index = 0; index < n; ++index)
+    {
+        DLLPushBack(dll, &index);
+    }
+
+    calls = g_alloc_calls;
+    start = clock();
+    for (index = 0; index < OPS; ++index)
+    {
+        DLLPushBack(dll, DLLPopFront(dll));
+    }
+
+    printf("%10lu %-8s %16.6f %12.1f\n", (unsigned long)n, name,
+                (double)(g_alloc_calls - calls) / OPS,
+                (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / OPS);
+
+    DLLDestroy(dll);
+}
+
+static void BenchLinked(size_t n)
+{
+    dll_link_t *links = (dll_link_t *)malloc(n * sizeof(dll_link_t));
+    dll_t *dll = DLLCreate();
+    dll_link_t *link = NULL;
+    size_t index = 0;
+    size_t calls = 0;
+    clock_t start = 0;
+
+    if (NULL == links || NULL == dll)
+    {
+        free(links);
+        return;
+    }
+
+    for (index = 0; index < n; ++index)
+    {
+        DLLInsertLinkBefore(dll, DLLEnd(dll), &links[index], &links[index]);
+    }
+
+    calls = g_alloc_calls;
+    start = clock();
+    for (index = 0; index < OPS; ++index)
+    {
+        link = (dll_link_t *)DLLPopFront(dll);
+        DLLInsertLinkBefore(dll, DLLEnd(dll), link, link);
+    }
+
+    printf("%10lu %-8s %16.6f %12.1f\n", (unsigned long)n, "linked",
+                (double)(g_alloc_calls - calls) / OPS,
+                (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / OPS);
+
+    DLLDestroy(dll);
+    free(links);
+}
+
+void *__wrap_malloc(size_t size)
+{
+    ++g_alloc_calls;
+
+    return __real_malloc(size);
+}
+
+void __wrap_free(void *ptr)
+{
+    ++g_alloc_calls;
+
+    __real_free(ptr);
+}
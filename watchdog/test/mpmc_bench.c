@@ -0,0 +1,282 @@
+/****************************************************
+ *  MPMC QUEUE BENCHMARK                            *
+ *                                                  *
+ *  Stress first: producers and consumers on a      *
+ *  small queue, checking that every element comes  *
+ *  out exactly once and that each consumer sees    *
+ *  the elements of a producer in order. Then the   *
+ *  throughput for several producer / consumer      *
+ *  counts, one element or a batch per call.        *
+ *                                                  *
+ ****************************************************/
+
+/*************************** LIBRARY INCLUDES ******************************/
+
+#include <stdio.h> /* printf */
+#include <stdlib.h> /* calloc free */
+#include <string.h> /* memset */
+#include <time.h> /* clock_gettime */
+#include <sched.h> /* sched_yield */
+
+/*************************** HEADER INCLUDES ******************************/
+
+#include "mpmc_queue.h" /* MPMC queue API */
+#include "parallel.h" /* ParallelRun */
+
+/************************** TYPEDEFS & STRUCTS ****************************/
+
+#define MAX_THREADS (16)
+#define STRESS_ITEMS (200000) /* per producer */
+#define STRESS_CAPACITY (64)
+#define BENCH_ITEMS (4000000) /* in all */
+#define BENCH_CAPACITY (1024)
+#define BATCH (16)
+
+/* elements are 1 + producer * items + sequence, never NULL */
+#define ENCODE(producer, sequence, items) ((void *)(size_t)(1 + (producer) * (items) + (sequence)))
+#define DECODE(data) ((size_t)(data) - 1)
+
+typedef struct role
+{
+    mpmc_queue_t *queue;
+    int is_producer;
+    size_t id;
+    size_t items;       /* to enqueue by a producer, per producer */
+    size_t batch;
+    size_t *consumed;   /* shared by the consumers */
+    size_t total;       /* to dequeue by all the consumers */
+    unsigned char *seen; /* count of each element, stress only */
+    size_t *last;       /* per producer, last sequence seen + 1 */
+    size_t producers;
+    size_t errors;
+} role_t;
+
+/************************ STATIC FUNCTIONS DECLARATIONS **********************/
+
+static size_t Stress(size_t producers, size_t consumers, size_t batch);
+static double Bench(size_t producers, size_t consumers, size_t batch);
+static void Run(void *role);
+static void Produce(role_t *role);
+static void Consume(role_t *role);
+static void Check(role_t *role, void *data);
+static double Seconds(void);
+
+/************************************ MAIN ***********************************/
+
+int main(void)
+{
+    size_t counts[][2] = {{1, 1}, {1, 4}, {4, 1}, {2, 2}, {4, 4}, {8, 8}};
+    size_t index = 0;
+
+    printf("%10s %10s %8s %12s\n", "producers", "consumers", "batch", "errors");
+    for (index = 0; index < sizeof(counts) / sizeof(counts[0]); ++index)
+    {
+        printf("%10lu %10lu %8d %12lu\n", (unsigned long)counts[index][0],
+                (unsigned long)counts[index][1], 1,
+                (unsigned long)Stress(counts[index][0], counts[index][1], 1));
+        printf("%10lu %10lu %8d %12lu\n", (unsigned long)counts[index][0],
+                (unsigned long)counts[index][1], BATCH,
+                (unsigned long)Stress(counts[index][0], counts[index][1], BATCH));
+    }
+
+    printf("\n%10s %10s %14s %14s\n", "producers", "consumers", "ns/item",
+                                                            "ns/item batch");
+    for (index = 0; index < sizeof(counts) / sizeof(counts[0]); ++index)
+    {
+        printf("%10lu %10lu %14.1f %14.1f\n", (unsigned long)counts[index][0],
+                (unsigned long)counts[index][1],
+                Bench(counts[index][0], counts[index][1], 1),
+                Bench(counts[index][0], counts[index][1], BATCH));
+    }
+
+    return 0;
+}
+
+/*********************** STATIC FUNCTIONS DEFINITIONS ************************/
+
+/* lost, duplicated and out of order elements */
+static size_t Stress(size_t producers, size_t consumers, size_t batch)
+{
+    role_t roles[2 * MAX_THREADS];
+    mpmc_queue_t *queue = MPMCQueueCreate(STRESS_CAPACITY);
+    size_t total = producers * STRESS_ITEMS;
+    unsigned char *seen = (unsigned char *)calloc(total, 1);
+    size_t *lasts = (size_t *)calloc(consumers * producers, sizeof(size_t));
+    size_t consumed = 0;
+    size_t errors = 0;
+    size_t index = 0;
+
+    if (NULL == queue || NULL == seen || NULL == lasts)
+    {
+        free(seen);
+        free(lasts);
+        return (size_t)-1;
+    }
+
+    memset(roles, 0, sizeof(roles));
+    for (index = 0; index < producers + consumers; ++index)
+    {
+        roles[index].queue = queue;
+        roles[index].is_producer = index < producers;
+        roles[index].id = index < producers ? index : index - producers;
+        roles[index].items = STRESS_ITEMS;
+        roles[index].batch = batch;
+        roles[index].consumed = &consumed;
+        roles[index].total = total;
+        roles[index].seen = seen;
+        roles[index].last = lasts + (index < producers ? 0 : index - producers) * producers;
+        roles[index].producers = producers;
+    }
+
+    ParallelRun(Run, roles, sizeof(role_t), producers + consumers);
+
+    for (index = 0; index < producers + consumers; ++index)
+    {
+        errors += roles[index].errors;
+    }
+    for (index = 0; index < total; ++index)
+    {
+        errors += 1 != seen[index];
+    }
+    errors += 0 != MPMCQueueSize(queue);
+
+    MPMCQueueDestroy(queue);
+    free(seen);
+    free(lasts);
+
+    return errors;
+}
+
+/* wall time per element, from the first enqueue to the last dequeue */
+static double Bench(size_t producers, size_t consumers, size_t batch)
+{
+    role_t roles[2 * MAX_THREADS];
+    mpmc_queue_t *queue = MPMCQueueCreate(BENCH_CAPACITY);
+    size_t consumed = 0;
+    size_t index = 0;
+    double seconds = 0;
+
+    if (NULL == queue)
+    {
+        return 0;
+    }
+
+    memset(roles, 0, sizeof(roles));
+    for (index = 0; index < producers + consumers; ++index)
+    {
+        roles[index].queue = queue;
+        roles[index].is_producer = index < producers;
+        roles[index].id = index;
+        roles[index].items = BENCH_ITEMS / producers;
+        roles[index].batch = batch;
+        roles[index].consumed = &consumed;
+        roles[index].total = BENCH_ITEMS / producers * producers;
+    }
+
+    seconds = Seconds();
+    ParallelRun(Run, roles, sizeof(role_t), producers + consumers);
+    seconds = Seconds() - seconds;
+
+    MPMCQueueDestroy(queue);
+
+    return seconds * 1e9 / (BENCH_ITEMS / producers * producers);
+}
+
+static void Run(void *role)
+{
+    role_t *me = (role_t *)role;
+
+    if (me->is_producer)
+    {
+        Produce(me);
+    }
+    else
+    {
+        Consume(me);
+    }
+}
+
+/* a full queue gives the processor away, there may be fewer than threads */
+static void Produce(role_t *role)
+{
+    void *batch[BATCH];
+    size_t sequence = 0;
+    size_t done = 0;
+    size_t index = 0;
+    size_t count = 0;
+
+    while (sequence < role->items)
+    {
+        count = role->items - sequence < role->batch ? role->items - sequence : role->batch;
+        for (index = 0; index < count; ++index)
+        {
+            batch[index] = ENCODE(role->id, sequence + index, role->items);
+        }
+
+        for (index = 0; index < count; index += done)
+        {
+            done = MPMCQueueEnqueueBatch(role->queue, batch + index, count - index);
+            if (0 == done)
+            {
+                sched_yield();
+            }
+        }
+        sequence += count;
+    }
+}
+
+/* stops once all the elements are taken, by this consumer or the others */
+static void Consume(role_t *role)
+{
+    void *batch[BATCH];
+    size_t done = 0;
+    size_t index = 0;
+
+    while (__atomic_load_n(role->consumed, __ATOMIC_RELAXED) < role->total)
+    {
+        done = MPMCQueueDequeueBatch(role->queue, batch, role->batch);
+        if (0 == done)
+        {
+            sched_yield();
+            continue;
+        }
+
+        __atomic_add_fetch(role->consumed, done, __ATOMIC_RELAXED);
+        if (NULL != role->seen)
+        {
+            for (index = 0; index < done; ++index)
+            {
+                Check(role, batch[index]);
+            }
+        }
+    }
+}
+
+static void Check(role_t *role, void *data)
+{
+    size_t element = DECODE(data);
+    size_t producer = element / role->items;
+    size_t sequence = element % role->items;
+
+    if (producer >= role->producers)
+    {
+        ++role->errors;
+        return;
+    }
+
+    __atomic_add_fetch(&role->seen[element], 1, __ATOMIC_RELAXED);
+
+    /* a producer's elements reach any one consumer in order */
+    role->errors += sequence < role->last[producer];
+    role->last[producer] = sequence + 1;
+}
+
+/* wall time, clock() would add up the threads */
+static double Seconds(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
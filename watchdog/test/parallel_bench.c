@@ -0,0 +1,206 @@
+/****************************************************
+ *  PARALLEL LIST BENCHMARK                         *
+ *                                                  *
+ *  DLLParallelForEach, DLLParallelMultiFind and    *
+ *  SortedListParallelMerge on lists of n elements  *
+ *  (10M by default), for 1 to 8 threads. The for   *
+ *  each runs a cheap and a costly action.          *
+ *                                                  *
+ ****************************************************/
+
+/*************************** LIBRARY INCLUDES ******************************/
+
+#include <stdio.h> /* printf */
+#include <stdlib.h> /* malloc free strtoul */
+#include <time.h> /* clock_gettime */
+
+/*************************** HEADER INCLUDES ******************************/
+
+#include "d_linked_list.h" /* dll_t API */
+#include "sorted_linked_list.h" /* sorted_list_t API */
+#include "vector.h" /* vector_t API */
+#include "parallel.h" /* ParallelThreads */
+
+/************************** TYPEDEFS & STRUCTS ****************************/
+
+#define DEFAULT_SIZE (10000000)
+#define HASH_ROUNDS (64)
+
+typedef struct element
+{
+    unsigned long key;
+    unsigned long hash;
+} element_t;
+
+/************************ STATIC FUNCTIONS DECLARATIONS **********************/
+
+static void BenchDLL(element_t *elements, size_t n);
+static void BenchMerge(element_t *elements, size_t n);
+static int Touch(void *list_data, void *unused);
+static int Hash(void *list_data, void *unused);
+static int IsSeventh(const void *list_data, void *unused);
+static int KeyCmp(const void *list_data, void *new_data);
+static double Seconds(void);
+static void PrintRow(const char *op, size_t threads, size_t n, double start);
+
+/************************************ MAIN ***********************************/
+
+int main(int argc, char *argv[])
+{
+    size_t n = 1 < argc ? strtoul(argv[1], NULL, 10) : DEFAULT_SIZE;
+    element_t *elements = (element_t *)malloc(n * sizeof(element_t));
+    size_t index = 0;
+
+    if (NULL == elements)
+    {
+        return 1;
+    }
+
+    for (index = 0; index < n; ++index)
+    {
+        elements[index].key = index;
+    }
+
+    printf("%lu processors online\n", (unsigned long)ParallelThreads());
+    printf("%-14s %8s %10s %12s\n", "op", "threads", "n", "ns/element");
+
+    BenchDLL(elements, n);
+    BenchMerge(elements, n);
+
+    free(elements);
+
+    return 0;
+}
+
+/*********************** STATIC FUNCTIONS DEFINITIONS ************************/
+
+static void BenchDLL(element_t *elements, size_t n)
+{
+    dll_t *dll = DLLCreatePooled();
+    vector_t *found = VectorCreate(1, sizeof(void *));
+    size_t threads = 0;
+    size_t index = 0;
+    double start = 0;
+
+    if (NULL == dll || NULL == found)
+    {
+        return;
+    }
+
+    for (index = 0; index < n; ++index)
+    {
+        DLLPushBack(dll, &elements[index]);
+    }
+
+    for (threads = 1; threads <= 8; threads *= 2)
+    {
+        start = Seconds();
+        DLLParallelForEach(dll, DLLBegin(dll), DLLEnd(dll), elements, Touch, threads);
+        PrintRow("for each", threads, n, start);
+
+        start = Seconds();
+        DLLParallelForEach(dll, DLLBegin(dll), DLLEnd(dll), elements, Hash, threads);
+        PrintRow("for each hash", threads, n, start);
+
+        start = Seconds();
+        DLLParallelMultiFind(dll, DLLBegin(dll), DLLEnd(dll), elements, IsSeventh, 
+                                                                    found, threads);
+        PrintRow("multi find", threads, n, start);
+
+        while (0 < VectorSize(found))
+        {
+            VectorPopBack(found);
+        }
+    }
+
+    VectorDestroy(found);
+    DLLDestroy(dll);
+}
+
+/* even keys in dest, odd ones in src, so the merge interleaves them */
+static void BenchMerge(element_t *elements, size_t n)
+{
+    sorted_list_t *dest = NULL;
+    sorted_list_t *src = NULL;
+    size_t threads = 0;
+    size_t index = 0;
+    double start = 0;
+
+    for (threads = 1; threads <= 8; threads *= 2)
+    {
+        dest = SortedListCreate(KeyCmp);
+        src = SortedListCreate(KeyCmp);
+        if (NULL == dest || NULL == src)
+        {
+            return;
+        }
+
+        for (index = 0; index < n; ++index)
+        {
+            SortedListInsert(0 == index % 2 ? dest : src, &elements[index]);
+        }
+
+        start = Seconds();
+        SortedListParallelMerge(dest, src, threads);
+        PrintRow("merge", threads, n, start);
+
+        SortedListDestroy(dest);
+        SortedListDestroy(src);
+    }
+}
+
+static int Touch(void *list_data, void *unused)
+{
+    (void)unused;
+
+    ((element_t *)list_data)->hash = ((element_t *)list_data)->key;
+
+    return 0;
+}
+
+static int Hash(void *list_data, void *unused)
+{
+    unsigned long hash = ((element_t *)list_data)->key;
+    size_t round = 0;
+
+    (void)unused;
+
+    for (round = 0; round < HASH_ROUNDS; ++round)
+    {
+        hash = (hash ^ (hash >> 29)) * 0xBF58476D1CE4E5B9UL;
+    }
+    ((element_t *)list_data)->hash = hash;
+
+    return 0;
+}
+
+static int IsSeventh(const void *list_data, void *unused)
+{
+    (void)unused;
+
+    return 0 == ((const element_t *)list_data)->key % 7;
+}
+
+static int KeyCmp(const void *list_data, void *new_data)
+{
+    unsigned long lhs = ((const element_t *)list_data)->key;
+    unsigned long rhs = ((element_t *)new_data)->key;
+
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+/* wall time, clock() would add up the threads */
+static double Seconds(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static void PrintRow(const char *op, size_t threads, size_t n, double start)
+{
+    printf("%-14s %8lu %10lu %12.2f\n", op, (unsigned long)threads, (unsigned long)n, 
+                                                    (Seconds() - start) * 1e9 / n);
+}
@@ -0,0 +1,328 @@
+/****************************************************
+ *  PERSISTENT PRIORITY QUEUE BENCHMARK             *
+ *                                                  *
+ *  Hold model on the mapped file against heap.c in *
+ *  memory. Then the cost of getting a queue of n   *
+ *  jobs back after a restart: opening the file,    *
+ *  against pushing the n jobs into a new heap.     *
+ *  Last, children killed at random points of their *
+ *  updates: the queue they leave must open, come   *
+ *  out in order, with no job broken or twice.      *
+ *                                                  *
+ ****************************************************/
+
+/*************************** LIBRARY INCLUDES ******************************/
+
+#include <stdio.h> /* printf */
+#include <stdlib.h> /* malloc free */
+#include <string.h> /* memset */
+#include <time.h> /* clock_gettime nanosleep */
+#include <signal.h> /* kill SIGKILL */
+#include <unistd.h> /* fork unlink */
+#include <sys/wait.h> /* waitpid */
+
+/*************************** HEADER INCLUDES ******************************/
+
+#include "persistent_PQ.h" /* persistent_pq_t API */
+#include "heap.h" /* heap_t API */
+
+/************************** TYPEDEFS & STRUCTS ****************************/
+
+#define PATH "/tmp/persistent_pq_bench.pq"
+#define HOLD_OPERATIONS (1000000)
+#define MAX_STEP (1000)
+#define CRASHES (100)
+#define CHECK_MAGIC (0x9e3779b97f4a7c15ul)
+#define CHILD_ID_BITS (18) /* ids a child can enqueue, as a power of two */
+
+typedef struct job
+{
+    unsigned long key;
+    unsigned long id;
+    unsigned long check; /* key ^ id ^ CHECK_MAGIC, catches torn copies */
+} job_t;
+
+/************************ STATIC FUNCTIONS DECLARATIONS **********************/
+
+static void BenchHold(size_t n);
+static void BenchReopen(size_t n);
+static void BenchCrashes(void);
+static void RunUntilKilled(unsigned long seed);
+static size_t CheckDrain(persistent_pq_t *queue, unsigned char *seen, size_t ids);
+static job_t MakeJob(unsigned long key, unsigned long id);
+static unsigned long Next(unsigned long *random);
+static int JobCmp(const void *record, const void *other);
+static int HeapJobCmp(const void *heap_data, void *new_data);
+static double Seconds(void);
+
+/************************************ MAIN ***********************************/
+
+int main(void)
+{
+    printf("%10s %16s %16s\n", "jobs", "heap ns/op", "mapped ns/op");
+    BenchHold(1000);
+    BenchHold(1000000);
+
+    printf("\n%10s %16s %16s\n", "jobs", "rebuild ms", "reopen ms");
+    BenchReopen(1000000);
+    BenchReopen(10000000);
+
+    BenchCrashes();
+
+    unlink(PATH);
+
+    return 0;
+}
+
+/*********************** STATIC FUNCTIONS DEFINITIONS ************************/
+
+/* each operation dequeues a job and enqueues it again, later */
+static void BenchHold(size_t n)
+{
+    job_t *jobs = (job_t *)malloc(n * sizeof(job_t));
+    heap_t *heap = HeapCreate(HeapJobCmp);
+    persistent_pq_t *queue = NULL;
+    unsigned long random = 1;
+    job_t *top = NULL;
+    job_t job;
+    double heap_ns = 0;
+    double mapped_ns = 0;
+    size_t index = 0;
+
+    unlink(PATH);
+    queue = PersistentPQOpen(PATH, sizeof(job_t), JobCmp);
+    if (NULL == jobs || NULL == heap || NULL == queue)
+    {
+        printf("cannot make the queues\n");
+        exit(1);
+    }
+
+    for (index = 0; index < n; ++index)
+    {
+        jobs[index] = MakeJob(Next(&random) % MAX_STEP, index);
+        HeapPush(heap, &jobs[index]);
+        PersistentPQEnqueue(queue, &jobs[index]);
+    }
+
+    heap_ns = Seconds();
+    for (index = 0; index < HOLD_OPERATIONS; ++index)
+    {
+        top = (job_t *)HeapPeek(heap);
+        HeapPop(heap);
+        top->key += Next(&random) % MAX_STEP;
+        HeapPush(heap, top);
+    }
+    heap_ns = (Seconds() - heap_ns) * 1e9 / HOLD_OPERATIONS;
+
+    mapped_ns = Seconds();
+    for (index = 0; index < HOLD_OPERATIONS; ++index)
+    {
+        PersistentPQDequeue(queue, &job);
+        job.key += Next(&random) % MAX_STEP;
+        PersistentPQEnqueue(queue, &job);
+    }
+    mapped_ns = (Seconds() - mapped_ns) * 1e9 / HOLD_OPERATIONS;
+
+    printf("%10lu %16.1f %16.1f\n", (unsigned long)n, heap_ns, mapped_ns);
+
+    PersistentPQClose(queue);
+    HeapDestroy(heap);
+    free(jobs);
+}
+
+/* what a restarted process pays before it can dequeue the first job */
+static void BenchReopen(size_t n)
+{
+    job_t *jobs = (job_t *)malloc(n * sizeof(job_t));
+    heap_t *heap = HeapCreate(HeapJobCmp);
+    persistent_pq_t *queue = NULL;
+    unsigned long random = 3;
+    double rebuild_ms = 0;
+    double reopen_ms = 0;
+    size_t index = 0;
+
+    unlink(PATH);
+    queue = PersistentPQOpen(PATH, sizeof(job_t), JobCmp);
+    if (NULL == jobs || NULL == heap || NULL == queue)
+    {
+        printf("cannot make the queues\n");
+        exit(1);
+    }
+
+    for (index = 0; index < n; ++index)
+    {
+        jobs[index] = MakeJob(Next(&random), index);
+        PersistentPQEnqueue(queue, &jobs[index]);
+    }
+    PersistentPQClose(queue);
+
+    rebuild_ms = Seconds();
+    for (index = 0; index < n; ++index)
+    {
+        HeapPush(heap, &jobs[index]);
+    }
+    rebuild_ms = (Seconds() - rebuild_ms) * 1e3;
+
+    reopen_ms = Seconds();
+    queue = PersistentPQOpen(PATH, sizeof(job_t), JobCmp);
+    if (NULL == queue || n != PersistentPQSize(queue)
+                    || ((job_t *)HeapPeek(heap))->key != ((const job_t *)PersistentPQPeek(queue))->key)
+    {
+        printf("the reopened queue differs\n");
+        exit(1);
+    }
+    reopen_ms = (Seconds() - reopen_ms) * 1e3;
+
+    printf("%10lu %16.2f %16.3f\n", (unsigned long)n, rebuild_ms, reopen_ms);
+
+    PersistentPQClose(queue);
+    HeapDestroy(heap);
+    free(jobs);
+}
+
+/*
+    Each child goes on from the queue the one before left, each job id is
+    enqueued once, so that a job coming out twice means a broken update.
+*/
+static void BenchCrashes(void)
+{
+    persistent_pq_t *queue = NULL;
+    unsigned char *seen = NULL;
+    unsigned long random = 5;
+    struct timespec wait = {0, 0};
+    size_t recovered = 0;
+    size_t errors = 0;
+    size_t crash = 0;
+    pid_t child = 0;
+
+    unlink(PATH);
+
+    for (crash = 0; crash < CRASHES; ++crash)
+    {
+        child = fork();
+        if (0 == child)
+        {
+            RunUntilKilled(crash + 1);
+        }
+
+        wait.tv_nsec = (long)(Next(&random) % 5000000 + 100000);
+        nanosleep(&wait, NULL);
+        kill(child, SIGKILL);
+        waitpid(child, NULL, 0);
+
+        queue = PersistentPQOpen(PATH, sizeof(job_t), JobCmp);
+        if (NULL == queue)
+        {
+            ++errors;
+            continue;
+        }
+        recovered += 0 != PersistentPQSize(queue);
+        PersistentPQClose(queue);
+    }
+
+    /* ids are (child << CHILD_ID_BITS) + count, children from 1 */
+    queue = PersistentPQOpen(PATH, sizeof(job_t), JobCmp);
+    seen = (unsigned char *)calloc(CRASHES + 1, 1ul << CHILD_ID_BITS);
+    if (NULL == queue || NULL == seen)
+    {
+        printf("cannot reopen the queue\n");
+        exit(1);
+    }
+    errors += CheckDrain(queue, seen, (size_t)(CRASHES + 1) << CHILD_ID_BITS);
+
+    printf("\n%d children killed, %lu queues reopened non empty, %lu errors\n",
+                        CRASHES, (unsigned long)recovered, (unsigned long)errors);
+
+    PersistentPQClose(queue);
+    free(seen);
+}
+
+/* two enqueues per dequeue, the queue keeps growing through the file */
+static void RunUntilKilled(unsigned long seed)
+{
+    persistent_pq_t *queue = PersistentPQOpen(PATH, sizeof(job_t), JobCmp);
+    unsigned long random = seed;
+    unsigned long count = 0;
+    job_t job;
+
+    if (NULL == queue)
+    {
+        _exit(1);
+    }
+
+    while (count < (1ul << CHILD_ID_BITS))
+    {
+        job = MakeJob(Next(&random) % 100000, (seed << CHILD_ID_BITS) + count++);
+        PersistentPQEnqueue(queue, &job);
+        job = MakeJob(Next(&random) % 100000, (seed << CHILD_ID_BITS) + count++);
+        PersistentPQEnqueue(queue, &job);
+        PersistentPQDequeue(queue, &job);
+    }
+
+    _exit(0);
+}
+
+/* errors: jobs out of order, torn, or seen twice */
+static size_t CheckDrain(persistent_pq_t *queue, unsigned char *seen, size_t ids)
+{
+    size_t errors = 0;
+    unsigned long last = 0;
+    job_t job;
+
+    while (0 == PersistentPQDequeue(queue, &job))
+    {
+        errors += job.key < last;
+        errors += (job.key ^ job.id ^ CHECK_MAGIC) != job.check;
+        if (job.id < ids)
+        {
+            errors += 0 != seen[job.id]++;
+        }
+        else
+        {
+            ++errors;
+        }
+        last = job.key;
+    }
+
+    return errors;
+}
+
+static job_t MakeJob(unsigned long key, unsigned long id)
+{
+    job_t job;
+
+    job.key = key;
+    job.id = id;
+    job.check = key ^ id ^ CHECK_MAGIC;
+
+    return job;
+}
+
+static unsigned long Next(unsigned long *random)
+{
+    *random = *random * 6364136223846793005ul + 1442695040888963407ul;
+
+    return *random >> 17;
+}
+
+static int JobCmp(const void *record, const void *other)
+{
+    unsigned long left = ((const job_t *)record)->key;
+    unsigned long right = ((const job_t *)other)->key;
+
+    return (left > right) - (left < right);
+}
+
+static int HeapJobCmp(const void *heap_data, void *new_data)
+{
+    return JobCmp(heap_data, new_data);
+}
+
+static double Seconds(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
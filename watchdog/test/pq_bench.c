@@ -0,0 +1,134 @@
+/****************************************************
+ *  PRIORITY QUEUE BENCHMARK                        *
+ *                                                  *
+ *  Scheduler-like workload : n timers, each one is *
+ *  dequeued at its deadline and enqueued back at   *
+ *  deadline + interval. Built once per backend     *
+ *  (see the bench target of the Makefile). Minor   *
+ *  page faults stand in for TLB pressure.          *
+ *                                                  *
+ ****************************************************/
+
+/*************************** LIBRARY INCLUDES ******************************/
+
+#include <stdio.h> /* printf */
+#include <stdlib.h> /* malloc free rand strtoul */
+#include <time.h> /* clock */
+#include <sys/resource.h> /* getrusage */
+
+/*************************** HEADER INCLUDES ******************************/
+
+#include "priority_queue.h" /* p_queue_t API */
+
+/************************** TYPEDEFS & STRUCTS ****************************/
+
+#ifndef PQ_BACKEND
+    #define PQ_BACKEND "sorted list"
+#endif
+
+#define OPS (1000000)
+#define MAX_INTERVAL (1000)
+
+typedef struct timer
+{
+    unsigned long deadline;
+    size_t handle;
+} bench_timer_t;
+
+/************************ STATIC FUNCTIONS DECLARATIONS **********************/
+
+static void BenchSize(size_t n);
+static int DeadlineCmp(const void *queue_data, void *new_data);
+static unsigned long DeadlineKey(const void *queue_data);
+static void SetHandle(void *queue_data, size_t handle);
+static long MinorFaults(void);
+
+/************************************ MAIN ***********************************/
+
+int main(int argc, char *argv[])
+{
+    int arg = 1;
+
+    printf("%-12s %10s %10s %12s %12s\n", "backend", "n", "ops", "ns/op", "minor faults");
+
+    if (1 == argc)
+    {
+        BenchSize(1000);
+        BenchSize(10000);
+        BenchSize(100000);
+    }
+
+    for (arg = 1; arg < argc; ++arg)
+    {
+        BenchSize(strtoul(argv[arg], NULL, 10));
+    }
+
+    return 0;
+}
+
+/*********************** STATIC FUNCTIONS DEFINITIONS ************************/
+
+static void BenchSize(size_t n)
+{
+    bench_timer_t *timers = (bench_timer_t *)malloc(n * sizeof(bench_timer_t));
+    bench_timer_t *curr = NULL;
+    p_queue_t *queue = PQueueCreateKeyed(DeadlineCmp, DeadlineKey, SetHandle);
+    size_t index = 0;
+    clock_t start = 0;
+    long faults = MinorFaults();
+
+    if (NULL == timers || NULL == queue)
+    {
+        free(timers);
+        return;
+    }
+
+    srand(42);
+    for (index = 0; index < n; ++index)
+    {
+        timers[index].deadline = rand() % MAX_INTERVAL;
+        PQueueEnqueue(queue, &timers[index]);
+    }
+
+    start = clock();
+    for (index = 0; index < OPS; ++index)
+    {
+        curr = (bench_timer_t *)PQueueDequeue(queue);
+        curr->deadline += 1 + rand() % MAX_INTERVAL;
+        PQueueEnqueue(queue, curr);
+    }
+
+    printf("%-12s %10lu %10d %12.1f %12ld\n", PQ_BACKEND, (unsigned long)n, OPS,
+                (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / OPS,
+                MinorFaults() - faults);
+
+    PQueueDestroy(queue);
+    free(timers);
+}
+
+static int DeadlineCmp(const void *queue_data, void *new_data)
+{
+    unsigned long lhs = ((const bench_timer_t *)queue_data)->deadline;
+    unsigned long rhs = ((bench_timer_t *)new_data)->deadline;
+
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+static unsigned long DeadlineKey(const void *queue_data)
+{
+    return ((const bench_timer_t *)queue_data)->deadline;
+}
+
+static void SetHandle(void *queue_data, size_t handle)
+{
+    ((bench_timer_t *)queue_data)->handle = handle;
+}
+
+static long MinorFaults(void)
+{
+    struct rusage usage;
+
+    getrusage(RUSAGE_SELF, &usage);
+
+    return usage.ru_minflt;
+}
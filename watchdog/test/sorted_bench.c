@@ -0,0 +1,204 @@
+/****************************************************
+ *  SORTED LIST BENCHMARK                           *
+ *                                                  *
+ *  Random inserts (each followed by a pop back to  *
+ *  keep n elements), inserts next to the last      *
+ *  element and random finds on a sorted list of n  *
+ *  elements. Then SortedListFromArray and          *
+ *  SortedListInsertArray of n random keys. Built   *
+ *  once per backend (see the bench target of the   *
+ *  Makefile).                                      *
+ *                                                  *
+ ****************************************************/
+
+/*************************** LIBRARY INCLUDES ******************************/
+
+#include <stdio.h> /* printf */
+#include <stdlib.h> /* malloc free rand strtoul */
+#include <time.h> /* clock */
+
+/*************************** HEADER INCLUDES ******************************/
+
+#include "sorted_linked_list.h" /* sorted_list_t API */
+
+/************************** TYPEDEFS & STRUCTS ****************************/
+
+#ifndef SORTED_BACKEND
+    #define SORTED_BACKEND "linked list"
+#endif
+
+#define OPS (1000)
+
+/************************ STATIC FUNCTIONS DECLARATIONS **********************/
+
+static void BenchSize(size_t n);
+static void BenchBulk(size_t n);
+static int KeyCmp(const void *list_data, void *new_data);
+static unsigned long RandomKey(void);
+static double NsPerOp(clock_t start);
+static double Ms(clock_t start);
+
+/************************************ MAIN ***********************************/
+
+int main(int argc, char *argv[])
+{
+    int arg = 1;
+
+    printf("%-12s %10s %10s %14s %14s %14s\n", "backend", "n", "ops", 
+                            "insert ns/op", "at back ns/op", "find ns/op");
+
+    if (1 == argc)
+    {
+        BenchSize(10000);
+        BenchSize(100000);
+        BenchSize(1000000);
+    }
+
+    for (arg = 1; arg < argc; ++arg)
+    {
+        BenchSize(strtoul(argv[arg], NULL, 10));
+    }
+
+    printf("\n%-12s %10s %16s %16s\n", "backend", "n", "from array ms", 
+                                                            "insert array ms");
+
+    if (1 == argc)
+    {
+        BenchBulk(10000);
+        BenchBulk(100000);
+        BenchBulk(1000000);
+    }
+
+    for (arg = 1; arg < argc; ++arg)
+    {
+        BenchBulk(strtoul(argv[arg], NULL, 10));
+    }
+
+    return 0;
+}
+
+/*********************** STATIC FUNCTIONS DEFINITIONS ************************/
+
+static void BenchSize(size_t n)
+{
+    unsigned long *keys = (unsigned long *)malloc((n + OPS) * sizeof(unsigned long));
+    sorted_list_t *list = SortedListCreate(KeyCmp);
+    volatile unsigned long sum = 0;
+    double insert_ns = 0;
+    double back_ns = 0;
+    unsigned long smallest = 0;
+    size_t index = 0;
+    clock_t start = 0;
+
+    if (NULL == keys || NULL == list)
+    {
+        free(keys);
+        return;
+    }
+
+    /* ascending keys always go first, so building costs O(n) on any backend */
+    for (index = 0; index < n; ++index)
+    {
+        keys[index] = index * (RAND_MAX / n);
+        SortedListInsert(list, &keys[index]);
+    }
+
+    srand(42);
+    start = clock();
+    for (index = n; index < n + OPS; ++index)
+    {
+        keys[index] = RandomKey() % (n * (RAND_MAX / n));
+        SortedListInsert(list, &keys[index]);
+        sum += *(unsigned long *)SortedListPopBack(list);
+    }
+    insert_ns = NsPerOp(start);
+
+    /* the last element is the smallest, a smaller key goes right after it */
+    start = clock();
+    for (index = 0; index < OPS; ++index)
+    {
+        smallest = 0;
+        SortedListInsert(list, &smallest);
+        sum += *(unsigned long *)SortedListPopBack(list);
+    }
+    back_ns = NsPerOp(start);
+
+    start = clock();
+    for (index = 0; index < OPS; ++index)
+    {
+        sum += (unsigned long)SortedListGetData(SortedListFind(list,
+                            SortedListBegin(list), SortedListEnd(list), &keys[n + index]));
+    }
+
+    printf("%-12s %10lu %10d %14.1f %14.1f %14.1f\n", SORTED_BACKEND, 
+                (unsigned long)n, OPS, insert_ns, back_ns, NsPerOp(start));
+
+    SortedListDestroy(list);
+    free(keys);
+}
+
+/* n random keys into an empty list, then n more into the n of the first */
+static void BenchBulk(size_t n)
+{
+    unsigned long *keys = (unsigned long *)malloc(2 * n * sizeof(unsigned long));
+    void **data = (void **)malloc(2 * n * sizeof(void *));
+    sorted_list_t *list = NULL;
+    double from_ms = 0;
+    size_t index = 0;
+    clock_t start = 0;
+
+    if (NULL == keys || NULL == data)
+    {
+        free(keys);
+        free(data);
+        return;
+    }
+
+    srand(42);
+    for (index = 0; index < 2 * n; ++index)
+    {
+        keys[index] = RandomKey();
+        data[index] = &keys[index];
+    }
+
+    start = clock();
+    list = SortedListFromArray(KeyCmp, data, n);
+    from_ms = Ms(start);
+
+    if (NULL != list)
+    {
+        start = clock();
+        SortedListInsertArray(list, data + n, n);
+
+        printf("%-12s %10lu %16.1f %16.1f\n", SORTED_BACKEND, (unsigned long)n, 
+                                                                from_ms, Ms(start));
+
+        SortedListDestroy(list);
+    }
+
+    free(keys);
+    free(data);
+}
+
+static int KeyCmp(const void *list_data, void *new_data)
+{
+    unsigned long lhs = *(const unsigned long *)list_data;
+    unsigned long rhs = *(unsigned long *)new_data;
+
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+static unsigned long RandomKey(void)
+{
+    return (unsigned long)rand() * ((unsigned long)RAND_MAX + 1) + rand();
+}
+
+static double NsPerOp(clock_t start)
+{
+    return (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / OPS;
+}
+
+static double Ms(clock_t start)
+{
+    return (double)(clock() - start) * 1e3 / CLOCKS_PER_SEC;
+}
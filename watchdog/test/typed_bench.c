@@ -0,0 +1,188 @@
+/****************************************************
+ *  TYPED CONTAINERS BENCHMARK                      *
+ *                                                  *
+ *  The same workloads on the generic vector_t /    *
+ *  heap_t and on their typed_containers.h          *
+ *  counterparts generated for the element type.    *
+ *                                                  *
+ ****************************************************/
+
+/*************************** LIBRARY INCLUDES ******************************/
+
+#include <stdio.h> /* printf */
+#include <stdlib.h> /* malloc free rand */
+#include <time.h> /* clock */
+
+/*************************** HEADER INCLUDES ******************************/
+
+#include "vector.h" /* vector API */
+#include "heap.h" /* heap API */
+#include "typed_containers.h" /* DEFINE_VECTOR DEFINE_HEAP */
+
+/************************** TYPEDEFS & STRUCTS ****************************/
+
+#define VECTOR_PASSES (20)
+
+#define KEY_LESS(lhs, rhs) ((lhs) < (rhs))
+
+DEFINE_VECTOR(KeyVector, unsigned long);
+DEFINE_HEAP(KeyHeap, unsigned long, KEY_LESS, TYPED_NO_MOVE_HOOK);
+
+/************************ STATIC FUNCTIONS DECLARATIONS **********************/
+
+static void BenchVector(size_t n);
+static void BenchHeap(size_t n, unsigned long *keys);
+static int KeyCmp(const void *heap_data, void *new_data);
+static double NsPerOp(clock_t start, size_t ops);
+
+/************************************ MAIN ***********************************/
+
+int main(void)
+{
+    size_t sizes[] = {1000, 100000, 1000000};
+    unsigned long *keys = NULL;
+    size_t index = 0;
+    size_t key = 0;
+
+    printf("%10s %-8s %14s %14s\n", "n", "bench", "generic ns/op", "typed ns/op");
+
+    for (index = 0; index < sizeof(sizes) / sizeof(sizes[0]); ++index)
+    {
+        keys = (unsigned long *)malloc(sizes[index] * sizeof(unsigned long));
+        if (NULL == keys)
+        {
+            return 1;
+        }
+
+        srand(42);
+        for (key = 0; key < sizes[index]; ++key)
+        {
+            keys[key] = rand();
+        }
+
+        BenchVector(sizes[index]);
+        BenchHeap(sizes[index], keys);
+
+        free(keys);
+    }
+
+    return 0;
+}
+
+/*********************** STATIC FUNCTIONS DEFINITIONS ************************/
+
+/* push n, sum them through the accessor, pop n */
+static void BenchVector(size_t n)
+{
+    vector_t *vector = VectorCreate(1, sizeof(unsigned long));
+    KeyVector_t *typed = KeyVectorCreate(1);
+    volatile unsigned long sum = 0;
+    unsigned long value = 0;
+    double generic_ns = 0;
+    size_t pass = 0;
+    size_t index = 0;
+    clock_t start = 0;
+
+    if (NULL == vector || NULL == typed)
+    {
+        return;
+    }
+
+    start = clock();
+    for (pass = 0; pass < VECTOR_PASSES; ++pass)
+    {
+        for (value = 0; value < n; ++value)
+        {
+            VectorPushBack(vector, &value);
+        }
+        for (index = 0; index < n; ++index)
+        {
+            sum += *(unsigned long *)VectorGetAccessToElement(vector, index);
+        }
+        for (index = 0; index < n; ++index)
+        {
+            VectorPopBack(vector);
+        }
+    }
+    generic_ns = NsPerOp(start, 3 * VECTOR_PASSES * n);
+
+    start = clock();
+    for (pass = 0; pass < VECTOR_PASSES; ++pass)
+    {
+        for (value = 0; value < n; ++value)
+        {
+            KeyVectorPushBack(typed, value);
+        }
+        for (index = 0; index < n; ++index)
+        {
+            sum += *KeyVectorAt(typed, index);
+        }
+        for (index = 0; index < n; ++index)
+        {
+            KeyVectorPopBack(typed);
+        }
+    }
+
+    printf("%10lu %-8s %14.2f %14.2f\n", (unsigned long)n, "vector",
+                        generic_ns, NsPerOp(start, 3 * VECTOR_PASSES * n));
+
+    VectorDestroy(vector);
+    KeyVectorDestroy(typed);
+}
+
+/* push the n keys, pop them all */
+static void BenchHeap(size_t n, unsigned long *keys)
+{
+    heap_t *heap = HeapCreate(KeyCmp);
+    KeyHeap_t *typed = KeyHeapCreate(NULL);
+    volatile unsigned long sum = 0;
+    double generic_ns = 0;
+    size_t index = 0;
+    clock_t start = 0;
+
+    if (NULL == heap || NULL == typed)
+    {
+        return;
+    }
+
+    start = clock();
+    for (index = 0; index < n; ++index)
+    {
+        HeapPush(heap, &keys[index]);
+    }
+    while (!IsHeapEmpty(heap))
+    {
+        sum += *(unsigned long *)HeapPeek(heap);
+        HeapPop(heap);
+    }
+    generic_ns = NsPerOp(start, 2 * n);
+
+    start = clock();
+    for (index = 0; index < n; ++index)
+    {
+        KeyHeapPush(typed, keys[index]);
+    }
+    while (!KeyHeapIsEmpty(typed))
+    {
+        sum += KeyHeapPop(typed);
+    }
+
+    printf("%10lu %-8s %14.2f %14.2f\n", (unsigned long)n, "heap",
+                        generic_ns, NsPerOp(start, 2 * n));
+
+    HeapDestroy(heap);
+    KeyHeapDestroy(typed);
+}
+
+static int KeyCmp(const void *heap_data, void *new_data)
+{
+    unsigned long lhs = *(const unsigned long *)heap_data;
+    unsigned long rhs = *(unsigned long *)new_data;
+
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+static double NsPerOp(clock_t start, size_t ops)
+{
+    return (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / ops;
+}
@@ -0,0 +1,191 @@
+/****************************************************
+ *  UID BENCHMARK                                   *
+ *                                                  *
+ *  UIDCreate against the former per call time() / *
+ *  getpid(), then from 1 to 8 threads at once,     *
+ *  checking that no two packed UIDs are the same,  *
+ *  and that a forked child gets its own pid.       *
+ *                                                  *
+ ****************************************************/
+
+/*************************** LIBRARY INCLUDES ******************************/
+
+#include <stdio.h> /* printf */
+#include <stdlib.h> /* malloc free qsort */
+#include <time.h> /* clock_gettime time */
+#include <unistd.h> /* getpid fork */
+#include <sys/wait.h> /* waitpid */
+
+/*************************** HEADER INCLUDES ******************************/
+
+#include "uid.h" /* UID API */
+#include "parallel.h" /* ParallelRun */
+
+/************************** TYPEDEFS & STRUCTS ****************************/
+
+#define OPS (10000000)
+#define MAX_THREADS (8)
+
+typedef struct creator
+{
+    uid_packed_t *packed;
+    size_t count;
+} creator_t;
+
+/************************ STATIC FUNCTIONS DECLARATIONS **********************/
+
+static ilrd_uid_t SyscallUID(void);
+static void BenchSingle(void);
+static void BenchThreads(size_t threads);
+static void Create(void *creator);
+static void CheckFork(void);
+static int PackedCmp(const void *lhs, const void *rhs);
+static double Seconds(void);
+
+/************************************ MAIN ***********************************/
+
+int main(void)
+{
+    size_t threads = 0;
+
+    BenchSingle();
+
+    printf("\n%8s %12s %12s\n", "threads", "ns/uid", "duplicates");
+    for (threads = 1; threads <= MAX_THREADS; threads *= 2)
+    {
+        BenchThreads(threads);
+    }
+
+    CheckFork();
+
+    return 0;
+}
+
+/*********************** STATIC FUNCTIONS DEFINITIONS ************************/
+
+/* what UIDCreate() did before: two calls into the kernel per UID */
+static ilrd_uid_t SyscallUID(void)
+{
+    static size_t counter = 1;
+    ilrd_uid_t new_uid;
+
+    new_uid.counter = counter++;
+    new_uid.time = time(NULL);
+    new_uid.pid = getpid();
+
+    return new_uid;
+}
+
+static void BenchSingle(void)
+{
+    volatile size_t sum = 0;
+    ilrd_uid_t uid = GetBadUID();
+    size_t index = 0;
+    double start = 0;
+
+    printf("%-24s %12s\n", "single thread", "ns/op");
+
+    start = Seconds();
+    for (index = 0; index < OPS; ++index)
+    {
+        sum += SyscallUID().counter;
+    }
+    printf("%-24s %12.2f\n", "time() + getpid()", (Seconds() - start) * 1e9 / OPS);
+
+    start = Seconds();
+    for (index = 0; index < OPS; ++index)
+    {
+        sum += UIDCreate().counter;
+    }
+    printf("%-24s %12.2f\n", "UIDCreate", (Seconds() - start) * 1e9 / OPS);
+
+    uid = UIDCreate();
+    start = Seconds();
+    for (index = 0; index < OPS; ++index)
+    {
+        uid.counter = index;
+        sum += UIDHash(uid);
+    }
+    printf("%-24s %12.2f\n", "UIDHash", (Seconds() - start) * 1e9 / OPS);
+}
+
+/* OPS UIDs in all, split between the threads */
+static void BenchThreads(size_t threads)
+{
+    uid_packed_t *packed = (uid_packed_t *)malloc(OPS * sizeof(uid_packed_t));
+    creator_t creators[MAX_THREADS];
+    size_t duplicates = 0;
+    size_t index = 0;
+    double seconds = 0;
+
+    if (NULL == packed)
+    {
+        return;
+    }
+
+    for (index = 0; index < threads; ++index)
+    {
+        creators[index].packed = packed + OPS / threads * index;
+        creators[index].count = OPS / threads;
+    }
+
+    seconds = Seconds();
+    ParallelRun(Create, creators, sizeof(creator_t), threads);
+    seconds = Seconds() - seconds;
+
+    qsort(packed, OPS / threads * threads, sizeof(uid_packed_t), PackedCmp);
+    for (index = 1; index < OPS / threads * threads; ++index)
+    {
+        duplicates += packed[index - 1] == packed[index];
+    }
+
+    printf("%8lu %12.2f %12lu\n", (unsigned long)threads, seconds * 1e9 / OPS, 
+                                                        (unsigned long)duplicates);
+
+    free(packed);
+}
+
+static void Create(void *creator)
+{
+    creator_t *uids = (creator_t *)creator;
+    size_t index = 0;
+
+    for (index = 0; index < uids->count; ++index)
+    {
+        uids->packed[index] = UIDPack(UIDCreate());
+    }
+}
+
+static void CheckFork(void)
+{
+    ilrd_uid_t parent = UIDCreate();
+    int status = 0;
+    pid_t child = fork();
+
+    if (0 == child)
+    {
+        _exit(UIDCreate().pid == getpid() && !IsSameUID(parent, UIDCreate()) ? 0 : 1);
+    }
+
+    waitpid(child, &status, 0);
+    printf("\nforked child UIDs carry its pid: %s\n", 
+            WIFEXITED(status) && 0 == WEXITSTATUS(status) ? "yes" : "NO");
+}
+
+static int PackedCmp(const void *lhs, const void *rhs)
+{
+    uid_packed_t left = *(const uid_packed_t *)lhs;
+    uid_packed_t right = *(const uid_packed_t *)rhs;
+
+    return (left > right) - (left < right);
+}
+
+/* wall time, clock() would add up the threads */
+static double Seconds(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
@@ -0,0 +1,123 @@
+/****************************************************
+ *  UID MAP BENCHMARK                               *
+ *                                                  *
+ *  n inserts into a map created empty, so it grows *
+ *  all the way, with the slowest single insert.    *
+ *  Then finds of present and of missing UIDs, and  *
+ *  removes.                                        *
+ *                                                  *
+ ****************************************************/
+
+/*************************** LIBRARY INCLUDES ******************************/
+
+#include <stdio.h> /* printf */
+#include <stdlib.h> /* malloc free strtoul */
+#include <time.h> /* clock_gettime */
+
+/*************************** HEADER INCLUDES ******************************/
+
+#include "uid_map.h" /* uid_map_t API */
+
+/************************ STATIC FUNCTIONS DECLARATIONS **********************/
+
+static void BenchSize(size_t n);
+static double Now(void);
+
+/************************************ MAIN ***********************************/
+
+int main(int argc, char *argv[])
+{
+    int arg = 1;
+
+    printf("%10s %12s %14s %12s %12s %12s\n", "n", "insert ns", "worst insert", 
+                                            "hit ns", "miss ns", "remove ns");
+
+    if (1 == argc)
+    {
+        BenchSize(1000);
+        BenchSize(100000);
+        BenchSize(1000000);
+        BenchSize(10000000);
+    }
+
+    for (arg = 1; arg < argc; ++arg)
+    {
+        BenchSize(strtoul(argv[arg], NULL, 10));
+    }
+
+    return 0;
+}
+
+/*********************** STATIC FUNCTIONS DEFINITIONS ************************/
+
+static void BenchSize(size_t n)
+{
+    ilrd_uid_t *uids = (ilrd_uid_t *)malloc(2 * n * sizeof(ilrd_uid_t));
+    uid_map_t *map = UIDMapCreate(0);
+    volatile size_t found = 0;
+    double insert_ns = 0;
+    double worst_ns = 0;
+    double hit_ns = 0;
+    double miss_ns = 0;
+    double start = 0;
+    double one = 0;
+    size_t index = 0;
+
+    if (NULL == uids || NULL == map)
+    {
+        free(uids);
+        return;
+    }
+
+    /* the second half is never inserted, for the misses */
+    for (index = 0; index < 2 * n; ++index)
+    {
+        uids[index] = UIDCreate();
+    }
+
+    start = Now();
+    for (index = 0; index < n; ++index)
+    {
+        one = Now();
+        UIDMapInsert(map, uids[index], &uids[index]);
+        one = Now() - one;
+        worst_ns = one > worst_ns ? one : worst_ns;
+    }
+    insert_ns = (Now() - start) / n;
+
+    start = Now();
+    for (index = 0; index < n; ++index)
+    {
+        found += NULL != UIDMapFind(map, uids[index]);
+    }
+    hit_ns = (Now() - start) / n;
+
+    start = Now();
+    for (index = n; index < 2 * n; ++index)
+    {
+        found += NULL != UIDMapFind(map, uids[index]);
+    }
+    miss_ns = (Now() - start) / n;
+
+    start = Now();
+    for (index = 0; index < n; ++index)
+    {
+        found += NULL != UIDMapRemove(map, uids[index]);
+    }
+
+    printf("%10lu %12.1f %14.0f %12.1f %12.1f %12.1f\n", (unsigned long)n, insert_ns, 
+                                worst_ns, hit_ns, miss_ns, (Now() - start) / n);
+
+    UIDMapDestroy(map);
+    free(uids);
+}
+
+/* in ns, the timer around a single insert costs some 20 ns of its own */
+static double Now(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec * 1e9 + now.tv_nsec;
+}
@@ -0,0 +1,213 @@
+/****************************************************
+ *  UNROLLED LIST BENCHMARK                         *
+ *                                                  *
+ *  DLLForEachElement / DLLFind over a whole list   *
+ *  against their unrolled list counterparts. The   *
+ *  dll nodes are shuffled first, as after a while  *
+ *  of inserts and removes. Built once per node     *
+ *  size (see the bench target of the Makefile).    *
+ *                                                  *
+ ****************************************************/
+
+/*************************** LIBRARY INCLUDES ******************************/
+
+#include <stdio.h> /* printf */
+#include <stdlib.h> /* malloc free rand */
+#include <time.h> /* clock */
+
+/*************************** HEADER INCLUDES ******************************/
+
+#include "d_linked_list.h" /* dll_t API */
+#include "unrolled_list.h" /* ulist_t API */
+
+/************************** TYPEDEFS & STRUCTS ****************************/
+
+#define VISITS (20000000)
+
+/************************ STATIC FUNCTIONS DECLARATIONS **********************/
+
+static void BenchSize(size_t n);
+static dll_t *ShuffledDLL(dll_t *dll, size_t *keys, size_t n);
+static void BenchDLL(dll_t *dll, size_t n, double *for_each_ns, double *find_ns);
+static void BenchUList(ulist_t *list, size_t n, double *for_each_ns, double *find_ns);
+static int AddKey(void *list_data, void *sum);
+static int IsKey(const void *list_data, void *key);
+static double NsPerVisit(clock_t start, size_t n);
+
+/************************************ MAIN ***********************************/
+
+int main(void)
+{
+    size_t sizes[] = {10000, 100000, 1000000};
+    size_t index = 0;
+
+    printf("%-10s %8s %-10s %12s %12s %12s %9s\n", "slots", "n", "op", 
+                    "dll ns", "pooled ns", "unrolled ns", "speedup");
+
+    for (index = 0; index < sizeof(sizes) / sizeof(sizes[0]); ++index)
+    {
+        BenchSize(sizes[index]);
+    }
+
+    return 0;
+}
+
+/*********************** STATIC FUNCTIONS DEFINITIONS ************************/
+
+static void BenchSize(size_t n)
+{
+    size_t *keys = (size_t *)malloc(n * sizeof(size_t));
+    dll_t *dll = NULL;
+    dll_t *pooled = NULL;
+    ulist_t *list = UListCreate();
+    double ns[3][2];
+    size_t index = 0;
+
+    if (NULL == keys || NULL == list)
+    {
+        free(keys);
+        return;
+    }
+
+    srand(42);
+    dll = ShuffledDLL(DLLCreate(), keys, n);
+    pooled = ShuffledDLL(DLLCreatePooled(), keys, n);
+    for (index = 0; index < n; ++index)
+    {
+        UListPushBack(list, &keys[index]);
+    }
+
+    if (NULL != dll && NULL != pooled)
+    {
+        BenchDLL(dll, n, &ns[0][0], &ns[0][1]);
+        BenchDLL(pooled, n, &ns[1][0], &ns[1][1]);
+        BenchUList(list, n, &ns[2][0], &ns[2][1]);
+
+        printf("%-10d %8lu %-10s %12.2f %12.2f %12.2f %8.1fx\n", ULIST_NODE_SLOTS, 
+                    (unsigned long)n, "for each", ns[0][0], ns[1][0], ns[2][0], 
+                    ns[0][0] / ns[2][0]);
+        printf("%-10d %8lu %-10s %12.2f %12.2f %12.2f %8.1fx\n", ULIST_NODE_SLOTS, 
+                    (unsigned long)n, "find", ns[0][1], ns[1][1], ns[2][1], 
+                    ns[0][1] / ns[2][1]);
+    }
+
+    if (NULL != dll)
+    {
+        DLLDestroy(dll);
+    }
+    if (NULL != pooled)
+    {
+        DLLDestroy(pooled);
+    }
+    UListDestroy(list);
+    free(keys);
+}
+
+/*
+    Moves the nodes to the front in random order, so walking the list jumps
+    around memory. Then the keys are stored in list order, so reading them
+    does not.
+*/
+static dll_t *ShuffledDLL(dll_t *dll, size_t *keys, size_t n)
+{
+    dll_iterator_t *nodes = (dll_iterator_t *)malloc(n * sizeof(dll_iterator_t));
+    dll_iterator_t runner = NULL;
+    size_t index = 0;
+    size_t other = 0;
+
+    if (NULL == dll || NULL == nodes)
+    {
+        free(nodes);
+        return dll;
+    }
+
+    for (index = 0; index < n; ++index)
+    {
+        nodes[index] = DLLPushBack(dll, NULL);
+    }
+
+    for (index = 0; index < n; ++index)
+    {
+        other = index + (size_t)rand() % (n - index);
+        runner = nodes[other];
+        nodes[other] = nodes[index];
+        DLLSplice(dll, DLLBegin(dll), dll, runner, DLLNext(runner));
+    }
+
+    for (runner = DLLBegin(dll), index = 0; index < n; runner = DLLNext(runner), ++index)
+    {
+        keys[index] = index;
+        DLLSetData(runner, &keys[index]);
+    }
+
+    free(nodes);
+
+    return dll;
+}
+
+static void BenchDLL(dll_t *dll, size_t n, double *for_each_ns, double *find_ns)
+{
+    volatile size_t sink = 0;
+    size_t sum = 0;
+    size_t missing = n;
+    size_t pass = 0;
+    clock_t start = 0;
+
+    start = clock();
+    for (pass = 0; pass < VISITS / n; ++pass)
+    {
+        DLLForEachElement(DLLBegin(dll), DLLEnd(dll), &sum, AddKey);
+    }
+    *for_each_ns = NsPerVisit(start, n);
+    sink = sum;
+
+    start = clock();
+    for (pass = 0; pass < VISITS / n; ++pass)
+    {
+        sink += (size_t)DLLFind(DLLBegin(dll), DLLEnd(dll), &missing, IsKey);
+    }
+    *find_ns = NsPerVisit(start, n);
+    (void)sink;
+}
+
+static void BenchUList(ulist_t *list, size_t n, double *for_each_ns, double *find_ns)
+{
+    volatile size_t sink = 0;
+    size_t sum = 0;
+    size_t missing = n;
+    size_t pass = 0;
+    clock_t start = 0;
+
+    start = clock();
+    for (pass = 0; pass < VISITS / n; ++pass)
+    {
+        UListForEachElement(UListBegin(list), UListEnd(list), &sum, AddKey);
+    }
+    *for_each_ns = NsPerVisit(start, n);
+    sink = sum;
+
+    start = clock();
+    for (pass = 0; pass < VISITS / n; ++pass)
+    {
+        sink += UListFind(UListBegin(list), UListEnd(list), &missing, IsKey).index;
+    }
+    *find_ns = NsPerVisit(start, n);
+    (void)sink;
+}
+
+static int AddKey(void *list_data, void *sum)
+{
+    *(size_t *)sum += *(size_t *)list_data;
+
+    return 0;
+}
+
+static int IsKey(const void *list_data, void *key)
+{
+    return *(const size_t *)list_data == *(size_t *)key;
+}
+
+static double NsPerVisit(clock_t start, size_t n)
+{
+    return (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / (VISITS / n * n);
+}
@@ -0,0 +1,175 @@
+/****************************************************
+ *  VECTOR BENCHMARK                                *
+ *                                                  *
+ *  Alternating push / pop on a vector filled to a  *
+ *  power of two, for each shrink policy. Then      *
+ *  element access and bulk push against their      *
+ *  per element counterparts.                       *
+ *                                                  *
+ ****************************************************/
+
+/*************************** LIBRARY INCLUDES ******************************/
+
+#include <stdio.h> /* printf */
+#include <stdlib.h> /* malloc free */
+#include <time.h> /* clock */
+
+/*************************** HEADER INCLUDES ******************************/
+
+#include "vector.h" /* vector API */
+
+/************************** TYPEDEFS & STRUCTS ****************************/
+
+#define PAIRS (1000000)
+#define RANGE_SIZE (1000000)
+#define RANGE_PASSES (20)
+
+/************************ STATIC FUNCTIONS DECLARATIONS **********************/
+
+static void BenchBoundary(size_t boundary, vector_shrink_t policy, const char *name);
+static void BenchRange(void);
+static double NsPerElement(clock_t start);
+
+/************************************ MAIN ***********************************/
+
+int main(void)
+{
+    size_t boundaries[] = {1024, 65536, 1048576};
+    size_t index = 0;
+
+    printf("%10s %-10s %12s %12s\n", "size", "shrink at", "reallocs", "ns/pair");
+
+    for (index = 0; index < sizeof(boundaries) / sizeof(boundaries[0]); ++index)
+    {
+        BenchBoundary(boundaries[index], VECTOR_SHRINK_AT_HALF, "half");
+        BenchBoundary(boundaries[index], VECTOR_SHRINK_AT_QUARTER, "quarter");
+        BenchBoundary(boundaries[index], VECTOR_SHRINK_NEVER, "never");
+    }
+
+    BenchRange();
+
+    return 0;
+}
+
+/*********************** STATIC FUNCTIONS DEFINITIONS ************************/
+
+static void BenchBoundary(size_t boundary, vector_shrink_t policy, const char *name)
+{
+    vector_t *vector = VectorCreate(1, sizeof(size_t));
+    size_t reallocs = 0;
+    size_t capacity = 0;
+    size_t index = 0;
+    clock_t start = 0;
+
+    if (NULL == vector)
+    {
+        return;
+    }
+
+    VectorSetPolicy(vector, VECTOR_GROW_DOUBLE, policy);
+
+    for (index = 0; index < boundary; ++index)
+    {
+        VectorPushBack(vector, &index);
+    }
+
+    start = clock();
+    capacity = VectorCapacity(vector);
+    for (index = 0; index < PAIRS; ++index)
+    {
+        VectorPushBack(vector, &index);
+        reallocs += capacity != VectorCapacity(vector);
+        capacity = VectorCapacity(vector);
+
+        VectorPopBack(vector);
+        reallocs += capacity != VectorCapacity(vector);
+        capacity = VectorCapacity(vector);
+    }
+
+    printf("%10lu %-10s %12lu %12.1f\n", (unsigned long)boundary, name,
+                (unsigned long)reallocs,
+                (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / PAIRS);
+
+    VectorDestroy(vector);
+}
+
+static void BenchRange(void)
+{
+    vector_t *vector = VectorCreate(1, sizeof(size_t));
+    size_t *values = (size_t *)malloc(RANGE_SIZE * sizeof(size_t));
+    volatile size_t sum = 0;
+    size_t *curr = NULL;
+    size_t *end = NULL;
+    size_t pass = 0;
+    size_t index = 0;
+    clock_t start = 0;
+
+    if (NULL == vector || NULL == values)
+    {
+        free(values);
+        return;
+    }
+
+    for (index = 0; index < RANGE_SIZE; ++index)
+    {
+        values[index] = index;
+    }
+
+    printf("\n%-28s %12s\n", "n = 1000000", "ns/element");
+
+    start = clock();
+    for (pass = 0; pass < RANGE_PASSES; ++pass)
+    {
+        for (index = 0; index < RANGE_SIZE; ++index)
+        {
+            VectorPushBack(vector, &values[index]);
+        }
+        while (0 < VectorSize(vector))
+        {
+            VectorPopBack(vector);
+        }
+    }
+    printf("%-28s %12.2f\n", "VectorPushBack loop", NsPerElement(start));
+
+    start = clock();
+    for (pass = 0; pass < RANGE_PASSES; ++pass)
+    {
+        VectorPushBackN(vector, values, RANGE_SIZE);
+        while (0 < VectorSize(vector))
+        {
+            VectorPopBack(vector);
+        }
+    }
+    printf("%-28s %12.2f\n", "VectorPushBackN", NsPerElement(start));
+
+    VectorPushBackN(vector, values, RANGE_SIZE);
+
+    start = clock();
+    for (pass = 0; pass < RANGE_PASSES; ++pass)
+    {
+        for (index = 0; index < RANGE_SIZE; ++index)
+        {
+            sum += *(size_t *)VectorGetAccessToElement(vector, index);
+        }
+    }
+    printf("%-28s %12.2f\n", "VectorGetAccessToElement", NsPerElement(start));
+
+    start = clock();
+    for (pass = 0; pass < RANGE_PASSES; ++pass)
+    {
+        end = (size_t *)VectorEnd(vector);
+        for (curr = (size_t *)VectorBegin(vector); curr != end; ++curr)
+        {
+            sum += *curr;
+        }
+    }
+    printf("%-28s %12.2f\n", "VectorBegin / VectorEnd", NsPerElement(start));
+
+    VectorDestroy(vector);
+    free(values);
+}
+
+static double NsPerElement(clock_t start)
+{
+    return (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / RANGE_PASSES / RANGE_SIZE;
+}